@@ -0,0 +1,26 @@
+#ifndef BACKGROUND_H
+#define BACKGROUND_H
+
+#include <glad/glad.h>
+
+#include "GLRender/CommandList.h"
+#include "GLRender/ShaderRegistry.h"
+#include "GLRender/TextureManager.h"
+
+// Bildschirmfüllendes Hintergrund-Quad mit Textur
+class Background
+{
+public:
+    Background();
+    ~Background();
+
+    // Zeichnet das Quad in die Command-List auf (auf der Far-Plane, nach der Szene zu zeichnen)
+    void record(CommandList &commands) const;
+
+private:
+    unsigned int quadVAO, quadVBO;
+    TextureHandle texture;  // Platzhalterfarbe, bis die Textur geladen ist
+    ShaderHandle shader;
+};
+
+#endif
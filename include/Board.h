@@ -8,15 +8,33 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include "GLRender/CommandList.h"
+#include "GLRender/MeshLibrary.h"
+#include "GLRender/ShaderRegistry.h"
+#include "GLRender/TextureManager.h"
+#include "GLRender/VertexFormat.h"
+#include "SceneGraph.h"
+
 class Board
 {
 private:
-    unsigned int VAO, VBO, EBO, texture;
+    unsigned int VAO, VBO, EBO;
+    TextureHandle texture;  // geteilt mit allen anderen Brettern, gehört dem TextureManager
+    VertexQuantization quantization;  // Rückrechnung der 16-Bit-Positionen des Quads
+    MeshBounds bounds;                 // Box und Kugel um das Quad (Objektraum)
+    ShaderHandle shader;
     unsigned int shaderID; 
-    glm::mat4 modelMatrix;  // Speichert Transformationen (Rotation)
+    int modelLoc, useTextureLoc;  // Uniform-Locations, einmalig abgefragt
+    glm::mat4 modelMatrix;  // Speichert Transformationen (Rotation), Stand des letzten Simulationsschritts
+    glm::mat4 previousMatrix;  // Stand des vorletzten Schritts
+    glm::mat4 displayMatrix;   // dazwischen interpoliert, wird gezeichnet und an den Szenengraph gegeben
+    float spinX, spinY;        // Drehgeschwindigkeit in Grad pro Sekunde
+    float tickX, tickY;        // im letzten Schritt gedrehte Winkel
+    void setDisplayMatrix(const glm::mat4 &matrix);
+    SceneGraph* scene;          // Szenengraph, in dem das Board als Wurzelknoten hängt (optional)
+    SceneGraph::NodeId node;
     void setupBoard();  // Spielfeld-Setup
-    void loadTexture(const char* path);  // Textur laden
-    unsigned int compileShader(const std::string& vertexShaderPath, const std::string& fragmentShaderPath);
+    void loadTexture(const char* path);  // Textur beim TextureManager anfordern, bis zum Laden Platzhalterfarbe
 
 public:
     Board();
@@ -26,14 +44,32 @@ public:
     void initGL();  // OpenGL Initialisierung
     void uninitGL(); // OpenGL Ressourcen freigeben
 
-    void render();  // Spielfeld rendern
+    void render();  // Spielfeld sofort rendern
+    // Draw-Item des Spielfelds aufzeichnen (view nur für die Tiefensortierung); die Liste
+    // hängt danach nicht mehr vom Brett ab und kann auf einem anderen Thread abgespielt werden
+    void record(CommandList &commands, const glm::mat4 &view);
     
 
+    // Sofort drehen (ohne Interpolation)
     void rotX(float angle);
     void rotY(float angle);
+    // Drehgeschwindigkeit um X- und Y-Achse in Grad pro Sekunde, wirkt in update()
+    void setSpin(float degreesX, float degreesY);
+    // Simulationsschritt mit fester Länge dt (Sekunden)
+    void update(float dt);
+    // Darstellung zwischen vorletztem (alpha = 0) und letztem Schritt (alpha = 1)
+    void interpolate(float alpha);
+    // Verschiebt das Brett (z. B. mehrere Bretter nebeneinander im Benchmark)
+    void translate(const glm::vec3 &offset);
 
     void keyPressed(int key);
-    glm::mat4 getModelMatrix() const;
+    glm::mat4 getModelMatrix() const;  // Stand des letzten Simulationsschritts
+    // Bounding-Sphere der gezeichneten Lage in Weltkoordinaten (xyz = Mittelpunkt, w = Radius) für das Culling
+    glm::vec4 getWorldBounds() const;
+
+    // Hängt das Board als Knoten in den Szenengraph; Figuren werden dessen Kinder
+    void attachToScene(SceneGraph* sceneGraph);
+    SceneGraph::NodeId getNode() const { return node; }
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,44 @@
+#ifndef BOARDLAYOUT_H
+#define BOARDLAYOUT_H
+
+#include <glm/glm.hpp>
+
+// Lage der Felder auf dem Brett in Brettkoordinaten (Quad von -0.5 bis 0.5 in der xy-Ebene):
+// die 40 Felder der Laufbahn auf einem 11x11-Raster in Kreuzform, dazu je Spieler vier
+// Felder im Haus (Ecken) und vier Zielfelder (Mittelachsen). Felder werden durchgehend
+// nummeriert: erst die Bahn, dann die Häuser, dann die Zielfelder.
+//
+// Spieler in der Reihenfolge der Farben der Szene: rot, grün, gelb, blau.
+class BoardLayout
+{
+public:
+    enum FieldType
+    {
+        TRACK,
+        HOME,
+        GOAL
+    };
+
+    static const int NUM_PLAYERS = 4;
+    static const int NUM_TRACK_FIELDS = 40;
+    static const int FIELDS_PER_PLAYER = 4;  // Haus- bzw. Zielfelder je Spieler
+    static const int NUM_FIELDS = NUM_TRACK_FIELDS + 2 * NUM_PLAYERS * FIELDS_PER_PLAYER;
+
+    static const float FIELD_SPACING;  // Abstand benachbarter Rasterfelder
+    static const float FIELD_RADIUS;   // Radius eines Feldes
+
+    static int trackField(int index) { return ((index % NUM_TRACK_FIELDS) + NUM_TRACK_FIELDS) % NUM_TRACK_FIELDS; }
+    static int homeField(int player, int index) { return NUM_TRACK_FIELDS + player * FIELDS_PER_PLAYER + index; }
+    static int goalField(int player, int index) { return NUM_TRACK_FIELDS + (NUM_PLAYERS + player) * FIELDS_PER_PLAYER + index; }
+
+    static FieldType getType(int field);
+    // Spieler eines Haus- oder Zielfeldes, -1 für Felder der Bahn
+    static int getPlayer(int field);
+
+    // Mittelpunkt des Feldes auf der Brettoberfläche (z = 0)
+    static glm::vec3 getPosition(int field);
+    // Bahnfeld, auf das ein Spieler aus dem Haus zieht
+    static int getStartField(int player);
+};
+
+#endif
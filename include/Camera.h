@@ -0,0 +1,76 @@
+#ifndef CAMERA_H
+#define CAMERA_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <cstddef>
+
+#include "GLRender/CommandList.h"
+
+// Kamera der Szene: berechnet View- und Projektionsmatrix nur, wenn sich Parameter ändern,
+// und stellt sie allen Shadern über einen std140-Uniform-Block "Camera" bereit. Bis auf
+// Konstruktor und Destruktor ruft sie kein GL auf, der Upload wird in eine Command-List
+// aufgezeichnet (Hauptthread), abgespielt wird er auf dem Render-Thread.
+class Camera
+{
+public:
+    // Binding-Point des Uniform-Blocks "Camera"
+    static const unsigned int BINDING = 0;
+
+    Camera();
+    ~Camera();
+
+    // Seitenverhältnis an die Größe des Viewports anpassen (z. B. nach einem Resize)
+    void setViewport(int width, int height);
+    // Öffnungswinkel (in Grad) sowie Near- und Far-Plane setzen
+    void setPerspective(float fovYDegrees, float nearPlane, float farPlane);
+    // Kamera-Position, Blickpunkt und Up-Vektor setzen
+    void lookAt(const glm::vec3 &eye, const glm::vec3 &center, const glm::vec3 &up);
+
+    // Einmal pro Frame aufrufen: rechnet die Matrizen nur bei Änderungen neu und zeichnet
+    // dann ihren Upload in die Command-List auf
+    void update(CommandList &commands);
+
+    // Strahl durch den Pixel (x, y) des Viewports (Ursprung links oben, wie die Mauskoordinaten)
+    // in Weltkoordinaten: origin auf der Near-Plane, direction normiert; benutzt die Matrizen
+    // des zuletzt aufgezeichneten Frames, also das, was gerade zu sehen ist
+    void getRay(float x, float y, glm::vec3 &origin, glm::vec3 &direction) const;
+
+    // Verbindet den Block "Camera" eines Programms mit dem Binding-Point (einmal nach dem Linken)
+    static void bindProgram(unsigned int programID);
+
+    const glm::mat4 &getView() const { return view; }
+    const glm::mat4 &getProjection() const { return projection; }
+    const glm::mat4 &getViewProjection() const { return viewProjection; }
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    // Wird bei jeder Änderung der Matrizen erhöht
+    unsigned int getVersion() const { return version; }
+    // Summe aller Uploads in den Uniform-Buffer in Bytes (für Benchmarks)
+    size_t getUploadedBytes() const { return uploadedBytes; }
+
+private:
+    // Layout des Uniform-Blocks (std140, muss zu den Shadern passen)
+    struct CameraBlock
+    {
+        glm::mat4 view;
+        glm::mat4 projection;
+        glm::mat4 viewProjection;
+    };
+
+    unsigned int ubo;
+
+    int width, height;
+    float fovY, nearPlane, farPlane;
+    glm::vec3 eye, center, up;
+
+    glm::mat4 view;
+    glm::mat4 projection;
+    glm::mat4 viewProjection;
+
+    bool dirty;
+    unsigned int version;
+    size_t uploadedBytes;
+};
+
+#endif
@@ -5,6 +5,11 @@
 #include <glm/glm.hpp>
 #include <string>
 
+#include "GLRender/MeshLibrary.h"
+#include "GLRender/CommandList.h"
+#include "GLRender/ShaderRegistry.h"
+#include "SceneGraph.h"
+
 class Figur
 {
 public:
@@ -22,33 +27,40 @@ public:
     void setColor(const glm::vec3 &color);
     glm::vec3 getColor() const;
 
-    // Rendert die Figur (zuerst Zylinder, dann Kugel)
-    // Die finale Modellmatrix wird in main() berechnet als: boardModel * localTransform.
+    // Hängt die Figur als Kind des Knotens parent in den Szenengraph; die finale
+    // Modellmatrix (boardModel * localTransform) berechnet dann der Szenengraph
+    void attachToScene(SceneGraph* sceneGraph, SceneGraph::NodeId parent);
+    SceneGraph::NodeId getNode() const { return node; }
+
+    // Rendert die Figur sofort (zuerst Zylinder, dann Kugel)
+    // Ohne Szenengraph wird die finale Modellmatrix von außen gesetzt: boardModel * localTransform.
     void render();
+    // Zeichnet Zylinder und Kugel in die Command-List auf (view nur für die Tiefensortierung)
+    void record(CommandList &commands, const glm::mat4 &view);
+
+    // Generierungsparameter von Körper und Kopf (Schlüssel in der MeshLibrary),
+    // damit auch der PieceRenderer dieselben Meshes nutzen kann
+    static MeshDesc cylinderDesc();
+    static MeshDesc sphereDesc();
 
 private:
-    // Shaderprogramm-ID für die Figur (hier wird derselbe Shader genutzt wie beim Board)
+    // Shaderprogramm für die Figur (hier wird derselbe Shader genutzt wie beim Board)
+    ShaderHandle shader;
     unsigned int shaderID;
+    int modelLoc, useTextureLoc, colorLoc;  // Uniform-Locations, einmalig abgefragt
     // Modellmatrix zur Transformation der Figur
     glm::mat4 modelMatrix;     // Final (global) Modellmatrix der Figur (Board * local)
     glm::mat4 localTransform;  // Lokaler Transform relativ zum Brett
     glm::vec3 objectColor;     // Farbe der Figur
+    SceneGraph* scene;         // Szenengraph (optional)
+    SceneGraph::NodeId node;   // Knoten der Figur im Szenengraph
 
-    // --- Zylinder (Körper) ---
-    unsigned int cylinderVAO, cylinderVBO, cylinderEBO;
-    unsigned int cylinderIndexCount;
+    // --- Zylinder (Körper) und Kugel (Kopf), geteilt über die MeshLibrary ---
+    MeshHandle cylinder;
+    MeshHandle sphere;
 
-    // --- Kugel (Kopf) ---
-    unsigned int sphereVAO, sphereVBO, sphereEBO;
-    unsigned int sphereIndexCount;
-
-    // Hilfsfunktionen zum Aufbau der Geometrie
+    // Hilfsfunktion zum Aufbau der Geometrie
     void setupFigur();
-    void setupCylinder();
-    void setupSphere();
-
-    // Funktion zum Kompilieren und Linken eines Shaderprogramms
-    unsigned int compileShader(const std::string &vertexPath, const std::string &fragmentPath);
 };
 
 #endif 
\ No newline at end of file
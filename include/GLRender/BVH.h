@@ -0,0 +1,155 @@
+#ifndef BVH_H
+#define BVH_H
+
+
+#include "GLRender/GLRenderDecl.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+
+// bounding volume hierarchy over axis aligned boxes for ray queries on the CPU (picking),
+// without touching the GPU
+//
+// The tree is built once (median split along the longest axis of the box centres); when
+// primitives move, setBox stores their new box and refit() updates only the nodes above
+// them. Refitting keeps the topology, so after large rearrangements a rebuild gives
+// tighter nodes.
+class GLRENDER_DECL BVH
+{
+public:
+  struct Box
+  {
+    float afMin[3];
+    float afMax[3];
+  };
+
+  // ray origin + t * dir; the inverse direction is precomputed for the slab tests
+  struct Ray
+  {
+    float afOrigin[3];
+    float afDir[3];
+    float afInvDir[3];
+
+    Ray() {}
+    Ray( const float* pfOrigin, const float* pfDir );
+  };
+
+  static const uint32_t MAX_LEAF_SIZE = 4;
+
+  BVH();
+
+  // build the tree over all boxes; primitive i is rcBoxes[i]
+  void build( const std::vector<Box>& rcBoxes );
+  void clear();
+
+  // new box of a moved primitive, the nodes above it are updated in refit()
+  void setBox( uint32_t uiPrimitive, const Box& rcBox );
+  const Box& getBox( uint32_t uiPrimitive ) const { return m_cBoxes[uiPrimitive]; }
+  // update the boxes of all nodes above changed primitives; returns the number of nodes visited
+  size_t refit();
+
+  // closest hit along the ray up to rfT: fnIntersect( primitive, closest ) is called for
+  // each primitive whose box the ray enters before the closest hit so far and returns the
+  // exact hit distance (negative for a miss); returns the primitive hit or -1, rfT is set
+  // to its distance
+  template<class Intersect>
+  int32_t intersect( const Ray& rcRay, float& rfT, Intersect fnIntersect ) const;
+
+  // slab test; rfEntry is where the ray enters the box (0 if it starts inside)
+  static bool intersectBox( const Ray& rcRay, const float* pfMin, const float* pfMax, float fMaxT, float& rfEntry );
+
+  size_t   getNumPrimitives() const { return m_cBoxes.size(); }
+  size_t   getNumNodes() const { return m_cNodes.size(); }
+  uint32_t getDepth() const { return m_uiDepth; }
+
+
+protected:
+  struct Node
+  {
+    float     afMin[3];
+    uint32_t  uiFirst;    // leaf: first entry in m_cIndices, inner node: left child (right = left + 1)
+    float     afMax[3];
+    uint32_t  uiCount;    // primitives of a leaf, 0 for inner nodes
+  };
+
+  void buildNode( uint32_t uiNode, uint32_t uiFirst, uint32_t uiCount, uint32_t uiDepth, const std::vector<float>& rcCentres );
+  void fitLeaf( uint32_t uiNode );
+  void fitInner( uint32_t uiNode );
+
+  std::vector<Box>            m_cBoxes;     // per primitive
+  std::vector<Node>           m_cNodes;     // root is node 0
+  std::vector<uint32_t>       m_cIndices;   // primitives in leaf order
+  std::vector<uint32_t>       m_cParents;   // per node, ~0u for the root
+  std::vector<uint32_t>       m_cLeaves;    // per primitive, the leaf holding it
+  std::vector<uint32_t>       m_cDirty;     // leaves with changed primitives
+  std::vector<unsigned char>  m_cLeafDirty; // per node, leaf is in m_cDirty
+  uint32_t                    m_uiDepth;
+};
+
+
+
+template<class Intersect>
+int32_t
+BVH::intersect( const Ray& rcRay, float& rfT, Intersect fnIntersect ) const
+{
+  int32_t iHit = -1;
+  float   fEntry;
+  if( m_cNodes.empty() || !intersectBox( rcRay, m_cNodes[0].afMin, m_cNodes[0].afMax, rfT, fEntry ) ) return -1;
+
+  // nodes still to visit with their entry distance; the depth is bounded by log2 of the
+  // number of primitives, the stack holds at most one node per level plus one
+  struct Entry { uint32_t uiNode; float fEntry; };
+  Entry    acStack[66];
+  uint32_t uiStackSize = 0;
+  acStack[uiStackSize++] = { 0, fEntry };
+
+  while( uiStackSize )
+  {
+    const Entry cEntry = acStack[--uiStackSize];
+    if( cEntry.fEntry > rfT ) continue;   // a closer hit was found after the node was pushed
+
+    const Node& rcNode = m_cNodes[cEntry.uiNode];
+    if( rcNode.uiCount )
+    {
+      for( uint32_t i = 0; i < rcNode.uiCount; i++ )
+      {
+        const uint32_t uiPrimitive = m_cIndices[rcNode.uiFirst + i];
+        const float    fT          = fnIntersect( uiPrimitive, rfT );
+        if( fT >= 0.0f && fT < rfT )
+        {
+          rfT  = fT;
+          iHit = (int32_t)uiPrimitive;
+        }
+      }
+      continue;
+    }
+
+    // visit the nearer child first, so that the farther one can often be skipped
+    float fLeft, fRight;
+    const bool bLeft  = intersectBox( rcRay, m_cNodes[rcNode.uiFirst].afMin, m_cNodes[rcNode.uiFirst].afMax, rfT, fLeft );
+    const bool bRight = intersectBox( rcRay, m_cNodes[rcNode.uiFirst + 1].afMin, m_cNodes[rcNode.uiFirst + 1].afMax, rfT, fRight );
+    if( bLeft && bRight )
+    {
+      if( fLeft <= fRight )
+      {
+        acStack[uiStackSize++] = { rcNode.uiFirst + 1, fRight };
+        acStack[uiStackSize++] = { rcNode.uiFirst, fLeft };
+      }
+      else
+      {
+        acStack[uiStackSize++] = { rcNode.uiFirst, fLeft };
+        acStack[uiStackSize++] = { rcNode.uiFirst + 1, fRight };
+      }
+    }
+    else if( bLeft )  acStack[uiStackSize++] = { rcNode.uiFirst, fLeft };
+    else if( bRight ) acStack[uiStackSize++] = { rcNode.uiFirst + 1, fRight };
+  }
+  return iHit;
+}
+
+
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef COMMANDLIST_H
+#define COMMANDLIST_H
+
+
+#include "glad/glad.h"
+
+#include "GLRender/GLRenderDecl.h"
+#include "GLRender/RenderQueue.h"
+#include "GLRender/TextureManager.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+
+
+// draw, bind and upload commands recorded on any thread and replayed later on the thread
+// that owns the GL context; everything a command needs is copied into the list, so the
+// recording thread may change its objects while the list is replayed
+//
+// Draws are not issued in recording order: the draws between two flushes go through a
+// RenderQueue and are sorted by state. Closures (DrawItem::fnUniforms, call, upload) must
+// own the values they use, they run on the GL thread while the recorder goes on.
+class GLRENDER_DECL CommandList
+{
+public:
+  CommandList();
+
+  // draw an item; with a texture handle the GL name is taken at replay time, it changes
+  // when the texture finishes loading or drops levels
+  void draw( const DrawItem& rcItem, const TextureHandle& rcTexture = TextureHandle() );
+  // draw everything recorded since the last flush (end of a pass)
+  void flush();
+
+  // copy uiSize bytes and write them into the buffer at replay (glBufferSubData)
+  void bufferSubData( GLenum eTarget, GLuint uiBuffer, GLintptr iOffset, const void* pvData, size_t uiSize );
+  // copy uiSize bytes and hand them to fnUpload at replay, e.g. to fill a mapped stream buffer
+  void upload( const void* pvData, size_t uiSize, const std::function<void( const void*, size_t )>& fnUpload );
+  // any other GL work (binds, state changes)
+  void call( const std::function<void()>& fnCall );
+
+  // GL thread: replay all commands, the draws go through rcQueue; the statistics of all
+  // flushes are added to pcStats
+  void execute( RenderQueue& rcQueue, RenderQueueStats* pcStats = NULL ) const;
+
+  // drop all commands, the memory is kept for the next frame
+  void clear();
+
+  bool   empty() const { return m_cCommands.empty(); }
+  size_t getNumCommands() const { return m_cCommands.size(); }
+  size_t getNumDraws() const { return m_cItems.size(); }
+  // bytes copied for uploads
+  size_t getDataBytes() const { return m_cData.size(); }
+
+
+protected:
+  enum Type
+  {
+    CMD_DRAW,
+    CMD_FLUSH,
+    CMD_BUFFER_SUB_DATA,
+    CMD_UPLOAD,
+    CMD_CALL
+  };
+
+  struct Command
+  {
+    Type      eType;
+    uint32_t  uiIndex;      // draw item, upload or call
+    GLenum    eTarget;      // buffer upload
+    GLuint    uiBuffer;
+    GLintptr  iOffset;
+    size_t    uiDataOffset; // in m_cData
+    size_t    uiDataSize;
+  };
+
+  // copy data to the end of m_cData, returns its offset
+  size_t addData( const void* pvData, size_t uiSize );
+
+  std::vector<Command>        m_cCommands;
+  std::vector<DrawItem>       m_cItems;
+  std::vector<TextureHandle>  m_cTextures;    // per draw item, empty without texture
+  std::vector<std::function<void( const void*, size_t )> > m_cUploads;
+  std::vector<std::function<void()> > m_cCalls;
+  std::vector<unsigned char>  m_cData;
+};
+
+
+
+#endif
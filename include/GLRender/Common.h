@@ -42,6 +42,12 @@ std::string GLRENDER_DECL getDirectoryName( const std::string cFName );
 // load and image into memory
 int GLRENDER_DECL loadPNG(const std::string cFName, std::vector<unsigned char>& rcImgData, unsigned int& ruiWidth, unsigned int& ruiHeight);
 
+// write RGBA image data (rows from top to bottom) to a png file
+int GLRENDER_DECL savePNG(const std::string cFName, const std::vector<unsigned char>& rcImgData, unsigned int uiWidth, unsigned int uiHeight);
+
+// quoted and escaped JSON string literal of rcStr
+std::string GLRENDER_DECL getJsonString( const std::string& rcStr );
+
 
 
 
@@ -0,0 +1,55 @@
+#ifndef FIXEDTIMESTEP_H
+#define FIXEDTIMESTEP_H
+
+
+#include "GLRender/GLRenderDecl.h"
+
+#include <chrono>
+#include <cstdint>
+
+
+
+// clock of a fixed-step game loop: the simulation advances in ticks of constant length, so
+// it behaves the same at any frame rate; the time left over after the last tick is the
+// fraction between the last two simulation states the renderer interpolates at
+//
+// After a stall (slow frame, window dragged, breakpoint) at most uiMaxTicksPerFrame ticks
+// are run at once and the rest of the backlog is dropped: the game slows down for a moment
+// instead of spending ever longer frames catching up.
+class GLRENDER_DECL FixedTimestep
+{
+public:
+  FixedTimestep( double dTicksPerSecond = 60.0, unsigned int uiMaxTicksPerFrame = 5 );
+
+  void setTickRate( double dTicksPerSecond );
+  void setMaxTicksPerFrame( unsigned int uiMaxTicksPerFrame ) { m_uiMaxTicks = uiMaxTicksPerFrame ? uiMaxTicksPerFrame : 1; }
+
+  // add dElapsedSeconds of real time; returns the number of ticks to simulate now
+  unsigned int advance( double dElapsedSeconds );
+  // same with the time since the previous call (or reset) measured on the steady clock
+  unsigned int advance();
+  // drop the accumulated time and start measuring from now (after loading, after a pause)
+  void reset();
+
+  double   getStep() const { return m_dStep; }
+  // fraction of a tick elapsed after the last one, 0 .. 1
+  double   getAlpha() const { return m_dAccumulator / m_dStep; }
+  uint64_t getNumTicks() const { return m_uiNumTicks; }
+  // ticks dropped because of the catch-up limit
+  uint64_t getNumDroppedTicks() const { return m_uiNumDropped; }
+  double   getSimulatedSeconds() const { return (double)m_uiNumTicks * m_dStep; }
+
+
+protected:
+  double        m_dStep;
+  double        m_dAccumulator;   // real time not simulated yet, always below one step
+  unsigned int  m_uiMaxTicks;
+  uint64_t      m_uiNumTicks;
+  uint64_t      m_uiNumDropped;
+
+  std::chrono::steady_clock::time_point m_cLast;
+};
+
+
+
+#endif
@@ -0,0 +1,167 @@
+#ifndef FRAMEGRAPH_H
+#define FRAMEGRAPH_H
+
+
+#include "glad/glad.h"
+
+#include "GLRender/GLRenderDecl.h"
+
+#include <functional>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+
+class Profiler;
+
+
+
+typedef unsigned int FrameGraphResource;
+
+
+
+// a texture created and owned by the frame graph, alive from its first to its last use
+// within a frame; textures of resources whose lifetimes do not overlap are shared
+struct GLRENDER_DECL FrameGraphTextureDesc
+{
+  FrameGraphTextureDesc( GLenum eFormat = GL_RGBA8, float fScale = 1.0f ) : eInternalFormat( eFormat ), fSizeScale( fScale ) {}
+
+  GLenum  eInternalFormat;  // GL_RGBA8, GL_RGBA16F, GL_DEPTH_COMPONENT24, ...
+  float   fSizeScale;       // size relative to the target (0.5 = half resolution)
+
+  bool isDepth() const;
+};
+
+
+
+// declarative description of the passes of a frame: every pass states which resources it
+// reads and writes, the graph derives the execution order from that, drops passes whose
+// results are never used and binds framebuffers with the written resources before a pass
+// executes
+//
+// Accesses are resolved in the order the passes are added, like a single threaded program
+// would. Writes come in two flavours: ordered writes (blending, full screen overwrites)
+// keep their place, depth tested writes of opaque geometry may be reordered freely by
+// iOrder, e.g. to draw large occluders first. A pass that depth tests against the scene
+// without writing depth (a background at the far plane) is added after the geometry and
+// reads the depth buffer, so it runs after every pass writing depth and only shades the
+// pixels left uncovered. Resources that are never read and not part of the target make
+// their writers disappear.
+class GLRENDER_DECL FrameGraph
+{
+public:
+  // the framebuffer bound when execute is called (window or offscreen target)
+  static const FrameGraphResource TARGET_COLOR = 0;
+  static const FrameGraphResource TARGET_DEPTH = 1;
+
+  // declaration interface handed to the setup function of a pass
+  class GLRENDER_DECL Builder
+  {
+  public:
+    void read( FrameGraphResource uiResource );
+    void write( FrameGraphResource uiResource );
+    void writeDepthTested( FrameGraphResource uiResource );
+
+  protected:
+    friend class FrameGraph;
+    Builder( FrameGraph& rcGraph, unsigned int uiPass ) : m_rcGraph( rcGraph ), m_uiPass( uiPass ) {}
+
+    FrameGraph&   m_rcGraph;
+    unsigned int  m_uiPass;
+  };
+
+  FrameGraph();
+  ~FrameGraph();
+
+  FrameGraph( const FrameGraph& ) = delete;
+  FrameGraph& operator=( const FrameGraph& ) = delete;
+
+  // size of the target, transient textures are sized relative to it
+  void setTargetSize( int iWidth, int iHeight );
+  // time every pass with the profiler (scopes are registered under the pass names)
+  void setProfiler( Profiler* pcProfiler );
+
+  // declare a transient texture
+  FrameGraphResource createTexture( const std::string& rcName, const FrameGraphTextureDesc& rcDesc );
+
+  // add a pass; fnSetup declares the accesses (called once), fnExecute draws (every frame);
+  // among passes that are free to run, lower iOrder goes first
+  unsigned int addPass( const std::string& rcName, const std::function<void( Builder& )>& fnSetup,
+                        const std::function<void()>& fnExecute, int iOrder = 0 );
+
+  // sort and cull the passes, done by execute when passes were added
+  void compile();
+
+  // run all passes into the currently bound framebuffer
+  void execute();
+
+  // texture of a transient resource, valid in the execute function of a pass reading it
+  GLuint getTexture( FrameGraphResource uiResource ) const;
+
+  // passes in execution order (culled passes are not included)
+  const std::vector<unsigned int>& getExecutionOrder() const { return m_cOrder; }
+  const std::string& getPassName( unsigned int uiPass ) const { return m_cPasses[uiPass].cName; }
+  void printOrder( std::ostream& rcStream ) const;
+
+  // free all textures and framebuffers
+  void destroy();
+
+
+protected:
+  enum Access
+  {
+    ACCESS_READ,
+    ACCESS_WRITE,
+    ACCESS_WRITE_DEPTH_TESTED
+  };
+
+  struct Pass
+  {
+    std::string                 cName;
+    std::vector<std::pair<FrameGraphResource, Access> > cAccesses;
+    std::function<void()>       fnExecute;
+    int                         iOrder;
+    unsigned int                uiScope;
+    bool                        bCulled;
+  };
+
+  struct Resource
+  {
+    std::string           cName;
+    bool                  bTransient;
+    FrameGraphTextureDesc cDesc;
+    GLuint                uiTexture;      // while alive during execute
+    int                   iLastUse;       // position in the execution order
+  };
+
+  struct PooledTexture
+  {
+    FrameGraphTextureDesc cDesc;
+    GLuint                uiTexture;
+    bool                  bInUse;
+  };
+
+  void   addAccess( unsigned int uiPass, FrameGraphResource uiResource, Access eAccess );
+  GLuint acquireTexture( const FrameGraphTextureDesc& rcDesc );
+  void   releaseTexture( GLuint uiTexture );
+  // framebuffer with the given transient attachments (cached)
+  GLuint getFramebuffer( GLuint uiColor, GLuint uiDepth );
+  void   freeTextures();
+
+  std::vector<Pass>           m_cPasses;
+  std::vector<Resource>       m_cResources;
+  std::vector<unsigned int>   m_cOrder;
+  bool                        m_bDirty;
+
+  int                         m_iWidth;
+  int                         m_iHeight;
+  Profiler*                   m_pcProfiler;
+
+  std::vector<PooledTexture>  m_cPool;
+  std::map<std::pair<GLuint, GLuint>, GLuint> m_cFramebuffers;
+};
+
+
+
+#endif
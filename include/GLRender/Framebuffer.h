@@ -0,0 +1,51 @@
+#ifndef FRAMEBUFFER_H
+#define FRAMEBUFFER_H
+
+
+#include "glad/glad.h"
+
+#include "GLRender/GLRenderDecl.h"
+
+#include <vector>
+
+
+
+// offscreen render target with an RGBA8 color and a 24 bit depth renderbuffer, used for
+// rendering without a window (benchmarks, frame dumps)
+class GLRENDER_DECL Framebuffer
+{
+public:
+  Framebuffer();
+  ~Framebuffer();
+
+  // create the target, returns 0 on success, -1 if the framebuffer is incomplete
+  int create( int iWidth, int iHeight );
+  void destroy();
+
+  // render into this target (sets the viewport)
+  void bind() const;
+  // render into the window again
+  static void bindDefault();
+
+  // read back the color buffer as RGBA rows from top to bottom (PNG order)
+  void readPixels( std::vector<unsigned char>& rcPixels ) const;
+
+  GLuint getFBO() const { return m_uiFBO; }
+  int getWidth() const { return m_iWidth; }
+  int getHeight() const { return m_iHeight; }
+
+
+protected:
+  Framebuffer( const Framebuffer& );
+  Framebuffer& operator=( const Framebuffer& );
+
+  GLuint  m_uiFBO;
+  GLuint  m_uiColorRB;
+  GLuint  m_uiDepthRB;
+  int     m_iWidth;
+  int     m_iHeight;
+};
+
+
+
+#endif
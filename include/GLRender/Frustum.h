@@ -0,0 +1,65 @@
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+
+#include "GLRender/GLRenderDecl.h"
+
+#include <cstddef>
+#include <vector>
+
+
+
+// bounding spheres in structure of arrays layout, so that the culling can load four
+// spheres into one SIMD register; the arrays are padded to a multiple of four
+class GLRENDER_DECL BoundingSpheres
+{
+public:
+  BoundingSpheres() : m_uiSize( 0 ) {}
+
+  void clear() { m_uiSize = 0; m_cX.clear(); m_cY.clear(); m_cZ.clear(); m_cR.clear(); }
+  void reserve( size_t uiSize );
+  void add( float fX, float fY, float fZ, float fRadius );
+
+  size_t size() const { return m_uiSize; }
+  const float* getX() const { return m_cX.data(); }
+  const float* getY() const { return m_cY.data(); }
+  const float* getZ() const { return m_cZ.data(); }
+  const float* getRadius() const { return m_cR.data(); }
+
+
+protected:
+  size_t              m_uiSize;
+  std::vector<float>  m_cX;
+  std::vector<float>  m_cY;
+  std::vector<float>  m_cZ;
+  std::vector<float>  m_cR;
+};
+
+
+
+// six planes of a view frustum, pointing inwards
+class GLRENDER_DECL Frustum
+{
+public:
+  Frustum();
+
+  // extract the planes from a column major view projection matrix (OpenGL layout)
+  void setMatrix( const float* pfViewProj );
+
+  // true if the sphere / box intersects or lies inside the frustum (conservative)
+  bool testSphere( float fX, float fY, float fZ, float fRadius ) const;
+  bool testAABB( const float* pfMin, const float* pfMax ) const;
+
+  // test all spheres, pucVisible[i] is set to 1 for visible and 0 for culled spheres;
+  // uses SSE (four spheres per instruction) where available; returns the number visible
+  size_t cull( const BoundingSpheres& rcSpheres, unsigned char* pucVisible ) const;
+
+
+protected:
+  // plane i: afPlanes[i][0..2] * p + afPlanes[i][3] >= 0 inside
+  float m_aafPlanes[6][4];
+};
+
+
+
+#endif
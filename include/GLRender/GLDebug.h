@@ -0,0 +1,58 @@
+#ifndef GLDEBUG_H
+#define GLDEBUG_H
+
+
+#include "glad/glad.h"
+
+#include "GLRender/GLRenderDecl.h"
+
+
+
+// GL_CHECK( "label" ) marks a place where GL errors should be reported. In builds without
+// GLRENDER_GL_DEBUG (set by CMake for Debug configurations) it expands to nothing, so the
+// hot path never pays for a glGetError round trip.
+#ifdef GLRENDER_GL_DEBUG
+#define GL_CHECK( label ) GLDebug::check( label, __FILE__, __LINE__ )
+#else
+#define GL_CHECK( label ) ((void)0)
+#endif
+
+
+
+// Debug layer on top of KHR_debug: with a debug callback the driver reports errors and
+// warnings itself and GL_CHECK does nothing; without it GL_CHECK falls back to polling
+// glGetError, but only while the layer is enabled.
+class GLRENDER_DECL GLDebug
+{
+public:
+  // install the debug message callback if the context offers it (after loadGLExtensions);
+  // the layer starts enabled in GLRENDER_GL_DEBUG builds and disabled otherwise
+  static void init();
+
+  // switch reporting on or off at runtime
+  static void setEnabled( bool bEnabled );
+  static bool isEnabled() { return s_bEnabled; }
+
+  // true if the driver reports errors through the debug callback
+  static bool hasCallback() { return s_bCallback; }
+
+  // number of errors reported since init
+  static unsigned int getNumErrors() { return s_uiNumErrors; }
+
+  // report pending GL errors (only used without debug callback), see GL_CHECK
+  static void check( const char* pcLabel, const char* pcFile, int iLine );
+
+
+protected:
+  static void APIENTRY messageCallback( GLenum eSource, GLenum eType, GLuint uiId, GLenum eSeverity,
+                                        GLsizei iLength, const GLchar* pcMessage, const void* pvUser );
+
+  static bool         s_bEnabled;
+  static bool         s_bCallback;
+  static bool         s_bDebugOutput;   // GL_DEBUG_OUTPUT exists (GL 4.3 / KHR_debug, not ARB)
+  static unsigned int s_uiNumErrors;
+};
+
+
+
+#endif
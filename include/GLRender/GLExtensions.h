@@ -0,0 +1,94 @@
+#ifndef GLEXTENSIONS_H
+#define GLEXTENSIONS_H
+
+
+#include "glad/glad.h"
+
+#include "GLRender/GLRenderDecl.h"
+
+
+
+// The vendored glad loader only covers OpenGL 4.0 without extensions. Entry points of
+// newer core versions / extensions that are used optionally are loaded here; all of them
+// may be NULL, check the GLEXT_* flags before use.
+
+// GL 4.1 / ARB_get_program_binary
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT  0x8257
+#define GL_PROGRAM_BINARY_LENGTH            0x8741
+#define GL_NUM_PROGRAM_BINARY_FORMATS       0x87FE
+#define GL_PROGRAM_BINARY_FORMATS           0x87FF
+
+typedef void (APIENTRYP PFNGLEXTGETPROGRAMBINARYPROC)(GLuint program, GLsizei bufSize, GLsizei *length, GLenum *binaryFormat, void *binary);
+typedef void (APIENTRYP PFNGLEXTPROGRAMBINARYPROC)(GLuint program, GLenum binaryFormat, const void *binary, GLsizei length);
+typedef void (APIENTRYP PFNGLEXTPROGRAMPARAMETERIPROC)(GLuint program, GLenum pname, GLint value);
+
+extern GLRENDER_DECL PFNGLEXTGETPROGRAMBINARYPROC   glext_glGetProgramBinary;
+extern GLRENDER_DECL PFNGLEXTPROGRAMBINARYPROC      glext_glProgramBinary;
+extern GLRENDER_DECL PFNGLEXTPROGRAMPARAMETERIPROC  glext_glProgramParameteri;
+#define glGetProgramBinary  glext_glGetProgramBinary
+#define glProgramBinary     glext_glProgramBinary
+#define glProgramParameteri glext_glProgramParameteri
+
+// GL 4.3 / KHR_debug (ARB_debug_output as fallback)
+#define GL_DEBUG_OUTPUT_SYNCHRONOUS         0x8242
+#define GL_DEBUG_SOURCE_API                 0x8246
+#define GL_DEBUG_SOURCE_WINDOW_SYSTEM       0x8247
+#define GL_DEBUG_SOURCE_SHADER_COMPILER     0x8248
+#define GL_DEBUG_SOURCE_THIRD_PARTY         0x8249
+#define GL_DEBUG_SOURCE_APPLICATION         0x824A
+#define GL_DEBUG_SOURCE_OTHER               0x824B
+#define GL_DEBUG_TYPE_ERROR                 0x824C
+#define GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR   0x824D
+#define GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR    0x824E
+#define GL_DEBUG_TYPE_PORTABILITY           0x824F
+#define GL_DEBUG_TYPE_PERFORMANCE           0x8250
+#define GL_DEBUG_TYPE_OTHER                 0x8251
+#define GL_DEBUG_SEVERITY_HIGH              0x9146
+#define GL_DEBUG_SEVERITY_MEDIUM            0x9147
+#define GL_DEBUG_SEVERITY_LOW               0x9148
+#define GL_DEBUG_SEVERITY_NOTIFICATION      0x826B
+#define GL_DEBUG_OUTPUT                     0x92E0
+
+typedef void (APIENTRYP PFNGLEXTDEBUGMESSAGECALLBACKPROC)(GLDEBUGPROC callback, const void *userParam);
+typedef void (APIENTRYP PFNGLEXTDEBUGMESSAGECONTROLPROC)(GLenum source, GLenum type, GLenum severity, GLsizei count, const GLuint *ids, GLboolean enabled);
+
+extern GLRENDER_DECL PFNGLEXTDEBUGMESSAGECALLBACKPROC glext_glDebugMessageCallback;
+extern GLRENDER_DECL PFNGLEXTDEBUGMESSAGECONTROLPROC  glext_glDebugMessageControl;
+#define glDebugMessageCallback  glext_glDebugMessageCallback
+#define glDebugMessageControl   glext_glDebugMessageControl
+
+// GL 4.4 / ARB_buffer_storage
+#define GL_MAP_PERSISTENT_BIT               0x0040
+#define GL_MAP_COHERENT_BIT                 0x0080
+#define GL_DYNAMIC_STORAGE_BIT              0x0100
+#define GL_CLIENT_STORAGE_BIT               0x0200
+
+typedef void (APIENTRYP PFNGLEXTBUFFERSTORAGEPROC)(GLenum target, GLsizeiptr size, const void *data, GLbitfield flags);
+
+extern GLRENDER_DECL PFNGLEXTBUFFERSTORAGEPROC glext_glBufferStorage;
+#define glBufferStorage glext_glBufferStorage
+
+// EXT_texture_compression_s3tc (RGTC is core since GL 3.0)
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT     0x83F0
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT    0x83F1
+
+
+// availability of optional features (valid after loadGLExtensions)
+extern GLRENDER_DECL bool GLEXT_program_binary;
+extern GLRENDER_DECL bool GLEXT_debug_output;
+extern GLRENDER_DECL bool GLEXT_buffer_storage;
+extern GLRENDER_DECL bool GLEXT_texture_compression_s3tc;
+
+
+// load all optional entry points of the current context, call after gladLoadGL()
+int GLRENDER_DECL loadGLExtensions( GLADloadproc pfnLoad );
+
+// test if the current context supports an extension (valid after loadGLExtensions)
+bool GLRENDER_DECL hasGLExtension( const char* pcName );
+
+// test if the current context has at least the given core version
+bool GLRENDER_DECL hasGLVersion( int iMajor, int iMinor );
+
+
+
+#endif
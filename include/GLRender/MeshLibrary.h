@@ -0,0 +1,188 @@
+#ifndef MESHLIBRARY_H
+#define MESHLIBRARY_H
+
+
+#include "glad/glad.h"
+
+#include "GLRender/GLRenderDecl.h"
+#include "GLRender/MeshOptimizer.h"
+#include "GLRender/VertexFormat.h"
+
+#include <map>
+#include <memory>
+#include <ostream>
+#include <vector>
+
+
+
+// parameters a procedural mesh is generated from, also used as key of the library
+struct GLRENDER_DECL MeshDesc
+{
+  enum MeshType
+  {
+    MESH_CYLINDER,    // (tapered) cylinder shell along z, from z = 0 to z = fHeight
+    MESH_SPHERE       // uv sphere around (0, 0, fOffsetZ)
+  };
+
+  MeshType  eType;
+  // segments around the z axis
+  int       iSegments;
+  // rings from pole to pole (sphere only)
+  int       iRings;
+  // radius at z = 0 (cylinder) or radius of the sphere
+  float     fRadius;
+  // radius at z = fHeight (cylinder only)
+  float     fTopRadius;
+  // height (cylinder only)
+  float     fHeight;
+  // translation in z direction (sphere only)
+  float     fOffsetZ;
+  // false if the texture coordinates are never read: they are not stored, and vertices on
+  // the uv seam and at the poles are merged by the optimizer
+  bool      bTexCoords;
+
+  // strict weak ordering for the library map
+  bool operator<( const MeshDesc& rcOther ) const;
+
+  static MeshDesc cylinder( int iSegments, float fRadius, float fTopRadius, float fHeight );
+  static MeshDesc sphere( int iSegments, int iRings, float fRadius, float fOffsetZ );
+
+  // coarser version for level of detail iLevel: segments and rings are halved per level
+  MeshDesc simplified( int iLevel ) const;
+};
+
+
+
+// axis aligned box and bounding sphere in object space
+struct GLRENDER_DECL MeshBounds
+{
+  float afMin[3];
+  float afMax[3];
+  float afCenter[3];
+  float fRadius;
+
+  // bounds of the positions of interleaved vertices (iStride floats per vertex)
+  static MeshBounds fromVertices( const std::vector<float>& rcVertices, int iStride );
+  // bounds enclosing both
+  static MeshBounds merge( const MeshBounds& rcA, const MeshBounds& rcB );
+};
+
+
+
+// GPU mesh, built from interleaved float vertices (position (3 floats) + texture coordinate
+// (2 floats)) and stored in the given vertex format; indices are stored as 16 bit when the
+// vertex count allows it
+class GLRENDER_DECL Mesh
+{
+public:
+  // encode and upload vertices and indices
+  Mesh( const std::vector<float>& rcVertices, const std::vector<unsigned int>& rcIndices,
+        const VertexFormat& rcFormat = VertexFormat(), const MeshOptimizeStats* pcStats = 0 );
+  // free all GL objects
+  ~Mesh();
+
+  Mesh( const Mesh& ) = delete;
+  Mesh& operator=( const Mesh& ) = delete;
+
+  GLuint  getVAO() const { return m_uiVAO; }
+  GLuint  getVBO() const { return m_uiVBO; }
+  GLuint  getEBO() const { return m_uiEBO; }
+  GLsizei getIndexCount() const { return m_iIndexCount; }
+  GLsizei getVertexCount() const { return m_iVertexCount; }
+  // GL_UNSIGNED_SHORT or GL_UNSIGNED_INT, for glDrawElements
+  GLenum  getIndexType() const { return m_eIndexType; }
+  const MeshBounds& getBounds() const { return m_cBounds; }
+  const VertexFormat& getFormat() const { return m_cFormat; }
+  // mapping of the stored positions to object space, has to be applied in the vertex shader
+  // or multiplied into the model matrix for quantized formats
+  const VertexQuantization& getQuantization() const { return m_cQuantization; }
+  // result of the optimization when the mesh was built (all zero if it was not optimized)
+  const MeshOptimizeStats& getOptimizeStats() const { return m_cOptimizeStats; }
+
+  // bind vertex and index buffer and set up the attributes of the vertex format for the
+  // currently bound VAO, so that other VAOs (e.g. for instancing) can share the buffers
+  void setupAttribs() const;
+
+
+protected:
+  GLuint  m_uiVAO;
+  GLuint  m_uiVBO;
+  GLuint  m_uiEBO;
+
+  GLsizei m_iIndexCount;
+  GLsizei m_iVertexCount;
+  GLenum  m_eIndexType;
+  MeshBounds m_cBounds;
+  VertexFormat m_cFormat;
+  VertexQuantization m_cQuantization;
+  MeshOptimizeStats m_cOptimizeStats;
+};
+
+typedef std::shared_ptr<Mesh> MeshHandle;
+
+
+
+// levels of detail of one mesh, level 0 is the full mesh; the level is chosen from the
+// projected size of the bounding sphere
+struct GLRENDER_DECL MeshLODChain
+{
+  MeshLODChain() : fHysteresis( 0.15f ) {}
+
+  std::vector<MeshHandle> cLevels;
+  // level i is used down to a projected diameter of cMinPixels[i] pixels (one entry less
+  // than levels, descending); below the last entry the coarsest level is used
+  std::vector<float>      cMinPixels;
+  // relative margin around the thresholds, so that a piece at the boundary does not pop
+  float                   fHysteresis;
+
+  int getNumLevels() const { return (int)cLevels.size(); }
+
+  // level for a projected bounding sphere diameter in pixels, given the level of the last frame
+  int selectLevel( float fPixels, int iCurrent ) const;
+};
+
+
+
+// builds every procedural mesh once and hands out ref-counted handles;
+// a mesh is freed when its last handle is released
+class GLRENDER_DECL MeshLibrary
+{
+public:
+  // library for the current GL context
+  static MeshLibrary& get();
+
+  // get the mesh for the given parameters, generate it if it does not exist yet
+  MeshHandle acquire( const MeshDesc& rcDesc );
+
+  // get iNumLevels levels of detail (see MeshDesc::simplified); a level is dropped when a
+  // silhouette edge would be longer than fMaxEdgePixels on screen
+  MeshLODChain acquireLODChain( const MeshDesc& rcDesc, int iNumLevels, float fMaxEdgePixels = 4.0f );
+
+  // number of meshes currently alive
+  size_t getNumMeshes() const;
+
+  // vertex format of the meshes built for rcDesc (16 bit positions, 16 bit texture
+  // coordinates if they are used)
+  static VertexFormat getFormat( const MeshDesc& rcDesc );
+
+  // print vertex / triangle counts, vertex and index size and ACMR before and after optimization of
+  // all meshes currently alive
+  void printStats( std::ostream& rcStream ) const;
+
+  // generate the geometry on the CPU
+  static void generate( const MeshDesc& rcDesc, std::vector<float>& rcVertices, std::vector<unsigned int>& rcIndices );
+
+
+protected:
+  MeshLibrary() {}
+
+  static void generateCylinder( const MeshDesc& rcDesc, std::vector<float>& rcVertices, std::vector<unsigned int>& rcIndices );
+  static void generateSphere( const MeshDesc& rcDesc, std::vector<float>& rcVertices, std::vector<unsigned int>& rcIndices );
+
+  // meshes by generation parameters, not owned
+  std::map<MeshDesc, std::weak_ptr<Mesh> > m_cMeshes;
+};
+
+
+
+#endif
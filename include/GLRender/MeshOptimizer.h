@@ -0,0 +1,60 @@
+#ifndef MESHOPTIMIZER_H
+#define MESHOPTIMIZER_H
+
+
+#include "GLRender/GLRenderDecl.h"
+
+#include <vector>
+
+
+
+// effect of MeshOptimizer::optimize on one mesh
+struct GLRENDER_DECL MeshOptimizeStats
+{
+  unsigned int  uiVerticesBefore;
+  unsigned int  uiVerticesAfter;
+  unsigned int  uiTrianglesBefore;
+  unsigned int  uiTrianglesAfter;
+  // average cache miss ratio (transformed vertices per triangle) for a FIFO cache
+  float         fAcmrBefore;
+  float         fAcmrAfter;
+};
+
+
+
+// optimization stage for generated triangle lists with interleaved float vertices
+class GLRENDER_DECL MeshOptimizer
+{
+public:
+  // cache size used for reporting, a typical post-transform FIFO size
+  static const unsigned int REPORT_CACHE_SIZE = 16;
+
+  // run all steps: weld, remove degenerate triangles, reorder for the vertex cache and
+  // for vertex fetch; iCompare is the number of leading floats that must be equal to
+  // merge two vertices (3 = position only, the other attributes are taken from one of them)
+  static void optimize( std::vector<float>& rcVertices, std::vector<unsigned int>& rcIndices, int iStride, int iCompare,
+                        MeshOptimizeStats* pcStats = 0 );
+
+  // merge vertices whose first iCompare floats are equal up to fEpsilon (e.g. the seam
+  // column and the poles of a sphere)
+  static void weldVertices( std::vector<float>& rcVertices, std::vector<unsigned int>& rcIndices, int iStride, int iCompare,
+                            float fEpsilon = 1.0e-5f );
+
+  // drop triangles that use one vertex twice
+  static void removeDegenerates( std::vector<unsigned int>& rcIndices );
+
+  // reorder triangles for the post-transform cache (Forsyth, linear speed vertex cache
+  // optimisation)
+  static void optimizeVertexCache( std::vector<unsigned int>& rcIndices, unsigned int uiNumVertices );
+
+  // reorder vertices in the order of first use, so that fetching is mostly sequential
+  static void optimizeVertexFetch( std::vector<float>& rcVertices, std::vector<unsigned int>& rcIndices, int iStride );
+
+  // average cache miss ratio for a FIFO cache of the given size
+  static float computeACMR( const std::vector<unsigned int>& rcIndices, unsigned int uiNumVertices,
+                            unsigned int uiCacheSize = REPORT_CACHE_SIZE );
+};
+
+
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef PIXELCONVERT_H
+#define PIXELCONVERT_H
+
+
+#include "GLRender/GLRenderDecl.h"
+
+#include <cstddef>
+
+
+
+// conversions of 8 bit pixel data after decoding and before upload / after readback;
+// each function has a scalar, an SSE2 and an AVX2 version, the best one the CPU supports
+// is chosen at run time
+class GLRENDER_DECL PixelConvert
+{
+public:
+  enum Isa
+  {
+    ISA_SCALAR = 0,
+    ISA_SSE2   = 1,
+    ISA_AVX2   = 2
+  };
+
+  // best instruction set of this CPU (and build)
+  static Isa getSupportedIsa();
+  // instruction set the functions use, at most the supported one (for benchmarks and tests)
+  static Isa getIsa();
+  static void setIsa( Isa eIsa );
+  static const char* getIsaName( Isa eIsa );
+
+  // RGB to RGBA with constant alpha; pucDst must not overlap pucSrc
+  static void expandRGBToRGBA( const unsigned char* pucSrc, unsigned char* pucDst, size_t uiNumPixels, unsigned char ucAlpha = 255 );
+  // swap red and blue of RGBA pixels (RGBA <-> BGRA), may work in place
+  static void swapRedBlue( const unsigned char* pucSrc, unsigned char* pucDst, size_t uiNumPixels );
+  // multiply the colors of RGBA pixels by their alpha, in place (rounded like c * a / 255)
+  static void premultiplyAlpha( unsigned char* pucPixels, size_t uiNumPixels );
+  // mirror an image vertically in place, rows of uiRowBytes bytes
+  static void flipRows( unsigned char* pucPixels, size_t uiRowBytes, size_t uiNumRows );
+};
+
+
+
+#endif
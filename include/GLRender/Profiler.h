@@ -0,0 +1,169 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+
+#include "glad/glad.h"
+
+#include "GLRender/GLRenderDecl.h"
+#include "GLRender/SpscRing.h"
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <ostream>
+#include <string>
+#include <vector>
+
+
+
+// timing of one scope in one frame
+struct ProfileSample
+{
+  uint32_t  uiScope;
+  uint32_t  uiFrame;
+  int64_t   iCpuStartNs;    // relative to the creation of the profiler
+  int64_t   iCpuNs;
+  int64_t   iGpuNs;         // < 0 if the scope has no GPU timer
+};
+
+
+// percentiles of one scope over the frames in the history, in milliseconds
+struct ProfileSummary
+{
+  std::string   cName;
+  size_t        uiCount;
+  double        adCpuMs[3];   // p50, p95, p99
+  double        adGpuMs[3];   // p50, p95, p99, negative without GPU samples
+};
+
+
+
+// Frame profiler with CPU timers and GL_TIME_ELAPSED query based GPU timers per scope.
+// GPU results are read back a few frames later so that the query never stalls the
+// pipeline; completed samples go through a lock-free ring, so export and summaries may
+// run on another thread than the render loop.
+//
+// Time elapsed queries cannot be nested: only the outermost open scope gets a GPU timer.
+class GLRENDER_DECL Profiler
+{
+public:
+  // frames until GPU results are read back
+  static const unsigned int FRAMES_IN_FLIGHT = 4;
+  // frames kept in the history by default (a minute at 60 Hz)
+  static const unsigned int DEFAULT_HISTORY_FRAMES = 3600;
+  // implicit scope that covers beginFrame .. endFrame (CPU only)
+  static const unsigned int FRAME_SCOPE = 0;
+
+  Profiler();
+  ~Profiler();
+
+  // register a named scope (during setup, before the first frame), returns its id
+  unsigned int registerScope( const std::string& rcName, bool bGpu = true );
+  const std::string& getScopeName( unsigned int uiScope ) const { return m_cScopes[uiScope].cName; }
+  unsigned int getNumScopes() const { return (unsigned int)m_cScopes.size(); }
+
+  // switch timing on or off, begin/end cost next to nothing while disabled
+  void setEnabled( bool bEnabled ) { m_bEnabled = bEnabled; }
+  bool isEnabled() const { return m_bEnabled; }
+
+  // render thread: frame and scope brackets
+  void beginFrame();
+  void endFrame();
+  void begin( unsigned int uiScope );
+  void end( unsigned int uiScope );
+
+  // render thread: read back all outstanding GPU results (blocks)
+  void flush();
+  // render thread: release the GL queries (before the context goes away)
+  void destroy();
+
+  // consumer thread: move completed samples from the ring into the history; samples older
+  // than the last getHistoryFrames() frames are dropped, so a long running loop stays bounded
+  void collect();
+  const std::deque<ProfileSample>& getHistory() const { return m_cHistory; }
+  void clearHistory() { m_cHistory.clear(); }
+  void setHistoryFrames( unsigned int uiFrames ) { m_uiHistoryFrames = uiFrames ? uiFrames : 1; }
+  unsigned int getHistoryFrames() const { return m_uiHistoryFrames; }
+  // samples lost because the ring was full
+  unsigned int getNumDropped() const { return m_uiNumDropped.load( std::memory_order_relaxed ); }
+
+  // consumer thread: percentiles per scope over the history
+  void getSummary( std::vector<ProfileSummary>& rcSummary ) const;
+  void printSummary( std::ostream& rcStrm ) const;
+  // consumer thread: write the history as Chrome trace JSON (chrome://tracing, Perfetto);
+  // returns 0 on success, -1 if the file cannot be written
+  int writeChromeTrace( const std::string& rcFName ) const;
+
+
+protected:
+  Profiler( const Profiler& );
+  Profiler& operator=( const Profiler& );
+
+  struct Scope
+  {
+    std::string   cName;
+    bool          bGpu;
+  };
+
+  // scope of a frame whose GPU result is not read back yet
+  struct PendingScope
+  {
+    ProfileSample cSample;
+    GLuint        uiQuery;      // 0 = no GPU timer
+  };
+
+  struct OpenScope
+  {
+    unsigned int  uiScope;
+    int64_t       iStartNs;
+    GLuint        uiQuery;
+  };
+
+  struct FrameSlot
+  {
+    std::vector<PendingScope> cPending;
+    std::vector<GLuint>       cQueries;   // pool, grows to the number of GPU scopes per frame
+    size_t                    uiNumUsed;
+  };
+
+  int64_t now() const;
+  void resolve( FrameSlot& rcSlot );
+  void publish( const ProfileSample& rcSample );
+
+  std::vector<Scope>        m_cScopes;
+  bool                      m_bEnabled;
+  bool                      m_bInFrame;
+  uint32_t                  m_uiFrame;
+  int64_t                   m_iEpoch;
+  int64_t                   m_iFrameStartNs;
+
+  FrameSlot                 m_acSlots[FRAMES_IN_FLIGHT];
+  std::vector<OpenScope>    m_cOpen;
+  bool                      m_bGpuActive;
+
+  SpscRing<ProfileSample>   m_cRing;
+  std::atomic<unsigned int> m_uiNumDropped;
+  std::deque<ProfileSample> m_cHistory;
+  unsigned int              m_uiHistoryFrames;
+};
+
+
+
+// CPU + GPU timer for the lifetime of the object
+class ProfileScope
+{
+public:
+  ProfileScope( Profiler& rcProfiler, unsigned int uiScope ) : m_rcProfiler( rcProfiler ), m_uiScope( uiScope ) { m_rcProfiler.begin( m_uiScope ); }
+  ~ProfileScope() { m_rcProfiler.end( m_uiScope ); }
+
+private:
+  ProfileScope( const ProfileScope& );
+  ProfileScope& operator=( const ProfileScope& );
+
+  Profiler&     m_rcProfiler;
+  unsigned int  m_uiScope;
+};
+
+
+
+#endif
@@ -0,0 +1,88 @@
+#ifndef RENDERQUEUE_H
+#define RENDERQUEUE_H
+
+
+#include "glad/glad.h"
+
+#include "GLRender/GLRenderDecl.h"
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+
+
+// a single draw submitted to the render queue
+struct GLRENDER_DECL DrawItem
+{
+  DrawItem();
+
+  // coarse ordering, lower layers are drawn first (e.g. background before scene)
+  unsigned int  uiLayer;
+  // distance to the camera, used to sort front to back within the same state
+  float         fDepth;
+
+  GLuint        uiProgram;
+  GLuint        uiTexture;      // bound to GL_TEXTURE0, 0 = no texture
+  GLuint        uiVAO;
+  bool          bDepthTest;
+  GLenum        eDepthFunc;     // GL_LESS, GL_LEQUAL for geometry at the far plane
+  bool          bDepthWrite;
+
+  GLenum        eMode;          // primitive type
+  GLsizei       iCount;         // number of indices / vertices
+  GLenum        eIndexType;     // GL_UNSIGNED_INT, ... or 0 for glDrawArrays
+  GLsizei       iInstances;     // > 1 for instanced draws
+
+  // set the per draw uniforms, called with the program of the item bound
+  std::function<void()> fnUniforms;
+
+  // sort key, set by RenderQueue::submit
+  uint64_t      uiKey;
+};
+
+
+
+// statistics of the last execute
+struct GLRENDER_DECL RenderQueueStats
+{
+  unsigned int uiItems;
+  unsigned int uiDrawCalls;
+  unsigned int uiStateChanges;       // program, texture, VAO and depth state changes issued
+  unsigned int uiSavedStateChanges;  // redundant changes skipped
+};
+
+
+
+// collects draw items of a frame, sorts them by program, texture, VAO and depth
+// and executes them with as few state changes as possible
+class GLRENDER_DECL RenderQueue
+{
+public:
+  RenderQueue();
+
+  // add an item for the current frame
+  void submit( const DrawItem& rcItem );
+
+  // sort and draw all items, then clear the queue
+  void execute();
+
+  // drop all items without drawing
+  void clear() { m_cItems.clear(); }
+
+  size_t getNumItems() const { return m_cItems.size(); }
+  const RenderQueueStats& getStats() const { return m_cStats; }
+
+
+protected:
+  static uint64_t computeKey( const DrawItem& rcItem );
+
+  std::vector<DrawItem>   m_cItems;
+  std::vector<uint32_t>   m_cOrder;
+
+  RenderQueueStats        m_cStats;
+};
+
+
+
+#endif
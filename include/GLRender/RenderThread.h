@@ -0,0 +1,68 @@
+#ifndef RENDERTHREAD_H
+#define RENDERTHREAD_H
+
+
+#include "GLRender/GLRenderDecl.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+
+
+// thread that owns the GL context and replays the frames recorded on the main thread, so
+// that input handling and game logic never wait on the driver; the main thread records
+// frame n + 1 while frame n is drawn
+//
+// At most MAX_PENDING frames wait for the render thread, submit blocks beyond that; the
+// recorder therefore needs MAX_PENDING + 2 sets of command lists (one being drawn, the
+// pending ones and the one being recorded).
+class GLRENDER_DECL RenderThread
+{
+public:
+  static const unsigned int MAX_PENDING = 1;
+
+  RenderThread();
+  ~RenderThread();
+
+  RenderThread( const RenderThread& ) = delete;
+  RenderThread& operator=( const RenderThread& ) = delete;
+
+  // start the thread; fnAttach makes the GL context current on it (the caller has to release
+  // it before), fnDetach releases it again when the thread stops
+  void start( const std::function<void()>& fnAttach, const std::function<void()>& fnDetach );
+  // draw all frames that were submitted, then stop the thread
+  void stop();
+  bool isRunning() const { return m_cThread.joinable(); }
+
+  // queue a frame (or any other GL work); without a running thread it is run right away
+  void submit( const std::function<void()>& fnFrame );
+  // wait until everything submitted has run, e.g. before reading state of the GL thread
+  void finish();
+
+  // statistics: frames run on the thread and the time submit waited for a free slot
+  uint64_t getNumFrames() const;
+  double   getWaitMs() const;
+
+
+protected:
+  void threadLoop( std::function<void()> fnAttach, std::function<void()> fnDetach );
+
+  mutable std::mutex                  m_cMutex;
+  std::condition_variable             m_cWakeUp;     // new frame or stop, for the render thread
+  std::condition_variable             m_cDone;       // a frame started or finished, for the main thread
+  std::deque<std::function<void()> >  m_cFrames;
+  std::thread                         m_cThread;
+  bool                                m_bStop;
+  bool                                m_bBusy;       // a frame is being drawn
+
+  uint64_t                            m_uiNumFrames;
+  double                              m_dWaitMs;
+};
+
+
+
+#endif
@@ -37,6 +37,15 @@ public:
   // use this program
   void useProgram();
 
+  // ask the driver to keep the linked binary retrievable, call before linkShaders()
+  void setBinaryRetrievable();
+
+  // get the binary of the linked program (needs GLEXT_program_binary)
+  int getBinary( GLenum& reFormat, std::vector<unsigned char>& rcBinary ) const;
+
+  // load a previously retrieved binary instead of compiling and linking shaders
+  int loadBinary( GLenum eFormat, const void* pvBinary, GLsizei iLength );
+
 
 protected:
 
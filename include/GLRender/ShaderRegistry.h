@@ -0,0 +1,73 @@
+#ifndef SHADERREGISTRY_H
+#define SHADERREGISTRY_H
+
+
+#include "GLRender/GLRenderDecl.h"
+
+#include "GLRender/ShaderProgram.h"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+
+
+
+typedef std::shared_ptr<ShaderProgram> ShaderHandle;
+
+
+
+// central place to create shader programs: programs with the same sources are shared
+// and linked programs are stored on disk as driver binaries, so that a warm start does
+// not need to compile any GLSL
+class GLRENDER_DECL ShaderRegistry
+{
+public:
+  // registry for the current GL context
+  static ShaderRegistry& get();
+
+  // directory for program binaries, an empty string disables the disk cache
+  void setCacheDirectory( const std::string& rcDir );
+
+  // get the program for a vertex and fragment shader file
+  ShaderHandle acquire( const std::string& rcVertexPath, const std::string& rcFragmentPath );
+
+  // get the program for vertex and fragment shader sources
+  ShaderHandle acquireSource( const std::string& rcVertexSrc, const std::string& rcFragmentSrc );
+
+  // contents of a shader file, an empty string if it cannot be read
+  static std::string readShaderFile( const std::string& rcPath );
+
+  // statistics
+  unsigned int getNumCompiled() const { return m_uiNumCompiled; }
+  unsigned int getNumBinaryLoads() const { return m_uiNumBinaryLoads; }
+  unsigned int getNumShared() const { return m_uiNumShared; }
+
+
+protected:
+  ShaderRegistry();
+
+  // hash of both sources, key of the registry and name of the cache file
+  static uint64_t hashSources( const std::string& rcVertexSrc, const std::string& rcFragmentSrc );
+
+  // hash of vendor, renderer and version string; binaries of other drivers are not loaded
+  uint64_t getDriverHash();
+
+  std::string getCacheFileName( uint64_t uiHash ) const;
+  ShaderHandle loadCachedBinary( uint64_t uiHash );
+  void storeCachedBinary( uint64_t uiHash, const ShaderProgram& rcProg );
+
+  // programs by source hash, not owned
+  std::map<uint64_t, std::weak_ptr<ShaderProgram> > m_cPrograms;
+
+  std::string   m_cCacheDir;
+  uint64_t      m_uiDriverHash;
+
+  unsigned int  m_uiNumCompiled;
+  unsigned int  m_uiNumBinaryLoads;
+  unsigned int  m_uiNumShared;
+};
+
+
+
+#endif
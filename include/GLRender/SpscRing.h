@@ -0,0 +1,66 @@
+#ifndef SPSCRING_H
+#define SPSCRING_H
+
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+
+
+// bounded lock-free ring for exactly one producer and one consumer thread; the capacity
+// is rounded up to a power of two, push fails instead of blocking when the ring is full
+template < class T >
+class SpscRing
+{
+public:
+  explicit SpscRing( size_t uiCapacity )
+    : m_uiHead( 0 )
+    , m_uiTail( 0 )
+  {
+    size_t uiSize = 1;
+    while( uiSize < uiCapacity ) uiSize <<= 1;
+    m_cData.resize( uiSize );
+    m_uiMask = uiSize - 1;
+  }
+
+  // producer side
+  bool push( const T& rcValue )
+  {
+    const size_t uiHead = m_uiHead.load( std::memory_order_relaxed );
+    if( uiHead - m_uiTail.load( std::memory_order_acquire ) > m_uiMask ) return false;
+
+    m_cData[uiHead & m_uiMask] = rcValue;
+    m_uiHead.store( uiHead + 1, std::memory_order_release );
+    return true;
+  }
+
+  // consumer side
+  bool pop( T& rcValue )
+  {
+    const size_t uiTail = m_uiTail.load( std::memory_order_relaxed );
+    if( uiTail == m_uiHead.load( std::memory_order_acquire ) ) return false;
+
+    rcValue = m_cData[uiTail & m_uiMask];
+    m_uiTail.store( uiTail + 1, std::memory_order_release );
+    return true;
+  }
+
+  size_t capacity() const { return m_uiMask + 1; }
+
+
+protected:
+  SpscRing( const SpscRing& );
+  SpscRing& operator=( const SpscRing& );
+
+  std::vector<T>  m_cData;
+  size_t          m_uiMask;
+
+  // on separate cache lines, written by different threads
+  alignas(64) std::atomic<size_t> m_uiHead;
+  alignas(64) std::atomic<size_t> m_uiTail;
+};
+
+
+
+#endif
@@ -0,0 +1,103 @@
+#ifndef STREAMBUFFER_H
+#define STREAMBUFFER_H
+
+
+#include "glad/glad.h"
+
+#include "GLRender/GLRenderDecl.h"
+
+#include <cstddef>
+
+
+
+// a range handed out by StreamBuffer::map
+struct GLRENDER_DECL StreamAllocation
+{
+  StreamAllocation() : iOffset( 0 ), uiSize( 0 ), uiFrame( 0 ), uiGeneration( ~0u ) {}
+
+  GLintptr      iOffset;        // offset in the buffer (for glVertexAttribPointer, glBindBufferRange, ...)
+  size_t        uiSize;
+  unsigned int  uiFrame;        // frame and generation of the buffer, see StreamBuffer::isValid
+  unsigned int  uiGeneration;
+};
+
+
+
+// ring buffer for data that is written by the CPU every frame (instance data, uniforms);
+// uploads never wait for the GPU to finish with earlier frames
+//
+// With GL 4.4 / ARB_buffer_storage the buffer is mapped persistently and split into
+// NUM_REGIONS regions, one per frame in flight; a fence per region guards the reuse. On
+// plain GL 3.3 ranges are mapped unsynchronized one after another and the storage is
+// orphaned when the end is reached. An orphan invalidates ranges that were not drawn from
+// yet, so allocate everything a draw needs with one call to map.
+class GLRENDER_DECL StreamBuffer
+{
+public:
+  static const unsigned int NUM_REGIONS = 3;
+
+  StreamBuffer();
+  ~StreamBuffer();
+
+  StreamBuffer( const StreamBuffer& ) = delete;
+  StreamBuffer& operator=( const StreamBuffer& ) = delete;
+
+  // create the buffer with uiFrameSize bytes per frame (grows on demand); with
+  // bPersistent = false orphaning is used even if persistent mapping is available
+  int create( GLenum eTarget, size_t uiFrameSize, bool bPersistent = true );
+  // free the buffer
+  void destroy();
+
+  // start a frame: wait until the GPU has finished with the region of this frame
+  void beginFrame();
+  // end a frame: fence the commands that read from this frame's region
+  void endFrame();
+
+  // reserve uiSize bytes at a multiple of uiAlignment and return a pointer for writing;
+  // the range can be used after unmap (NULL on error)
+  void* map( size_t uiSize, size_t uiAlignment, StreamAllocation* pcAllocation );
+  // finish writing the last mapped range (no-op for persistent mapping)
+  void unmap();
+
+  // true while the data of an allocation may still be drawn from: with persistent mapping
+  // only in the frame that wrote it, otherwise until the storage is orphaned or reallocated
+  bool isValid( const StreamAllocation& rcAllocation ) const;
+
+  GLuint getBuffer() const { return m_uiBuffer; }
+  GLenum getTarget() const { return m_eTarget; }
+  bool   isPersistent() const { return m_bPersistent; }
+
+  // statistics: bytes handed out, number of frames that had to wait on a fence, orphans,
+  // reallocations because a range did not fit
+  size_t       getBytesMapped() const { return m_uiBytesMapped; }
+  unsigned int getNumWaits() const { return m_uiNumWaits; }
+  unsigned int getNumOrphans() const { return m_uiNumOrphans; }
+  unsigned int getNumGrows() const { return m_uiNumGrows; }
+
+
+protected:
+  // (re)create the storage with uiRegionSize bytes per region
+  int allocate( size_t uiRegionSize );
+
+  GLenum        m_eTarget;
+  GLuint        m_uiBuffer;
+  bool          m_bPersistent;
+  bool          m_bMapped;
+
+  size_t        m_uiRegionSize;
+  size_t        m_uiHead;               // next free byte (in the region for persistent, in the buffer otherwise)
+  unsigned char* m_pucPersistent;       // persistent mapping of the whole buffer
+  GLsync        m_apcFences[NUM_REGIONS];
+
+  unsigned int  m_uiFrame;
+  unsigned int  m_uiGeneration;
+
+  size_t        m_uiBytesMapped;
+  unsigned int  m_uiNumWaits;
+  unsigned int  m_uiNumOrphans;
+  unsigned int  m_uiNumGrows;
+};
+
+
+
+#endif
@@ -0,0 +1,96 @@
+#ifndef TEXTURECONTAINER_H
+#define TEXTURECONTAINER_H
+
+
+#include "glad/glad.h"
+
+#include "GLRender/GLRenderDecl.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+
+
+// one encoding of a baked texture with its complete mip chain, used to write containers
+struct GLRENDER_DECL TextureContainerImage
+{
+  unsigned int                              uiFormat;   // TextureContainer::Format
+  std::vector<std::vector<unsigned char> >  cLevels;    // level 0 first
+};
+
+
+
+// baked texture file (.btex): a texture with its full mip chain in one or more encodings,
+// typically block compressed plus uncompressed as fallback, written by the asset baker
+//
+// The file is memory mapped and the levels are handed to GL straight from the mapping,
+// there is no decoding or mip generation at load time. Layout (little endian):
+//   header   magic "MADNTEX1", width, height, number of levels, number of images (uint32)
+//   images   format and reserved (uint32) per image
+//   levels   offset and size (uint64) per image and level
+//   data     the levels, each aligned to DATA_ALIGNMENT bytes
+class GLRENDER_DECL TextureContainer
+{
+public:
+  enum Format
+  {
+    FORMAT_RGBA8 = 1,
+    FORMAT_R8    = 2,
+    FORMAT_BC1   = 3,   // S3TC / DXT1, needs EXT_texture_compression_s3tc
+    FORMAT_BC4   = 4    // RGTC1, core since GL 3.0
+  };
+
+  static const size_t DATA_ALIGNMENT = 16;
+
+  TextureContainer();
+  ~TextureContainer();
+
+  TextureContainer( const TextureContainer& ) = delete;
+  TextureContainer& operator=( const TextureContainer& ) = delete;
+
+  // map and validate a file
+  int  open( const std::string& rcPath );
+  void close();
+  bool isOpen() const { return m_pucData != NULL; }
+  // touch every page of the mapping, so that a later upload does not wait for the disk
+  // (called on a loader thread)
+  void prefetch() const;
+
+  unsigned int getWidth() const { return m_uiWidth; }
+  unsigned int getHeight() const { return m_uiHeight; }
+  unsigned int getNumLevels() const { return m_uiNumLevels; }
+  unsigned int getNumImages() const { return m_uiNumImages; }
+  Format getFormat( unsigned int uiImage ) const;
+  // data of one level inside the mapping
+  const unsigned char* getLevelData( unsigned int uiImage, unsigned int uiLevel, size_t* puiSize ) const;
+
+  // first image whose format the current context can sample (-1 if none)
+  int selectImage() const;
+  // create a GL_TEXTURE_2D with all levels of the selected image (0 on error); wrap modes
+  // are left to the caller
+  GLuint upload( Format* peFormat = NULL ) const;
+
+  // write a container, all images must have the same number of levels
+  static int write( const std::string& rcPath, unsigned int uiWidth, unsigned int uiHeight,
+                    const std::vector<TextureContainerImage>& rcImages );
+
+  // expected size of a level, 0 for an unknown format
+  static size_t getLevelSize( Format eFormat, unsigned int uiWidth, unsigned int uiHeight );
+  static const char* getFormatName( Format eFormat );
+
+
+protected:
+  const unsigned char*  m_pucData;      // whole file
+  size_t                m_uiSize;
+  void*                 m_pvMapping;    // file mapping handle (Windows)
+
+  unsigned int          m_uiWidth;
+  unsigned int          m_uiHeight;
+  unsigned int          m_uiNumLevels;
+  unsigned int          m_uiNumImages;
+};
+
+
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef TEXTUREENCODER_H
+#define TEXTUREENCODER_H
+
+
+#include "GLRender/GLRenderDecl.h"
+
+#include <cstddef>
+#include <vector>
+
+
+
+// offline texture processing for the asset baker: mip chains and block compression of
+// 8 bit images with 1 or 4 channels (tightly packed rows in upload order)
+class GLRENDER_DECL TextureEncoder
+{
+public:
+  // bytes of one 4x4 block
+  static const unsigned int BC1_BLOCK_SIZE = 8;
+  static const unsigned int BC4_BLOCK_SIZE = 8;
+
+  // next smaller mip level (2x2 box filter like glGenerateMipmap, odd sizes repeat the
+  // last row / column)
+  static void downsample( const std::vector<unsigned char>& rcSrc, unsigned int uiWidth, unsigned int uiHeight,
+                          unsigned int uiChannels, std::vector<unsigned char>& rcDst );
+
+  // BC1 / DXT1 without alpha from an RGBA image (alpha is ignored); returns the root mean
+  // square error per channel
+  static float encodeBC1( const std::vector<unsigned char>& rcRGBA, unsigned int uiWidth, unsigned int uiHeight,
+                          std::vector<unsigned char>& rcBlocks );
+
+  // BC4 / RGTC1 from a single channel image; returns the root mean square error
+  static float encodeBC4( const std::vector<unsigned char>& rcRed, unsigned int uiWidth, unsigned int uiHeight,
+                          std::vector<unsigned char>& rcBlocks );
+
+  // size of a block compressed level
+  static size_t getBlockDataSize( unsigned int uiWidth, unsigned int uiHeight, unsigned int uiBlockSize )
+  {
+    return (size_t)( ( uiWidth + 3 ) / 4 ) * ( ( uiHeight + 3 ) / 4 ) * uiBlockSize;
+  }
+};
+
+
+
+#endif
@@ -0,0 +1,97 @@
+#ifndef TEXTURELOADER_H
+#define TEXTURELOADER_H
+
+
+#include "glad/glad.h"
+
+#include "GLRender/GLRenderDecl.h"
+#include "GLRender/TextureContainer.h"
+
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+
+// a texture read on a worker thread, ready to be uploaded on the GL thread: either a baked
+// container (mapped, pages already faulted in) or decoded pixels
+struct GLRENDER_DECL TextureImage
+{
+  TextureImage() : uiWidth( 0 ), uiHeight( 0 ), uiChannels( 0 ) {}
+
+  std::string                         cPath;        // file that was read
+  std::shared_ptr<TextureContainer>   pcContainer;  // baked mip chain, NULL if decoded
+  std::vector<unsigned char>          cPixels;      // decoded pixels, tightly packed
+  unsigned int                        uiWidth;
+  unsigned int                        uiHeight;
+  unsigned int                        uiChannels;   // 1 .. 4
+
+  bool isValid() const { return pcContainer || !cPixels.empty(); }
+
+  // create a GL_TEXTURE_2D with a full mip chain (0 on error); must run on the GL thread,
+  // wrap modes are left to the caller
+  GLuint upload() const;
+};
+
+
+
+// decodes textures on a pool of worker threads, so that the GL thread does not block on
+// file IO and JPEG decoding; the GL thread polls the returned futures and uploads each
+// image when it is ready
+class GLRENDER_DECL TextureLoader
+{
+public:
+  enum Flags
+  {
+    FLIP_VERTICALLY   = 1,  // first row at the bottom (only for decoded images, baked ones are flipped by the baker)
+    IGNORE_BAKED      = 2,  // always decode, even if a .btex container exists next to the file
+    PREMULTIPLY_ALPHA = 4   // multiply the colors of decoded RGBA images by their alpha
+  };
+
+  // loader shared by all textures
+  static TextureLoader& get();
+  ~TextureLoader();
+
+  // number of worker threads, takes effect before the first load (0 = from the number of cores)
+  void setNumThreads( unsigned int uiNumThreads );
+
+  // queue a load; uiChannels forces a channel count (0 = as stored in the file); the baked
+  // container next to the file (same name, .btex) is preferred unless IGNORE_BAKED is set
+  std::future<TextureImage> load( const std::string& rcPath, unsigned int uiChannels = 0, unsigned int uiFlags = 0 );
+
+  // read a texture on the calling thread
+  static TextureImage read( const std::string& rcPath, unsigned int uiChannels, unsigned int uiFlags );
+
+  // 1x1 texture in one color, shown until the real texture is uploaded
+  static GLuint createPlaceholder( unsigned char ucRed, unsigned char ucGreen, unsigned char ucBlue, unsigned char ucAlpha = 255 );
+
+  // true if a future returned by load has its result
+  static bool isReady( const std::future<TextureImage>& rcFuture );
+
+  // stop the workers; loads that did not start yet are dropped (their futures report a broken promise)
+  void shutdown();
+
+
+protected:
+  TextureLoader();
+  TextureLoader( const TextureLoader& ) = delete;
+  TextureLoader& operator=( const TextureLoader& ) = delete;
+
+  void workerLoop();
+
+  std::mutex                                      m_cMutex;
+  std::condition_variable                         m_cWakeUp;
+  std::deque<std::packaged_task<TextureImage()> > m_cTasks;
+  std::vector<std::thread>                        m_cThreads;
+  unsigned int                                    m_uiNumThreads;
+  bool                                            m_bStop;
+};
+
+
+
+#endif
@@ -0,0 +1,150 @@
+#ifndef TEXTUREMANAGER_H
+#define TEXTUREMANAGER_H
+
+
+#include "glad/glad.h"
+
+#include "GLRender/GLRenderDecl.h"
+#include "GLRender/TextureLoader.h"
+
+#include <cstddef>
+#include <future>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+
+
+
+class TextureManager;
+
+
+
+// file and parameters a texture is loaded with, also used as key of the manager
+struct GLRENDER_DECL TextureDesc
+{
+  TextureDesc() : uiChannels( 0 ), uiFlags( 0 ), eWrap( GL_CLAMP_TO_EDGE ) {}
+  TextureDesc( const std::string& rcPath, unsigned int uiChannels_ = 0, unsigned int uiFlags_ = 0, GLenum eWrap_ = GL_CLAMP_TO_EDGE )
+    : cPath( rcPath ), uiChannels( uiChannels_ ), uiFlags( uiFlags_ ), eWrap( eWrap_ ) {}
+
+  std::string   cPath;
+  // forced channel count (0 = as stored in the file), see TextureLoader::load
+  unsigned int  uiChannels;
+  // TextureLoader::Flags
+  unsigned int  uiFlags;
+  // GL_TEXTURE_WRAP_S and GL_TEXTURE_WRAP_T
+  GLenum        eWrap;
+
+  // strict weak ordering for the manager map
+  bool operator<( const TextureDesc& rcOther ) const;
+};
+
+
+
+// GL texture owned by the manager; shows a 1x1 placeholder until the loader has finished
+class GLRENDER_DECL Texture
+{
+public:
+  ~Texture();
+
+  Texture( const Texture& ) = delete;
+  Texture& operator=( const Texture& ) = delete;
+
+  // GL name for drawing; marks the texture as used in the current frame (LRU for the budget)
+  GLuint use();
+  // GL name without touching the LRU state
+  GLuint getID() const { return m_uiTexture; }
+
+  const TextureDesc& getDesc() const { return m_cDesc; }
+  bool isLoaded() const { return !m_cPending.valid(); }
+  // size of level 0 and number of levels currently on the GPU
+  unsigned int getWidth() const { return m_uiWidth; }
+  unsigned int getHeight() const { return m_uiHeight; }
+  unsigned int getNumLevels() const { return m_uiNumLevels; }
+  // number of top levels dropped to stay in the budget
+  unsigned int getNumDroppedLevels() const { return m_uiDroppedLevels; }
+  // GPU memory of all levels
+  size_t getGPUBytes() const { return m_uiBytes; }
+
+
+protected:
+  friend class TextureManager;
+
+  Texture( TextureManager* pcManager, const TextureDesc& rcDesc );
+
+  // upload the loaded image in place of the placeholder (false if it cannot be uploaded)
+  bool finishLoad( bool bWait );
+  // replace the texture by one without the top uiNumLevels levels (read back from the GPU)
+  bool dropLevels( unsigned int uiNumLevels );
+  // size, levels and bytes of the bound texture
+  void updateInfo();
+
+  TextureManager*           m_pcManager;
+  TextureDesc               m_cDesc;
+  GLuint                    m_uiTexture;
+  std::future<TextureImage> m_cPending;
+
+  unsigned int              m_uiWidth;
+  unsigned int              m_uiHeight;
+  unsigned int              m_uiNumLevels;
+  unsigned int              m_uiDroppedLevels;
+  size_t                    m_uiBytes;
+  unsigned int              m_uiLastUsed;   // frame of the last use
+};
+
+typedef std::shared_ptr<Texture> TextureHandle;
+
+
+
+// loads every texture once and hands out ref-counted handles, a texture is freed when its
+// last handle is released; keeps the GPU memory of all textures below a budget by dropping
+// the top mip levels of the least recently used textures
+class GLRENDER_DECL TextureManager
+{
+public:
+  // smallest level 0 the budget reduces a texture to
+  static const unsigned int MIN_EXTENT = 64;
+
+  // manager for the current GL context
+  static TextureManager& get();
+
+  // get the texture for the given file and parameters, start loading it if it does not
+  // exist yet; the placeholder color is shown until it is uploaded
+  TextureHandle acquire( const TextureDesc& rcDesc, unsigned char ucRed = 128, unsigned char ucGreen = 128, unsigned char ucBlue = 128 );
+
+  // once per frame on the GL thread: upload loaded textures (bWait = wait for all of
+  // them) and enforce the budget
+  void update( bool bWait = false );
+
+  // GPU memory budget in bytes, 0 = unlimited
+  void   setBudget( size_t uiBytes ) { m_uiBudget = uiBytes; }
+  size_t getBudget() const { return m_uiBudget; }
+
+  // statistics of the textures currently alive
+  size_t getNumTextures() const;
+  size_t getGPUBytes() const;
+  unsigned int getNumDroppedLevels() const { return m_uiNumDroppedLevels; }
+  unsigned int getNumShared() const { return m_uiNumShared; }
+  void printStats( std::ostream& rcStream ) const;
+
+  unsigned int getFrame() const { return m_uiFrame; }
+
+
+protected:
+  TextureManager() : m_uiBudget( 0 ), m_uiFrame( 0 ), m_uiNumDroppedLevels( 0 ), m_uiNumShared( 0 ) {}
+
+  // drop levels of the least recently used textures until the budget is met
+  void enforceBudget();
+
+  // textures by file and parameters, not owned
+  std::map<TextureDesc, std::weak_ptr<Texture> > m_cTextures;
+
+  size_t        m_uiBudget;
+  unsigned int  m_uiFrame;
+  unsigned int  m_uiNumDroppedLevels;
+  unsigned int  m_uiNumShared;
+};
+
+
+
+#endif
@@ -0,0 +1,133 @@
+#ifndef TWEENSYSTEM_H
+#define TWEENSYSTEM_H
+
+
+#include "GLRender/GLRenderDecl.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+
+// many concurrent position animations through keyframes, advanced in fixed steps
+//
+// Each animation moves from its start through a list of keyframes; a segment is a straight
+// line plus an optional parabolic arc along z (a hop). The state of the current segment of
+// all animations is kept in structure of arrays layout, so that update() evaluates four
+// animations per SSE instruction; only when a segment ends (once per hop) the next keyframe
+// is loaded by scalar code. Arrays are padded to a multiple of four.
+//
+// Animations are identified by a user id (e.g. the index of the animated object); starting
+// an animation for an id that is still animated replaces it. Ended animations leave a hole
+// (user NO_USER) that the next start() fills; holes are only compacted when they exceed a
+// quarter of the slots, so a steady flow of moves never shuffles the arrays.
+class GLRENDER_DECL TweenSystem
+{
+public:
+  struct Keyframe
+  {
+    float afPos[3];     // position at the end of the segment
+    float fDuration;    // seconds from the previous keyframe; 0 jumps there
+    float fArc;         // height of the arc above the straight line along z; 0 slides
+  };
+
+  // animation that ended, with its final position
+  struct Retired
+  {
+    uint32_t uiUser;
+    float    afPos[3];
+  };
+
+  static const uint32_t NO_USER = ~0u;
+
+  TweenSystem();
+
+  // start an animation at pfStart through uiNumKeys keyframes
+  void start( uint32_t uiUser, const float* pfStart, const Keyframe* pcKeys, size_t uiNumKeys );
+  // continue a running animation through more keyframes after its last one; false if the
+  // user is not animated
+  bool append( uint32_t uiUser, const Keyframe* pcKeys, size_t uiNumKeys );
+  // drop an animation without retiring it
+  void stop( uint32_t uiUser );
+  void clear();
+
+  bool isActive( uint32_t uiUser ) const { return uiUser < m_cSlotOfUser.size() && m_cSlotOfUser[uiUser] != NO_USER; }
+  // position at the last step; false if the user is not animated
+  bool getPosition( uint32_t uiUser, float* pfPos ) const;
+  // seconds until the animation reaches its last keyframe, 0 if the user is not animated
+  float getRemaining( uint32_t uiUser ) const;
+
+  // advance all animations by fDt seconds; animations that ended in the previous step are
+  // removed first and listed in getRetired()
+  void update( float fDt );
+  // positions between the last two steps (fAlpha 0: previous step, 1: last step) into the
+  // draw arrays
+  void interpolate( float fAlpha );
+
+  // slots including holes; getUsers() is NO_USER for holes
+  size_t size() const { return m_uiSize; }
+  size_t getNumActive() const { return m_uiSize - m_cFreeSlots.size(); }
+  const uint32_t* getUsers() const { return m_cUsers.data(); }
+  const float*    getX() const { return m_acChannels[CH_X].data(); }
+  const float*    getY() const { return m_acChannels[CH_Y].data(); }
+  const float*    getZ() const { return m_acChannels[CH_Z].data(); }
+  const float*    getDrawX() const { return m_acChannels[CH_DRAW_X].data(); }
+  const float*    getDrawY() const { return m_acChannels[CH_DRAW_Y].data(); }
+  const float*    getDrawZ() const { return m_acChannels[CH_DRAW_Z].data(); }
+  // animations removed in the last update(), with the final position they were left at
+  const std::vector<Retired>& getRetired() const { return m_cRetired; }
+
+  // use the SSE kernels (default where available); off for comparisons and benchmarks
+  void setSimd( bool bSimd ) { m_bSimd = bSimd && hasSimd(); }
+  bool getSimd() const { return m_bSimd; }
+  static bool hasSimd();
+
+
+protected:
+  enum Channel
+  {
+    CH_TIME,            // seconds into the current segment
+    CH_INV_DURATION,    // 0 for ended animations and padding
+    CH_START_X, CH_START_Y, CH_START_Z,
+    CH_END_X, CH_END_Y, CH_END_Z,
+    CH_ARC,
+    CH_X, CH_Y, CH_Z,                 // last step
+    CH_PREV_X, CH_PREV_Y, CH_PREV_Z,  // step before
+    CH_DRAW_X, CH_DRAW_Y, CH_DRAW_Z,  // interpolated
+    NUM_CHANNELS
+  };
+
+  uint32_t addSlot( uint32_t uiUser );
+  void     freeSlot( uint32_t uiSlot );
+  void     moveSlot( uint32_t uiFrom, uint32_t uiTo );
+  void     compactSlots();
+  // load keyframes until the time lies inside the current segment, or end the animation
+  void     advanceSegment( uint32_t uiSlot );
+  void     evaluate( uint32_t uiSlot );
+
+  void     updateScalar( float fDt );
+  void     interpolateScalar( float fAlpha );
+  void     updateSimd( float fDt );
+  void     interpolateSimd( float fAlpha );
+
+  std::vector<float>          m_acChannels[NUM_CHANNELS];
+  size_t                      m_uiSize;
+
+  // per slot, only touched when a segment ends
+  std::vector<float>          m_cDuration;
+  std::vector<uint32_t>       m_cUsers;
+  std::vector<std::vector<Keyframe> > m_cKeys;  // kept when a hole is reused, so moves do not allocate
+  std::vector<uint32_t>       m_cKeyNext;     // next keyframe to load
+  std::vector<unsigned char>  m_cEnded;
+
+  std::vector<uint32_t>       m_cSlotOfUser;
+  std::vector<uint32_t>       m_cFreeSlots;   // holes left by ended or stopped animations
+  std::vector<uint32_t>       m_cEndedSlots;  // animations that reached their last keyframe
+  std::vector<Retired>        m_cRetired;
+  bool                        m_bSimd;
+};
+
+
+
+#endif
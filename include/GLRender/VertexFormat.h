@@ -0,0 +1,99 @@
+#ifndef VERTEXFORMAT_H
+#define VERTEXFORMAT_H
+
+
+#include "glad/glad.h"
+
+#include "GLRender/GLRenderDecl.h"
+
+#include <vector>
+
+
+
+// maps the stored positions back to object space: p = stored * afScale + afOffset
+struct GLRENDER_DECL VertexQuantization
+{
+  float afScale[3];
+  float afOffset[3];
+
+  // no quantization (float positions)
+  static VertexQuantization identity();
+
+  // as column major 4x4 matrix, to be multiplied into the model matrix
+  void getMatrix( float* pfMat4 ) const;
+};
+
+
+
+// layout of one vertex in a vertex buffer; each mesh declares only the attributes it needs
+// and the glVertexAttribPointer setup is derived from the declaration
+class GLRENDER_DECL VertexFormat
+{
+public:
+  // fixed attribute locations used by all shaders (locations 2-6 are taken by instance data)
+  static const GLuint LOCATION_POSITION = 0;
+  static const GLuint LOCATION_TEXCOORD = 1;
+  static const GLuint LOCATION_NORMAL   = 7;
+
+  enum PositionEncoding
+  {
+    POSITION_FLOAT3,    // 12 bytes
+    POSITION_INT16      // 8 bytes, 16 bit integers within the bounding box of the mesh, see VertexQuantization
+  };
+
+  enum TexCoordEncoding
+  {
+    TEXCOORD_NONE,
+    TEXCOORD_FLOAT2,    // 8 bytes
+    TEXCOORD_HALF2,     // 4 bytes, half floats (any range)
+    TEXCOORD_UNORM16    // 4 bytes, normalized to [0, 1] (coordinates outside are clamped)
+  };
+
+  enum NormalEncoding
+  {
+    NORMAL_NONE,
+    NORMAL_FLOAT3,      // 12 bytes
+    NORMAL_OCT16        // 4 bytes, octahedral mapping as two normalized shorts; decode in the shader:
+                        //   n = vec3( e, 1 - |e.x| - |e.y| ); if( n.z < 0 ) n.xy = ( 1 - |n.yx| ) * sign( n.xy );
+  };
+
+  VertexFormat( PositionEncoding ePosition = POSITION_FLOAT3, TexCoordEncoding eTexCoord = TEXCOORD_FLOAT2,
+                NormalEncoding eNormal = NORMAL_NONE );
+
+  PositionEncoding getPositionEncoding() const { return m_ePosition; }
+  TexCoordEncoding getTexCoordEncoding() const { return m_eTexCoord; }
+  NormalEncoding   getNormalEncoding() const { return m_eNormal; }
+  bool             hasTexCoords() const { return m_eTexCoord != TEXCOORD_NONE; }
+  bool             hasNormals() const { return m_eNormal != NORMAL_NONE; }
+
+  // size of one vertex in bytes
+  GLsizei getStride() const { return m_iStride; }
+
+  // set up the attributes for the currently bound VAO from the currently bound array buffer
+  void setupAttribs() const;
+
+  // convert interleaved float vertices (iSrcStride floats each, position at offset 0, texture
+  // coordinate and normal at the given offsets or -1 if not present) into this format;
+  // pcQuantization receives the mapping of the stored positions back to object space
+  void encode( const std::vector<float>& rcSource, int iSrcStride, int iTexCoordOffset, int iNormalOffset,
+               std::vector<unsigned char>& rcOut, VertexQuantization* pcQuantization = 0 ) const;
+
+  // conversion helpers
+  static unsigned short floatToHalf( float fValue );
+  static void encodeOctahedral( const float* pfNormal, short* psOut );
+  static void decodeOctahedral( const short* psIn, float* pfNormal );
+
+
+protected:
+  PositionEncoding m_ePosition;
+  TexCoordEncoding m_eTexCoord;
+  NormalEncoding   m_eNormal;
+
+  GLsizei m_iStride;
+  GLsizei m_iTexCoordOffset;
+  GLsizei m_iNormalOffset;
+};
+
+
+
+#endif
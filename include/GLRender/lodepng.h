@@ -271,6 +271,11 @@ struct LodePNGDecompressSettings
                              const LodePNGDecompressSettings*);
 
   const void* custom_context; /*optional custom settings for custom functions*/
+
+  /*decode the huffman codes with multi-bit lookup tables and a 64-bit bit buffer instead of
+  walking the huffman tree one bit at a time (default: 1). Both give the same result, 0 selects
+  the original decoder*/
+  unsigned fast_inflate;
 };
 
 extern const LodePNGDecompressSettings lodepng_default_decompress_settings;
@@ -0,0 +1,42 @@
+#ifndef HEADLESSCONTEXT_H
+#define HEADLESSCONTEXT_H
+
+#include <glad/glad.h>
+
+struct GLFWwindow;
+
+// OpenGL-Kontext ohne sichtbares Fenster für Benchmarks und Server ohne Display.
+// Bevorzugt wird ein EGL-Kontext ohne Surface (z. B. Mesa llvmpipe auf CI-Maschinen),
+// ohne EGL-Unterstützung wird ein verstecktes GLFW-Fenster verwendet. Gerendert wird in
+// beiden Fällen in einen Framebuffer, es wird nie etwas präsentiert.
+class HeadlessContext
+{
+public:
+    HeadlessContext();
+    ~HeadlessContext();
+
+    // Erzeugt einen GL-3.3-Core-Kontext und macht ihn aktuell
+    bool create(int width, int height);
+    void destroy();
+
+    // Kontext auf dem aufrufenden Thread aktuell machen bzw. freigeben (Übergabe an einen
+    // Render-Thread: erst auf dem alten Thread freigeben, dann auf dem neuen aktuell machen)
+    bool makeCurrent();
+    void releaseCurrent();
+
+    // Loader für gladLoadGLLoader / loadGLExtensions
+    GLADloadproc getProcAddress() const;
+    // "EGL" oder "GLFW" (für Ausgaben)
+    const char* getBackendName() const;
+
+private:
+    bool createEGL();
+    bool createGLFW(int width, int height);
+
+    void* eglDisplay;        // EGLDisplay, nur mit MADN_HAVE_EGL
+    void* eglContext;        // EGLContext
+    GLFWwindow* window;      // verstecktes Fenster (Fallback)
+    bool glfwInitialized;
+};
+
+#endif
@@ -0,0 +1,85 @@
+#ifndef PICKER_H
+#define PICKER_H
+
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "Board.h"
+#include "Figur.h"
+#include "SceneGraph.h"
+#include "GLRender/BVH.h"
+#include "GLRender/MeshLibrary.h"
+
+// Ergebnis einer Auswahl mit der Maus
+struct PickResult
+{
+    enum Type
+    {
+        NONE,
+        PIECE,
+        FIELD
+    };
+
+    Type type = NONE;
+    int piece = -1;         // Index der Figur in der Szene
+    int board = -1;         // Brett der Figur bzw. des Feldes
+    int field = -1;         // Feldnummer (BoardLayout)
+    float distance = 0.0f;  // entlang des Strahls
+    glm::vec3 point = glm::vec3(0.0f);  // Treffpunkt in Weltkoordinaten
+};
+
+// Auswahl von Figuren und Feldern mit einem Strahl, ganz auf der CPU (kein glReadPixels, das
+// auf die GPU warten müsste): ein BVH über die Boxen aller Figuren und Felder, genau getestet
+// wird gegen die gedrehte Box einer Figur bzw. die Kreisscheibe eines Feldes. Bewegen sich
+// Figuren oder Bretter, werden nur ihre Boxen erneuert und die Knoten darüber angepasst.
+class Picker
+{
+public:
+    Picker();
+
+    // Baum über alle Figuren und die Felder aller Bretter aufbauen; die Weltmatrizen des
+    // Szenengraphs müssen aktuell sein (nach SceneGraph::update())
+    void build(const std::vector<Board*> &boards, const std::vector<Figur*> &figuren,
+               const SceneGraph &scene, const MeshBounds &pieceBounds);
+    bool isBuilt() const { return built; }
+
+    // Knoten mit geänderter Weltmatrix (Bereich aus dem letzten SceneGraph::update()); ihre
+    // Figuren und Felder werden vor der nächsten Auswahl erneuert
+    void invalidate(SceneGraph::NodeId first, SceneGraph::NodeId count);
+
+    // nächster Treffer entlang des Strahls (direction normiert)
+    PickResult pick(const glm::vec3 &origin, const glm::vec3 &direction, const SceneGraph &scene);
+
+    const BVH &getBVH() const { return bvh; }
+
+private:
+    struct Primitive
+    {
+        SceneGraph::NodeId node;  // Figur bzw. Brett des Feldes
+        int piece;                // -1 bei Feldern
+        int board;
+        int field;                // -1 bei Figuren
+
+        glm::mat4 toLocal;        // Figur: Welt- in Objektkoordinaten
+        glm::vec3 center;         // Feld: Mittelpunkt, Normale und Radius in Weltkoordinaten
+        glm::vec3 normal;
+        float radius;
+    };
+
+    // Box und Testdaten einer Primitive aus der Weltmatrix ihres Knotens
+    BVH::Box updatePrimitive(Primitive &primitive, const SceneGraph &scene) const;
+    // genauer Test, Abstand entlang des Strahls oder -1
+    float intersect(const Primitive &primitive, const glm::vec3 &origin, const glm::vec3 &direction) const;
+    // geänderte Knoten einarbeiten und den Baum anpassen
+    void refit(const SceneGraph &scene);
+
+    BVH bvh;
+    std::vector<Primitive> primitives;
+    std::vector<std::pair<SceneGraph::NodeId, unsigned int>> nodePrimitives;  // nach Knoten sortiert
+    MeshBounds pieceBounds;
+    bool built;
+
+    SceneGraph::NodeId pendingFirst, pendingEnd;  // geänderte Knoten seit der letzten Auswahl
+};
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef PIECEANIMATOR_H
+#define PIECEANIMATOR_H
+
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "Figur.h"
+#include "GLRender/TweenSystem.h"
+
+// Bewegt Figuren über das Brett: ein Zug springt Feld für Feld in kleinen Bögen, eine
+// geschlagene Figur fliegt in hohem Bogen zurück ins Haus. Alle laufenden Animationen liegen
+// im TweenSystem (Struktur aus Arrays, vier Figuren je SSE-Befehl), so dass auch zehntausende
+// gleichzeitige Züge (viele Partien nebeneinander) nur einen Bruchteil eines Frames kosten.
+//
+// Positionen sind Brettkoordinaten (lokal zum Brett der Figur); update() rechnet feste
+// Simulationsschritte, interpolate() setzt die Lage zwischen den letzten beiden Schritten.
+class PieceAnimator
+{
+public:
+    static const float HOP_DURATION;    // Sekunden je Feld
+    static const float HOP_HEIGHT;      // Höhe eines Sprungs über das Brett
+    static const float KNOCK_DURATION;  // Flug einer geschlagenen Figur ins Haus
+    static const float KNOCK_HEIGHT;
+
+    // Lokaler Transform einer Figur, die auf position steht
+    static glm::mat4 pieceTransform(const glm::vec3 &position);
+
+    // Figur piece springt nach delay Sekunden von from aus über die Felder path. Läuft noch
+    // eine Animation der Figur, wird der Zug hinten angehängt (from ist dann ihr Endpunkt).
+    // Liefert die Zeit ab jetzt bis zur Landung auf dem letzten Feld.
+    float hop(int piece, const glm::vec3 &from, const std::vector<glm::vec3> &path, float delay = 0.0f);
+    // Geschlagene Figur beendet eine laufende Animation, bleibt bis mindestens delay Sekunden
+    // ab jetzt auf from stehen (bis der Schlagende landet) und fliegt dann nach home
+    float knockBack(int piece, const glm::vec3 &from, const glm::vec3 &home, float delay);
+
+    bool isAnimating(int piece) const { return tweens.isActive((uint32_t)piece); }
+    // Lage einer laufenden Animation im letzten Simulationsschritt
+    glm::vec3 getPosition(int piece) const;
+    // Sekunden bis zum Ende der laufenden Animation, 0 ohne Animation
+    float getRemaining(int piece) const { return tweens.getRemaining((uint32_t)piece); }
+    size_t getNumActive() const { return tweens.getNumActive(); }
+
+    // Simulationsschritt; Figuren, deren Animation geendet hat, bleiben auf ihrem Ziel stehen
+    void update(float dt, const std::vector<Figur*> &figuren);
+    // Laufende Animationen zwischen den letzten beiden Schritten an die Figuren geben
+    void interpolate(float alpha, const std::vector<Figur*> &figuren);
+
+    TweenSystem &getTweens() { return tweens; }
+
+private:
+    // Schlüsselbilder starten oder an eine laufende Animation anhängen
+    void play(int piece, const glm::vec3 &from);
+
+    TweenSystem tweens;
+    std::vector<TweenSystem::Keyframe> keys;  // Schlüsselbilder des nächsten Zugs
+};
+
+#endif
@@ -0,0 +1,116 @@
+#ifndef PIECERENDERER_H
+#define PIECERENDERER_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <functional>
+#include <vector>
+
+#include "GLRender/Frustum.h"
+#include "GLRender/MeshLibrary.h"
+#include "GLRender/CommandList.h"
+#include "GLRender/ShaderRegistry.h"
+#include "GLRender/StreamBuffer.h"
+#include "SceneGraph.h"
+
+class Camera;
+class Figur;
+
+// Zeichnet alle Figuren gebündelt: Modellmatrix und Farbe liegen pro Instanz in einem
+// Instanz-Buffer, sodass alle Zylinder und alle Kugeln einer Detailstufe mit je einem
+// instanzierten Draw-Call gezeichnet werden.
+//
+// Die Detailstufe (LOD) jeder Figur richtet sich nach dem Durchmesser ihrer Bounding-Sphere
+// auf dem Bildschirm; damit Figuren an der Grenze nicht ständig wechseln, gibt es eine
+// Hysterese (siehe MeshLODChain).
+//
+// Die Instanzdaten werden in den Stream-Buffer der Szene geschrieben, die VAOs zeigen nach
+// jedem Upload auf den neuen Bereich. Berechnet werden sie beim Aufzeichnen (Hauptthread),
+// Upload und VAOs gehören dem Thread, der die Command-List abspielt.
+class PieceRenderer
+{
+public:
+    // Anzahl der Detailstufen (Stufe 0 = volle Auflösung)
+    static const int NUM_LODS = 4;
+
+    explicit PieceRenderer(StreamBuffer &streamBuffer);
+    ~PieceRenderer();
+
+    // Zeichnet alle Figuren mit ihren Weltmatrizen aus dem Szenengraph (nach scene.update()) als
+    // instanzierte Draw-Items je Detailstufe auf; Instanzdaten und Detailstufen werden nur
+    // neu berechnet (und hochgeladen), wenn sich Szenengraph oder Kamera geändert haben
+    void record(CommandList &commands, const std::vector<Figur*> &figuren, const SceneGraph &scene, const Camera &camera);
+
+    // Summe aller hochgeladenen Instanzdaten in Bytes (für Benchmarks, Render-Thread)
+    size_t getUploadedBytes() const { return uploadedBytes; }
+    // Anzahl Figuren, die im letzten Frame mit der Detailstufe level gezeichnet wurden
+    size_t getNumInstances(int level) const { return lods[level].instances.size(); }
+    // Anzahl Figuren, die im letzten Frame außerhalb des Sichtvolumens lagen
+    size_t getNumCulled() const { return numCulled; }
+    // Box und Kugel um Zylinder und Kopf einer Figur im Objektraum
+    const MeshBounds &getPieceBounds() const { return pieceBounds; }
+
+private:
+    // Daten pro Instanz (Layout muss zu shader/piece.vert passen)
+    struct InstanceData
+    {
+        glm::mat4 model;
+        glm::vec3 color;
+    };
+
+    // Meshes, VAOs und Instanzen einer Detailstufe
+    struct LodLevel
+    {
+        MeshHandle cylinder;
+        MeshHandle sphere;
+        unsigned int cylinderVAO;
+        unsigned int sphereVAO;
+        size_t offset;              // Instanzdaten im Stream-Buffer, von beiden VAOs genutzt (Render-Thread)
+        std::vector<InstanceData> instances;
+    };
+
+    // Ring-Buffer für die Instanzdaten (gehört der Szene)
+    StreamBuffer &stream;
+
+    // Render-Thread: Kopie der zuletzt aufgezeichneten Instanzen aller Stufen (hintereinander),
+    // aus der neu hochgeladen wird, wenn der Ring ihren Bereich wiederverwendet
+    StreamAllocation instanceAllocation;
+    std::vector<InstanceData> renderInstances;
+    size_t renderCounts[NUM_LODS];
+    std::vector<InstanceData> packedInstances;  // Hauptthread: Puffer zum Aufzeichnen
+
+    // Shaderprogramm für die instanzierten Figuren
+    ShaderHandle program;
+    int positionScaleLoc, positionOffsetLoc;  // Rückrechnung der 16-Bit-Positionen
+
+    // Detailstufen von Zylinder und Kugel aus der MeshLibrary
+    MeshLODChain cylinderChain;
+    MeshLODChain sphereChain;
+    MeshBounds pieceBounds;  // umschließt Zylinder und Kugel (Objektraum)
+    LodLevel lods[NUM_LODS];
+    int numLods;
+
+    unsigned int uploadedVersion;        // Version des Szenengraphen beim letzten Upload
+    unsigned int uploadedCameraVersion;  // Version der Kamera beim letzten Upload
+    std::vector<unsigned char> currentLod;  // Detailstufe je Figur (für die Hysterese)
+    size_t uploadedBytes;
+
+    // Culling: Bounding-Spheres aller Figuren in Weltkoordinaten, Sichtbarkeit je Figur
+    BoundingSpheres worldBounds;
+    std::vector<unsigned char> visible;
+    size_t numCulled;
+
+    void setupProgram();
+    // Legt ein VAO mit den Buffern des Meshes und den (noch leeren) Instanz-Attributen an
+    unsigned int setupInstancedVAO(const Mesh &mesh);
+    // Lässt die Instanz-Attribute des VAOs auf die Daten ab offset im Stream-Buffer zeigen
+    void bindInstances(unsigned int vao, size_t offset);
+    // Render-Thread: schreibt renderInstances in den Stream-Buffer
+    void uploadInstances();
+    // Setzt die Rückrechnung der quantisierten Positionen des Meshes (pro Draw-Item)
+    std::function<void()> quantizationUniforms(const Mesh &mesh) const;
+    // Durchmesser einer Bounding-Sphere (Weltkoordinaten) auf dem Bildschirm in Pixeln
+    float projectedSize(const glm::vec3 &center, float radius, const Camera &camera) const;
+};
+
+#endif
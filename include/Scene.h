@@ -0,0 +1,177 @@
+#ifndef SCENE_H
+#define SCENE_H
+
+#include <vector>
+
+#include "Background.h"
+#include "Board.h"
+#include "BoardLayout.h"
+#include "Camera.h"
+#include "Figur.h"
+#include "PieceAnimator.h"
+#include "PieceRenderer.h"
+#include "Picker.h"
+#include "SceneGraph.h"
+#include "GLRender/CommandList.h"
+#include "GLRender/FrameGraph.h"
+#include "GLRender/Frustum.h"
+#include "GLRender/Profiler.h"
+#include "GLRender/RenderQueue.h"
+#include "GLRender/RenderThread.h"
+#include "GLRender/StreamBuffer.h"
+
+#include <functional>
+
+// Größe der Szene; Standard ist ein Brett mit 16 Figuren, Benchmarks nehmen mehr
+struct SceneConfig
+{
+    int numBoards = 1;    // Bretter nebeneinander in einem Raster
+    int numPieces = 16;   // Figuren insgesamt, reihum auf die Bretter verteilt
+    bool persistentStreaming = true;  // Stream-Buffer persistent mappen, falls unterstützt
+};
+
+// Die komplette Spielszene (Kamera, Hintergrund, Brett und 16 Figuren), unabhängig davon,
+// ob in ein Fenster oder offscreen gerendert wird. Wird vom Fenster-Sample und vom
+// Headless-Modus gemeinsam genutzt.
+//
+// Ein Frame entsteht in zwei Schritten: record() rechnet auf dem Hauptthread Kamera,
+// Szenengraph, Culling und Instanzdaten und zeichnet die GL-Befehle je Pass in Command-Lists
+// auf, execute() spielt sie auf dem Thread mit dem GL-Kontext ab. Mit einem Render-Thread
+// laufen beide gleichzeitig (renderAsync), ohne nacheinander auf demselben Thread (render).
+// init, destroy und finishLoading brauchen den GL-Kontext auf dem aufrufenden Thread.
+class Scene
+{
+public:
+    // Sätze von Command-Lists: einer wird abgespielt, einer wartet, einer wird aufgezeichnet
+    static const unsigned int NUM_FRAME_SLOTS = RenderThread::MAX_PENDING + 2;
+
+    Scene();
+    ~Scene();
+
+    // Legt alle Objekte an; die GL-Funktionen müssen bereits geladen sein
+    void init(int width, int height, const SceneConfig &config = SceneConfig());
+    // Gibt alle GL-Ressourcen frei (vor dem Zerstören des Kontexts aufrufen)
+    void destroy();
+
+    // Viewport und Seitenverhältnis anpassen (Hauptthread, wirkt ab dem nächsten record)
+    void resize(int width, int height);
+    // Simulation um einen festen Schritt dt (Sekunden) weiterrechnen (Hauptthread)
+    void update(float dt);
+    // Lage für die nächsten Frames zwischen den letzten beiden Schritten interpolieren
+    // (alpha = 0: vorletzter, 1: letzter Schritt); nach update() aufrufen, sonst bleibt die gezeichnete Lage stehen
+    void interpolate(float alpha);
+    // Bild löschen und einen Frame in den aktuell gebundenen Framebuffer zeichnen; Texturen,
+    // die noch laden, erscheinen als Platzhalterfarbe
+    void render();
+    // Frame aufzeichnen und dem Render-Thread übergeben, der ihn zeichnet und danach present
+    // aufruft (z. B. glfwSwapBuffers); wartet nur, wenn der Render-Thread einen Frame zurückliegt
+    void renderAsync(RenderThread &renderThread, const std::function<void()> &present);
+
+    // Hauptthread: Frame in den nächsten freien Satz Command-Lists aufzeichnen, liefert ihn zurück
+    unsigned int record();
+    // GL-Thread: einen aufgezeichneten Frame zeichnen
+    void execute(unsigned int slot);
+    // Figur oder Feld unter dem Pixel (x, y) des Viewports (Ursprung links oben), ohne GPU;
+    // der Baum wird beim ersten Aufruf aufgebaut, danach nur angepasst (Hauptthread)
+    PickResult pick(float x, float y);
+    const Picker &getPicker() const { return picker; }
+    // Zug: Figur piece rückt steps Felder vor (aus dem Haus auf das Startfeld, am Ende der Bahn
+    // in die Zielfelder) und springt animiert dorthin; eine fremde Figur auf dem Zielfeld wird
+    // ins Haus geworfen. false, wenn der Zug nicht geht (über das letzte Zielfeld hinaus,
+    // eigene Figur auf dem Zielfeld, Figur ohne Feld). Hauptthread, zwischen den Schritten.
+    bool movePiece(int piece, int steps);
+    // Feld der Figur nach allen Zügen (BoardLayout), -1 für Figuren ohne Feld
+    int getPieceField(int piece) const;
+    const PieceAnimator &getAnimator() const { return animator; }
+    // Wartet, bis alle Texturen geladen und hochgeladen sind (Headless-Modus und Benchmark,
+    // damit schon der erste Frame die endgültigen Texturen zeigt)
+    void finishLoading();
+
+    Board* getBoard() { return boards.empty() ? nullptr : boards[0]; }
+    const std::vector<Board*>& getBoards() const { return boards; }
+    size_t getNumPieces() const { return figuren.size(); }
+    const PieceRenderer* getPieceRenderer() const { return pieceRenderer; }
+    // Anzahl Bretter, die im letzten Frame außerhalb des Sichtvolumens lagen
+    size_t getNumCulledBoards() const { return numCulledBoards; }
+    Camera* getCamera() { return camera; }
+    // Statistik der Render-Queue, summiert über alle Passes des letzten Frames (GL-Thread)
+    const RenderQueueStats& getStats() const { return frameStats; }
+    // Aufgezeichnete Befehle und kopierte Bytes des letzten Frames
+    size_t getNumRecordedCommands() const { return recordedCommands; }
+    size_t getRecordedBytes() const { return recordedBytes; }
+    // CPU- und GPU-Zeiten der Passes Hintergrund, Brett und Figuren
+    Profiler& getProfiler() { return profiler; }
+    // Passes eines Frames; weitere Passes (Overlay, Post-Effekte, Schatten) werden hier
+    // angemeldet statt in render() eingefügt
+    FrameGraph& getFrameGraph() { return frameGraph; }
+    // Summe aller Buffer-Uploads (Kamera und Instanzdaten) in Bytes
+    size_t getUploadedBytes() const;
+    // Ring-Buffer für die Daten pro Frame
+    const StreamBuffer& getStreamBuffer() const { return streamBuffer; }
+
+private:
+    Camera* camera;                // stellt View/Projektion allen Shadern bereit
+    std::vector<Board*> boards;    // Spielfelder, Wurzeln des Szenengraphs
+    Background* background;        // Hintergrund-Quad
+    std::vector<Figur*> figuren;   // Figuren als Kinder der Bretter
+    PieceRenderer* pieceRenderer;  // zeichnet alle Figuren instanziert
+    SceneGraph sceneGraph;
+    Picker picker;                 // Strahlauswahl, BVH über Figuren und Felder
+
+    // Spielstand einer Figur; Fortschritt -1 im Haus, 0 .. 39 auf der Bahn ab dem Startfeld,
+    // 40 .. 43 im Ziel, -2 für Figuren ohne Feld (über 16 je Brett, nur im Benchmark)
+    struct PieceState
+    {
+        int board;
+        int player;
+        int homeIndex;   // eigenes Hausfeld des Spielers
+        int progress;
+    };
+    static const int PROGRESS_HOME = -1;
+    static const int PROGRESS_NONE = -2;
+    static const int PROGRESS_GOAL = BoardLayout::NUM_TRACK_FIELDS;
+    std::vector<PieceState> pieceStates;
+    std::vector<int> fieldPieces;  // Figur je Brett und Feld oder -1
+    PieceAnimator animator;        // Sprünge und Rückwürfe der Figuren
+
+    // Befehle eines Frames: Uploads und Zustand vor den Passes, dann je Pass eine Liste
+    struct FrameCommands
+    {
+        CommandList setup;
+        CommandList boards;
+        CommandList pieces;
+        CommandList background;
+    };
+    FrameCommands frames[NUM_FRAME_SLOTS];
+    unsigned int recordSlot;       // Hauptthread: zuletzt aufgezeichneter Satz
+    unsigned int executeSlot;      // GL-Thread: Satz, den die Passes gerade abspielen
+    size_t recordedCommands, recordedBytes;
+    int pendingWidth, pendingHeight;  // Größe aus resize(), noch nicht aufgezeichnet (0 = keine)
+
+    // GL-Thread
+    RenderQueue renderQueue;       // sammelt und sortiert die Draw-Items eines Passes
+    RenderQueueStats frameStats;
+    StreamBuffer streamBuffer;     // Instanzdaten pro Frame, ohne auf die GPU zu warten
+
+    // Culling der Bretter gegen das Sichtvolumen der Kamera
+    BoundingSpheres boardBounds;
+    std::vector<unsigned char> boardVisible;
+    size_t numCulledBoards;
+
+    Profiler profiler;
+    FrameGraph frameGraph;         // Reihenfolge und Ziele der Passes
+
+    void createBoards(int numBoards);
+    void createFiguren(int numPieces);
+    int fieldOf(const PieceState &state, int progress) const;
+    // Passes Brett, Figuren und Hintergrund im Frame-Graph anmelden
+    void setupFrameGraph(int width, int height);
+    void recordBoards(CommandList &commands);
+    void recordPieces(CommandList &commands);
+    // Weltmatrizen neu rechnen und die Änderungen an den Picker melden
+    void updateSceneGraph();
+    // Liste eines Passes abspielen und die Statistik aufsummieren
+    void executePass(const CommandList &commands);
+};
+
+#endif
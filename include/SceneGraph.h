@@ -0,0 +1,59 @@
+#ifndef SCENEGRAPH_H
+#define SCENEGRAPH_H
+
+#include <glm/glm.hpp>
+#include <vector>
+
+// Leichtgewichtiger Szenengraph: Knoten liegen in Arrays (Eltern immer vor ihren Kindern),
+// Weltmatrizen werden nur für Teilbäume neu berechnet, deren lokaler Transform oder
+// Eltern-Transform sich geändert hat, und liegen zusammenhängend im Speicher.
+class SceneGraph
+{
+public:
+    typedef unsigned int NodeId;
+    static const NodeId INVALID_NODE = ~0u;
+
+    SceneGraph();
+
+    // Legt einen Knoten an; der Elternknoten muss bereits existieren
+    NodeId createNode(NodeId parent = INVALID_NODE);
+
+    // Setzt den lokalen Transform (relativ zum Elternknoten) und markiert den Knoten
+    void setLocalTransform(NodeId node, const glm::mat4 &local);
+    const glm::mat4 &getLocalTransform(NodeId node) const { return locals[node]; }
+
+    // Markiert einen Knoten als geändert, ohne den Transform zu ändern (z. B. neue Farbe)
+    void invalidate(NodeId node);
+
+    // Weltmatrix (gültig nach update())
+    const glm::mat4 &getWorldTransform(NodeId node) const { return worlds[node]; }
+    NodeId getParent(NodeId node) const { return parents[node]; }
+
+    // Rechnet die Weltmatrizen aller geänderten Teilbäume neu; liefert die Anzahl
+    // neu berechneter Knoten (0 bei statischer Szene)
+    size_t update();
+
+    // Alle Weltmatrizen zusammenhängend, z. B. zum Hochladen
+    const glm::mat4 *getWorldTransforms() const { return worlds.data(); }
+    size_t getNodeCount() const { return parents.size(); }
+
+    // Bereich der Knoten, die beim letzten update() neu berechnet wurden (count == 0: keine)
+    NodeId getChangedFirst() const { return changedFirst; }
+    NodeId getChangedCount() const { return changedCount; }
+
+    // Wird bei jedem update() erhöht, das Weltmatrizen geändert hat
+    unsigned int getVersion() const { return version; }
+
+private:
+    std::vector<NodeId> parents;
+    std::vector<glm::mat4> locals;
+    std::vector<glm::mat4> worlds;
+    std::vector<unsigned char> dirty;    // lokaler Transform geändert
+    std::vector<unsigned char> changed;  // Weltmatrix im laufenden update() neu berechnet
+    bool anyDirty;
+
+    NodeId changedFirst, changedCount;
+    unsigned int version;
+};
+
+#endif
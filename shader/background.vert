@@ -5,5 +5,5 @@ out vec2 TexCoords;
 void main()
 {
     TexCoords = aTexCoord;
-    gl_Position = vec4(aPos, 0.0, 1.0);
+    gl_Position = vec4(aPos, 1.0, 1.0);  // auf der Far-Plane (Tiefe 1)
 }
\ No newline at end of file
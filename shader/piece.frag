@@ -0,0 +1,12 @@
+#version 330 core
+
+// Farbe der Figur (pro Instanz)
+in vec3 Color;
+
+// Ausgabe der Fragmentfarbe
+out vec4 FragColor;
+
+void main()
+{
+    FragColor = vec4(Color, 1.0);
+}
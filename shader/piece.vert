@@ -0,0 +1,25 @@
+#version 330 core
+layout (location = 0) in vec3 aPos;       // Vertex Position
+layout (location = 2) in mat4 aModel;     // Modellmatrix pro Instanz (belegt Location 2-5)
+layout (location = 6) in vec3 aColor;     // Farbe pro Instanz
+
+out vec3 Color;  // Farbe für Fragment-Shader
+
+// Rückrechnung der 16-Bit-Positionen in Objektkoordinaten (je Mesh, siehe VertexQuantization)
+uniform vec3 positionScale;
+uniform vec3 positionOffset;
+
+// Kameramatrizen, einmal pro Frame von der Camera hochgeladen
+layout (std140) uniform Camera
+{
+    mat4 view;
+    mat4 projection;
+    mat4 viewProjection;
+};
+
+void main()
+{
+    vec3 position = aPos * positionScale + positionOffset;
+    gl_Position = viewProjection * aModel * vec4(position, 1.0); // Transformierte Position
+    Color = aColor;
+}
@@ -4,12 +4,18 @@ layout (location = 1) in vec2 aTexCoord;  // Texture Coordinates
 
 out vec2 TexCoords;  // Texture-Koordinaten für Fragment-Shader
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+uniform mat4 model;  // Einzige Matrix, die pro Objekt hochgeladen wird
+
+// Kameramatrizen, einmal pro Frame von der Camera hochgeladen
+layout (std140) uniform Camera
+{
+    mat4 view;
+    mat4 projection;
+    mat4 viewProjection;
+};
 
 void main()
 {
-    gl_Position = projection * view * model * vec4(aPos, 1.0); // Transformierte Position
+    gl_Position = viewProjection * model * vec4(aPos, 1.0); // Transformierte Position
     TexCoords = aTexCoord;  // Texture-Koordinaten weitergeben
 }
\ No newline at end of file
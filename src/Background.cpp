@@ -0,0 +1,69 @@
+#include "Background.h"
+
+#include <iostream>
+
+
+Background::Background()
+    : quadVAO(0), quadVBO(0)
+{
+    // Hintergrund-Quad erstellen
+    float quadVertices[] = {
+        // Position      // TexCoords
+        -1.0f,  1.0f,    0.0f, 1.0f,  // oben links
+        -1.0f, -1.0f,    0.0f, 0.0f,  // unten links
+         1.0f, -1.0f,    1.0f, 0.0f,  // unten rechts
+
+        -1.0f,  1.0f,    0.0f, 1.0f,  // oben links
+         1.0f, -1.0f,    1.0f, 0.0f,  // unten rechts
+         1.0f,  1.0f,    1.0f, 1.0f   // oben rechts
+    };
+    glGenVertexArrays(1, &quadVAO);
+    glGenBuffers(1, &quadVBO);
+    glBindVertexArray(quadVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), quadVertices, GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    glBindVertexArray(0);
+
+    // Hintergrundtextur im Hintergrund laden (gebackener Container schon gespiegelt, das JPEG
+    // wird beim Dekodieren vertikal umgedreht); bis dahin ein dunkles Blau
+    texture = TextureManager::get().acquire(TextureDesc("textures/background.jpg", 0, TextureLoader::FLIP_VERTICALLY), 40, 52, 72);
+
+    // Hintergrund-Shader laden (Pfad anpassen, falls nötig)
+    shader = ShaderRegistry::get().acquire("shader/background.vert", "shader/background.frag");
+    if (!shader)
+    {
+        std::cerr << "Fehler: Hintergrund-Shader konnte nicht geladen werden!" << std::endl;
+        return;
+    }
+
+    // Sampler einmalig auf Textureinheit 0 setzen
+    shader->useProgram();
+    glUniform1i(glGetUniformLocation(shader->getPrgID(), "backgroundTexture"), 0);
+}
+
+Background::~Background()
+{
+    glDeleteVertexArrays(1, &quadVAO);
+    glDeleteBuffers(1, &quadVBO);
+}
+
+void Background::record(CommandList &commands) const
+{
+    if (!shader)
+        return;
+
+    // Das Quad liegt auf der Far-Plane und wird nach der Szene gezeichnet: der Tiefentest
+    // verwirft alle Pixel, die Brett oder Figuren schon belegt haben (kein Overdraw)
+    DrawItem item;
+    item.uiLayer = 0;
+    item.eDepthFunc = GL_LEQUAL;
+    item.bDepthWrite = false;
+    item.uiProgram = shader->getPrgID();
+    item.uiVAO = quadVAO;
+    item.iCount = 6;
+    commands.draw(item, texture);  // Textur-ID beim Abspielen
+}
@@ -1,101 +1,58 @@
-#define STB_IMAGE_IMPLEMENTATION
 #include "Board.h"
-#include "stb/stb_image.h"
-#include "ShaderUtils.h"
+#include "Camera.h"
+#include "GLRender/GLDebug.h"
+#include <algorithm>
 #include <iostream>
 #include <GLFW/glfw3.h>
 #include <glad/glad.h>
 #include <fstream>
 #include <sstream>
+#include <vector>
 
 
-
-// Shader-Kompilierungsfunktion
-unsigned int Board::compileShader(const std::string& vertexShaderPath, const std::string& fragmentShaderPath) {
-    // Vertex Shader laden und kompilieren
-    std::string vertexCode = readShaderFile(vertexShaderPath);
-    if (vertexCode.empty()) {
-        std::cerr << "Fehler: Vertex-Shader konnte nicht geladen werden!" << std::endl;
-        return 0;
-    }
-    const char* vertexSource = vertexCode.c_str();
-    unsigned int vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader, 1, &vertexSource, NULL);
-    glCompileShader(vertexShader);
-
-    int success;
-    glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        char infoLog[512];
-        glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-        std::cerr << "Fehler beim Kompilieren des Vertex Shaders:\n" << infoLog << std::endl;
-        return 0;
-    }
-
-    // Fragment Shader laden und kompilieren
-    std::string fragmentCode = readShaderFile(fragmentShaderPath);
-    if (fragmentCode.empty()) {
-        std::cerr << "Fehler: Fragment-Shader konnte nicht geladen werden!" << std::endl;
-        return 0;
-    }
-    const char* fragmentSource = fragmentCode.c_str();
-    unsigned int fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragmentShader, 1, &fragmentSource, NULL);
-    glCompileShader(fragmentShader);
-
-    glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        char infoLog[512];
-        glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-        std::cerr << "Fehler beim Kompilieren des Fragment Shaders:\n" << infoLog << std::endl;
-        return 0;
-    }
-  
-
-    // Shader-Programm erstellen und linken
-    unsigned int shaderProgram = glCreateProgram();
-    glAttachShader(shaderProgram, vertexShader);
-    glAttachShader(shaderProgram, fragmentShader);
-    glLinkProgram(shaderProgram);
-
-    glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-    if (!success) {
-        char infoLog[512];
-        glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-        std::cerr << "Fehler beim Linken des Shader-Programms:\n" << infoLog << std::endl;
-        return 0;
-    }
-
-    // Shader löschen, da sie im Programm sind
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
-
-    return shaderProgram;
-}
-
-void checkOpenGLError(const std::string& functionName)
+// 3D-Quader für das Brett (Position & Textur-Koordinaten)
+static std::vector<float> getQuadVertices()
 {
-    GLenum err;
-    while ((err = glGetError()) != GL_NO_ERROR)
-    {
-        std::cerr << "OpenGL Fehler (" << functionName << "): " << err << std::endl;
-    }
+    return {
+    //  Position          // Texture
+    -0.5f, -0.5f, 0.0f,   0.0f, 1.0f, // Links unten
+     0.5f, -0.5f, 0.0f,   1.0f, 1.0f, // Rechts unten
+     0.5f,  0.5f, 0.0f,   1.0f, 0.0f, // Rechts oben
+    -0.5f,  0.5f, 0.0f,   0.0f, 0.0f  // Links oben
+    };
 }
 
-
 Board::Board() 
-    : shaderID(0) // Initialisiere shaderID mit 0
+    : bounds(MeshBounds::fromVertices(getQuadVertices(), 5)),
+      shaderID(0), // Initialisiere shaderID mit 0
+      modelLoc(-1), useTextureLoc(-1),
+      spinX(0.0f), spinY(0.0f), tickX(0.0f), tickY(0.0f),
+      scene(nullptr), node(SceneGraph::INVALID_NODE)
 {
     const std::string vertexShaderPath   = "shader/shader.vert";
     const std::string fragmentShaderPath = "shader/shader.frag";
 
-    shaderID = compileShader(vertexShaderPath, fragmentShaderPath);
+    // Das Programm wird über die Registry mit den Figuren geteilt
+    shader = ShaderRegistry::get().acquire(vertexShaderPath, fragmentShaderPath);
+    shaderID = shader ? shader->getPrgID() : 0;
     if (!shaderID) {
         std::cerr << "Fehler: Shader konnte nicht geladen werden!" << std::endl;
     }
+    else {
+        // Uniform-Locations einmalig abfragen, Kameramatrizen kommen aus dem Uniform-Block
+        Camera::bindProgram(shaderID);
+        modelLoc = glGetUniformLocation(shaderID, "model");
+        if (modelLoc == -1) {
+            std::cerr << "Fehler: Uniform 'model' wurde nicht gefunden!" << std::endl;
+        }
+        useTextureLoc = glGetUniformLocation(shaderID, "useTexture");
+        glUseProgram(shaderID);
+        glUniform1i(glGetUniformLocation(shaderID, "texture1"), 0);
+    }
 
     modelMatrix = glm::mat4(1.0f);
     modelMatrix = glm::scale(glm::mat4(1.0f), glm::vec3(5.0f, 5.0f, 1.0f));
+    previousMatrix = displayMatrix = modelMatrix;
     setupBoard();
 }
 
@@ -104,60 +61,45 @@ Board::~Board()
     glDeleteVertexArrays(1, &VAO);
     glDeleteBuffers(1, &VBO);
     glDeleteBuffers(1, &EBO);
-    glDeleteTextures(1, &texture);
 }
 
 void Board::setupBoard()
 {
     float textureAspectRatio = 1024.0f / 768.0f; // 1.333
 
-    // 3D-Quader für das Brett (Position & Textur-Koordinaten)
-    float vertices[] = {
-    //  Position          // Texture
-    -0.5f, -0.5f, 0.0f,   0.0f, 1.0f, // Links unten
-     0.5f, -0.5f, 0.0f,   1.0f, 1.0f, // Rechts unten
-     0.5f,  0.5f, 0.0f,   1.0f, 0.0f, // Rechts oben
-    -0.5f,  0.5f, 0.0f,   0.0f, 0.0f  // Links oben
+    const std::vector<float> vertices = getQuadVertices();
 
-    };
-
-    unsigned int indices[] = {  
+    unsigned short indices[] = {  
         // Vorderseite
         0, 1, 2, 2, 3, 0,
        
     };
 
+    // Kompakt speichern: 16-Bit-Positionen und -Texturkoordinaten (12 statt 20 Bytes pro Vertex)
+    const VertexFormat format(VertexFormat::POSITION_INT16, VertexFormat::TEXCOORD_UNORM16);
+    std::vector<unsigned char> encoded;
+    format.encode(vertices, 5, 3, -1, encoded, &quantization);
+
     glGenVertexArrays(1, &VAO);
-    checkOpenGLError("glGenVertexArrays");
 
     glGenBuffers(1, &VBO);
-    checkOpenGLError("glGenBuffers (VBO)");
 
     std::cout << "VAO ID: " << VAO << ", VBO ID: " << VBO << ", EBO ID: " << EBO << std::endl;
 
     glGenBuffers(1, &EBO);
-    checkOpenGLError("glGenBuffers (EBO)");
 
     glBindVertexArray(VAO);
-    checkOpenGLError("glBindVertexArray");
 
     glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-    checkOpenGLError("glBufferData (VBO)");
+    glBufferData(GL_ARRAY_BUFFER, encoded.size(), encoded.data(), GL_STATIC_DRAW);
 
 
 
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-    checkOpenGLError("glBufferData (EBO)");
 
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    checkOpenGLError("glVertexAttribPointer (Position)");
-    
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-    checkOpenGLError("glVertexAttribPointer (Texture)");
+    format.setupAttribs();
+    GL_CHECK("Board::setupBoard");
 
     glBindVertexArray(0);
 
@@ -167,92 +109,49 @@ void Board::setupBoard()
 
 void Board::loadTexture(const char* path)
 {
-    glGenTextures(1, &texture);
-    checkOpenGLError("glGenTextures");
-    glBindTexture(GL_TEXTURE_2D, texture);
-    checkOpenGLError("glBindTexture");
-    
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    checkOpenGLError("glTexParameteri");
-
-    int width, height, nrChannels;
-    unsigned char *data = stbi_load(path, &width, &height, &nrChannels, 4);  // RGBA statt RGB
-    checkOpenGLError("stbi_load");
-    if (data)
-    {
-        
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-        checkOpenGLError("glTexImage2D");
-
-        glGenerateMipmap(GL_TEXTURE_2D);
-        checkOpenGLError("glGenerateMipmap");
-        std::cout << "Textur geladen: " << path << " (" << width << "x" << height << " - " << nrChannels << " Kanäle)" << std::endl;
-    }
-    else
-    {
-        std::cout << "Fehler: Textur konnte nicht geladen werden!" << std::endl;
-    }
-    stbi_image_free(data);
-
-    
+    // Alle Bretter teilen sich eine Textur; geladen wird sie auf einem Worker-Thread, bis
+    // dahin zeigt das Brett seine Grundfarbe
+    texture = TextureManager::get().acquire(TextureDesc(path, 4), 236, 222, 178);  // RGBA statt RGB
 }
 
 void Board::render()
+{
+    // Sofort zeichnen: eigene Liste mit nur diesem Objekt
+    CommandList commands;
+    RenderQueue queue;
+    record(commands, glm::mat4(1.0f));
+    commands.execute(queue);
+}
+
+void Board::record(CommandList &commands, const glm::mat4 &view)
 {
    if (!shaderID) {
         std::cerr << "Fehler: Shader wurde nicht geladen!" << std::endl;
         return;
     }
 
-    glUseProgram(shaderID);  
-    checkOpenGLError("glUseProgram");
-
-    int useTextureLoc = glGetUniformLocation(shaderID, "useTexture");
-    glUniform1i(useTextureLoc, GL_TRUE);
-
-    // Matrizen für 3D-Transformation
-    glm::mat4 projection = glm::perspective(glm::radians(45.0f), 800.0f / 600.0f, 0.1f, 100.0f);
-    glm::mat4 view = glm::lookAt(
-        glm::vec3(0.0f, 3.0f, 10.0f), // Kamera-Position
-        glm::vec3(0.0f, 0.0f, 0.0f),  // Blickpunkt
-        glm::vec3(0.0f, 1.0f, 0.0f)   // Up-Vektor
-    );
-    
-    unsigned int modelLoc = glGetUniformLocation(shaderID, "model");
-    if (modelLoc == -1) {
-    std::cerr << "Fehler: Uniform 'model' wurde nicht gefunden!" << std::endl;
-    }
-    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(modelMatrix));
-    checkOpenGLError("glUniformMatrix4fv");
-
-    unsigned int viewLoc = glGetUniformLocation(shaderID, "view");
-    if (viewLoc == -1) {
-    std::cerr << "Fehler: Uniform 'view' wurde nicht gefunden!" << std::endl;
-    }
-    glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
-
-    unsigned int projectionLoc = glGetUniformLocation(shaderID, "projection");
-    if (projectionLoc == -1) {
-    std::cerr << "Fehler: Uniform 'projection' wurde nicht gefunden!" << std::endl;
-    }
-    glUniformMatrix4fv(projectionLoc, 1, GL_FALSE, glm::value_ptr(projection));
-
-   
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, texture);
-    checkOpenGLError("glBindTexture");
-    glUniform1i(glGetUniformLocation(shaderID, "texture1"), 0);
-
-    glBindVertexArray(VAO);
-    checkOpenGLError("glBindVertexArray");
-
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-    checkOpenGLError("glDrawElements");
-   
-    glBindVertexArray(0);
+    DrawItem item;
+    item.uiLayer = 1;
+    item.uiProgram = shaderID;
+    item.uiVAO = VAO;
+    item.iCount = 6;
+    item.eIndexType = GL_UNSIGNED_SHORT;
+    // Abstand des Brett-Mittelpunkts zur Kamera (für die Sortierung von vorne nach hinten)
+    item.fDepth = -(view * displayMatrix * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f)).z;
+
+    // View und Projektion kommen aus dem Uniform-Block der Kamera, nur das Modell wird hochgeladen
+    // (mit der Rückrechnung der 16-Bit-Positionen); Matrix und Locations werden kopiert, das
+    // Brett kann sich ändern, während die Liste abgespielt wird
+    float dequantize[16];
+    quantization.getMatrix(dequantize);
+    const glm::mat4 model = displayMatrix * glm::make_mat4(dequantize);
+    const int modelLocation = modelLoc, useTextureLocation = useTextureLoc;
+    item.fnUniforms = [model, modelLocation, useTextureLocation]() {
+        glUniform1i(useTextureLocation, GL_TRUE);
+        glUniformMatrix4fv(modelLocation, 1, GL_FALSE, glm::value_ptr(model));
+    };
+    // Die Textur-ID wird erst beim Abspielen abgefragt (Platzhalter, geladen, Stufen verworfen)
+    commands.draw(item, texture);
 }
 
 void Board::setWindowSize(int width, int height)
@@ -268,18 +167,82 @@ void Board::initGL()
 
 void Board::uninitGL()
 {
-    glDeleteTextures(1, &texture);
+    texture.reset();  // der TextureManager löscht die Textur mit dem letzten Brett
     std::cout << "OpenGL Ressourcen für Board freigegeben." << std::endl;
 }
 
 void Board::rotX(float angle)
 {
     modelMatrix = glm::rotate(modelMatrix, glm::radians(angle), glm::vec3(1.0f, 0.0f, 0.0f));
+    previousMatrix = modelMatrix;
+    tickX = tickY = 0.0f;
+    setDisplayMatrix(modelMatrix);
 }
 
 void Board::rotY(float angle)
 {
     modelMatrix = glm::rotate(modelMatrix, glm::radians(angle), glm::vec3(0.0f, 0.0f, 1.0f));
+    previousMatrix = modelMatrix;
+    tickX = tickY = 0.0f;
+    setDisplayMatrix(modelMatrix);
+}
+
+void Board::translate(const glm::vec3 &offset)
+{
+    // In Weltkoordinaten verschieben, Skalierung und Rotation bleiben erhalten
+    modelMatrix = glm::translate(glm::mat4(1.0f), offset) * modelMatrix;
+    previousMatrix = glm::translate(glm::mat4(1.0f), offset) * previousMatrix;
+    setDisplayMatrix(glm::translate(glm::mat4(1.0f), offset) * displayMatrix);
+}
+
+void Board::setSpin(float degreesX, float degreesY)
+{
+    spinX = degreesX;
+    spinY = degreesY;
+}
+
+void Board::update(float dt)
+{
+    // Gedreht wird nur hier, mit fester Schrittweite: die Geschwindigkeit hängt weder von der
+    // Bildrate noch von der Tastenwiederholung ab
+    previousMatrix = modelMatrix;
+    tickX = spinX * dt;
+    tickY = spinY * dt;
+    if (tickX != 0.0f)
+        modelMatrix = glm::rotate(modelMatrix, glm::radians(tickX), glm::vec3(1.0f, 0.0f, 0.0f));
+    if (tickY != 0.0f)
+        modelMatrix = glm::rotate(modelMatrix, glm::radians(tickY), glm::vec3(0.0f, 0.0f, 1.0f));
+}
+
+void Board::interpolate(float alpha)
+{
+    if (tickX == 0.0f && tickY == 0.0f) {
+        // Im letzten Schritt nicht gedreht: den Szenengraph nicht jeden Frame als geändert markieren
+        if (displayMatrix != modelMatrix)
+            setDisplayMatrix(modelMatrix);
+        return;
+    }
+    // Dieselben Drehungen wie in update(), nur um den Bruchteil alpha: an beiden Enden exakt
+    // der Stand des Schritts, dazwischen ohne Scherung wie bei linear gemischten Matrizen
+    glm::mat4 matrix = previousMatrix;
+    if (tickX != 0.0f)
+        matrix = glm::rotate(matrix, glm::radians(tickX * alpha), glm::vec3(1.0f, 0.0f, 0.0f));
+    if (tickY != 0.0f)
+        matrix = glm::rotate(matrix, glm::radians(tickY * alpha), glm::vec3(0.0f, 0.0f, 1.0f));
+    setDisplayMatrix(matrix);
+}
+
+void Board::setDisplayMatrix(const glm::mat4 &matrix)
+{
+    displayMatrix = matrix;
+    if (scene) scene->setLocalTransform(node, displayMatrix);
+}
+
+void Board::attachToScene(SceneGraph* sceneGraph)
+{
+    scene = sceneGraph;
+    node = scene->createNode();
+    scene->setLocalTransform(node, displayMatrix);
 }
 
 void Board::keyPressed(int key)
@@ -289,4 +252,12 @@ void Board::keyPressed(int key)
 
 glm::mat4 Board::getModelMatrix() const {
     return modelMatrix;
+}
+
+glm::vec4 Board::getWorldBounds() const {
+    // Kugel um das Quad aus den Mesh-Bounds, skaliert mit der größten Achse
+    const glm::vec4 center = displayMatrix * glm::vec4(bounds.afCenter[0], bounds.afCenter[1], bounds.afCenter[2], 1.0f);
+    const float scale = std::max(glm::length(glm::vec3(displayMatrix[0])),
+                                 std::max(glm::length(glm::vec3(displayMatrix[1])), glm::length(glm::vec3(displayMatrix[2]))));
+    return glm::vec4(glm::vec3(center), bounds.fRadius * scale);
 }
\ No newline at end of file
@@ -0,0 +1,78 @@
+#include "BoardLayout.h"
+
+const float BoardLayout::FIELD_SPACING = 0.08f;
+const float BoardLayout::FIELD_RADIUS = 0.035f;
+
+// Viertel der Bahn, in dem der Spieler startet (im Uhrzeigersinn ab links oben):
+// rot links oben, grün rechts unten, gelb links unten, blau rechts oben
+static const int playerQuarter[BoardLayout::NUM_PLAYERS] = { 0, 2, 3, 1 };
+
+// Das erste Viertel der Bahn in Rasterkoordinaten (-5 .. 5, y nach oben), beginnend beim
+// Startfeld von rot; die übrigen Viertel entstehen durch Drehen um 90 Grad
+static const int firstQuarter[10][2] = {
+    { -5, 1 }, { -4, 1 }, { -3, 1 }, { -2, 1 }, { -1, 1 },
+    { -1, 2 }, { -1, 3 }, { -1, 4 }, { -1, 5 }, { 0, 5 }
+};
+
+// Häuser wie bisher in der Szene: je vier Felder in den Ecken
+static const glm::vec3 homePositions[BoardLayout::NUM_PLAYERS * BoardLayout::FIELDS_PER_PLAYER] = {
+    // rot
+    glm::vec3(-0.38f,  0.38f, 0.0f), glm::vec3(-0.28f,  0.38f, 0.0f),
+    glm::vec3(-0.38f,  0.28f, 0.0f), glm::vec3(-0.28f,  0.28f, 0.0f),
+    // grün
+    glm::vec3(0.38f,  -0.38f, 0.0f), glm::vec3(0.28f,  -0.38f, 0.0f),
+    glm::vec3(0.38f,  -0.28f, 0.0f), glm::vec3(0.28f,  -0.28f, 0.0f),
+    // gelb
+    glm::vec3(-0.38f, -0.38f, 0.0f), glm::vec3(-0.28f, -0.38f, 0.0f),
+    glm::vec3(-0.38f, -0.28f, 0.0f), glm::vec3(-0.28f, -0.28f, 0.0f),
+    // blau
+    glm::vec3(0.38f, 0.38f, 0.0f), glm::vec3(0.28f, 0.38f, 0.0f),
+    glm::vec3(0.38f, 0.28f, 0.0f), glm::vec3(0.28f, 0.28f, 0.0f)
+};
+
+// Rasterpunkt quarter-mal um 90 Grad im Uhrzeigersinn drehen
+static glm::vec3 gridPosition(int x, int y, int quarter)
+{
+    for (int i = 0; i < quarter; i++) {
+        const int t = x;
+        x = y;
+        y = -t;
+    }
+    return glm::vec3(x * BoardLayout::FIELD_SPACING, y * BoardLayout::FIELD_SPACING, 0.0f);
+}
+
+BoardLayout::FieldType BoardLayout::getType(int field)
+{
+    if (field < NUM_TRACK_FIELDS)
+        return TRACK;
+    return field < goalField(0, 0) ? HOME : GOAL;
+}
+
+int BoardLayout::getPlayer(int field)
+{
+    if (field < NUM_TRACK_FIELDS)
+        return -1;
+    return ((field - NUM_TRACK_FIELDS) / FIELDS_PER_PLAYER) % NUM_PLAYERS;
+}
+
+glm::vec3 BoardLayout::getPosition(int field)
+{
+    switch (getType(field)) {
+    case TRACK:
+        return gridPosition(firstQuarter[field % 10][0], firstQuarter[field % 10][1], field / 10);
+    case HOME:
+        return homePositions[field - NUM_TRACK_FIELDS];
+    case GOAL:
+    default:
+        // vom Feld vor dem Startfeld zur Mitte hin: (-4, 0) .. (-1, 0) im Viertel des Spielers
+        {
+            const int index = (field - NUM_TRACK_FIELDS) % FIELDS_PER_PLAYER;
+            return gridPosition(-4 + index, 0, playerQuarter[getPlayer(field)]);
+        }
+    }
+}
+
+int BoardLayout::getStartField(int player)
+{
+    return playerQuarter[player] * NUM_TRACK_FIELDS / 4;
+}
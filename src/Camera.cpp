@@ -0,0 +1,108 @@
+#include "Camera.h"
+
+#include <iostream>
+
+// GLM für Transformationen
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+
+Camera::Camera()
+    : ubo(0),
+      width(800), height(600),
+      fovY(45.0f), nearPlane(0.1f), farPlane(100.0f),
+      eye(0.0f, 3.0f, 10.0f),   // Kamera-Position
+      center(0.0f, 0.0f, 0.0f), // Blickpunkt
+      up(0.0f, 1.0f, 0.0f),     // Up-Vektor
+      view(1.0f), projection(1.0f), viewProjection(1.0f),
+      dirty(true), version(0), uploadedBytes(0)
+{
+    // Uniform-Buffer anlegen und einmalig an den Binding-Point hängen
+    glGenBuffers(1, &ubo);
+    glBindBuffer(GL_UNIFORM_BUFFER, ubo);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(CameraBlock), nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glBindBufferBase(GL_UNIFORM_BUFFER, BINDING, ubo);
+}
+
+Camera::~Camera()
+{
+    glDeleteBuffers(1, &ubo);
+}
+
+void Camera::setViewport(int w, int h)
+{
+    // Minimierte Fenster liefern 0x0
+    if (w <= 0 || h <= 0)
+        return;
+
+    if (w != width || h != height)
+    {
+        width = w;
+        height = h;
+        dirty = true;
+    }
+}
+
+void Camera::setPerspective(float fovYDegrees, float nearP, float farP)
+{
+    fovY = fovYDegrees;
+    nearPlane = nearP;
+    farPlane = farP;
+    dirty = true;
+}
+
+void Camera::lookAt(const glm::vec3 &e, const glm::vec3 &c, const glm::vec3 &u)
+{
+    eye = e;
+    center = c;
+    up = u;
+    dirty = true;
+}
+
+void Camera::update(CommandList &commands)
+{
+    if (!dirty)
+        return;
+
+    view = glm::lookAt(eye, center, up);
+    projection = glm::perspective(glm::radians(fovY), (float)width / (float)height, nearPlane, farPlane);
+    viewProjection = projection * view;
+
+    CameraBlock block;
+    block.view = view;
+    block.projection = projection;
+    block.viewProjection = viewProjection;
+
+    commands.bufferSubData(GL_UNIFORM_BUFFER, ubo, 0, &block, sizeof(CameraBlock));
+    uploadedBytes += sizeof(CameraBlock);
+
+    dirty = false;
+    version++;
+}
+
+void Camera::getRay(float x, float y, glm::vec3 &origin, glm::vec3 &direction) const
+{
+    // Pixel in normierte Gerätekoordinaten, dann Punkte auf Near- und Far-Plane zurückrechnen
+    const float ndcX = 2.0f * x / (float)width - 1.0f;
+    const float ndcY = 1.0f - 2.0f * y / (float)height;
+    const glm::mat4 inverse = glm::inverse(viewProjection);
+    const glm::vec4 nearPoint = inverse * glm::vec4(ndcX, ndcY, -1.0f, 1.0f);
+    const glm::vec4 farPoint = inverse * glm::vec4(ndcX, ndcY, 1.0f, 1.0f);
+    origin = glm::vec3(nearPoint) / nearPoint.w;
+    direction = glm::normalize(glm::vec3(farPoint) / farPoint.w - origin);
+}
+
+void Camera::bindProgram(unsigned int programID)
+{
+    if (!programID)
+        return;
+
+    unsigned int blockIndex = glGetUniformBlockIndex(programID, "Camera");
+    if (blockIndex == GL_INVALID_INDEX)
+    {
+        std::cerr << "Fehler: Uniform-Block 'Camera' wurde nicht gefunden!" << std::endl;
+        return;
+    }
+    glUniformBlockBinding(programID, blockIndex, BINDING);
+}
@@ -0,0 +1,176 @@
+#include "HeadlessContext.h"
+
+#define GLFW_INCLUDE_NONE
+#include <GLFW/glfw3.h>
+#ifdef MADN_HAVE_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+#include <cstring>
+#include <iostream>
+
+
+HeadlessContext::HeadlessContext()
+    : eglDisplay(nullptr), eglContext(nullptr), window(nullptr), glfwInitialized(false)
+{
+}
+
+HeadlessContext::~HeadlessContext()
+{
+    destroy();
+}
+
+bool HeadlessContext::create(int width, int height)
+{
+    if (createEGL())
+        return true;
+    return createGLFW(width, height);
+}
+
+void HeadlessContext::destroy()
+{
+#ifdef MADN_HAVE_EGL
+    if (eglDisplay) {
+        eglMakeCurrent((EGLDisplay)eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        if (eglContext)
+            eglDestroyContext((EGLDisplay)eglDisplay, (EGLContext)eglContext);
+        eglTerminate((EGLDisplay)eglDisplay);
+    }
+#endif
+    eglDisplay = nullptr;
+    eglContext = nullptr;
+
+    if (window)
+        glfwDestroyWindow(window);
+    window = nullptr;
+    if (glfwInitialized)
+        glfwTerminate();
+    glfwInitialized = false;
+}
+
+bool HeadlessContext::makeCurrent()
+{
+#ifdef MADN_HAVE_EGL
+    if (eglContext)
+        return eglMakeCurrent((EGLDisplay)eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, (EGLContext)eglContext) == EGL_TRUE;
+#endif
+    if (!window)
+        return false;
+    glfwMakeContextCurrent(window);
+    return true;
+}
+
+void HeadlessContext::releaseCurrent()
+{
+#ifdef MADN_HAVE_EGL
+    if (eglContext) {
+        eglMakeCurrent((EGLDisplay)eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        return;
+    }
+#endif
+    if (window)
+        glfwMakeContextCurrent(NULL);
+}
+
+GLADloadproc HeadlessContext::getProcAddress() const
+{
+#ifdef MADN_HAVE_EGL
+    if (eglContext)
+        return (GLADloadproc)eglGetProcAddress;
+#endif
+    return (GLADloadproc)glfwGetProcAddress;
+}
+
+const char* HeadlessContext::getBackendName() const
+{
+    return eglContext ? "EGL" : "GLFW";
+}
+
+bool HeadlessContext::createEGL()
+{
+#ifdef MADN_HAVE_EGL
+    // Surfaceless-Plattform von Mesa: braucht weder X11/Wayland noch eine GPU
+    EGLDisplay display = EGL_NO_DISPLAY;
+    const char* clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+    PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+        (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+    if (clientExtensions && std::strstr(clientExtensions, "EGL_MESA_platform_surfaceless") && getPlatformDisplay)
+        display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+    if (display == EGL_NO_DISPLAY)
+        display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+    EGLint major = 0, minor = 0;
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor))
+        return false;
+    eglDisplay = display;
+
+    if (!eglBindAPI(EGL_OPENGL_API)) {
+        destroy();
+        return false;
+    }
+
+    // Ohne Surface wird keine passende Config benötigt (EGL_KHR_no_config_context),
+    // ansonsten irgendeine Config mit Desktop-GL
+    EGLConfig config = EGL_NO_CONFIG_KHR;
+    const char* displayExtensions = eglQueryString(display, EGL_EXTENSIONS);
+    if (!displayExtensions || !std::strstr(displayExtensions, "EGL_KHR_no_config_context")) {
+        const EGLint configAttribs[] = { EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_SURFACE_TYPE, EGL_PBUFFER_BIT, EGL_NONE };
+        EGLint numConfigs = 0;
+        if (!eglChooseConfig(display, configAttribs, &config, 1, &numConfigs) || numConfigs < 1) {
+            destroy();
+            return false;
+        }
+    }
+
+    const EGLint contextAttribs[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 3,
+        EGL_CONTEXT_MINOR_VERSION, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+#ifdef GLRENDER_GL_DEBUG
+        EGL_CONTEXT_OPENGL_DEBUG, EGL_TRUE,
+#endif
+        EGL_NONE
+    };
+    EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttribs);
+    if (context == EGL_NO_CONTEXT) {
+        destroy();
+        return false;
+    }
+    eglContext = context;
+
+    if (!eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context)) {
+        destroy();
+        return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool HeadlessContext::createGLFW(int width, int height)
+{
+    if (!glfwInit()) {
+        std::cerr << "Fehler: GLFW konnte nicht initialisiert werden!" << std::endl;
+        return false;
+    }
+    glfwInitialized = true;
+
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);                     // Fenster nie anzeigen
+#ifdef GLRENDER_GL_DEBUG
+    glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GLFW_TRUE);
+#endif
+
+    window = glfwCreateWindow(width, height, "Mensch Ärgere Dich Nicht (headless)", NULL, NULL);
+    if (!window) {
+        std::cerr << "Fehler: Verstecktes Fenster konnte nicht erstellt werden!" << std::endl;
+        destroy();
+        return false;
+    }
+    glfwMakeContextCurrent(window);
+    glfwSwapInterval(0);
+    return true;
+}
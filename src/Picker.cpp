@@ -0,0 +1,171 @@
+#include "Picker.h"
+#include "BoardLayout.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+Picker::Picker()
+    : built(false), pendingFirst(0), pendingEnd(0)
+{
+}
+
+void Picker::build(const std::vector<Board*> &boards, const std::vector<Figur*> &figuren,
+                   const SceneGraph &scene, const MeshBounds &bounds)
+{
+    pieceBounds = bounds;
+    primitives.clear();
+    primitives.reserve(figuren.size() + boards.size() * BoardLayout::NUM_FIELDS);
+
+    // Brett jeder Figur über ihren Elternknoten im Szenengraph
+    for (size_t i = 0; i < figuren.size(); i++) {
+        Primitive primitive = Primitive();
+        primitive.node = figuren[i]->getNode();
+        primitive.piece = (int)i;
+        primitive.board = -1;
+        primitive.field = -1;
+        for (size_t b = 0; b < boards.size(); b++) {
+            if (boards[b]->getNode() == scene.getParent(primitive.node))
+                primitive.board = (int)b;
+        }
+        primitives.push_back(primitive);
+    }
+    for (size_t b = 0; b < boards.size(); b++) {
+        for (int field = 0; field < BoardLayout::NUM_FIELDS; field++) {
+            Primitive primitive = Primitive();
+            primitive.node = boards[b]->getNode();
+            primitive.piece = -1;
+            primitive.board = (int)b;
+            primitive.field = field;
+            primitives.push_back(primitive);
+        }
+    }
+
+    std::vector<BVH::Box> boxes(primitives.size());
+    nodePrimitives.resize(primitives.size());
+    for (size_t i = 0; i < primitives.size(); i++) {
+        boxes[i] = updatePrimitive(primitives[i], scene);
+        nodePrimitives[i] = std::make_pair(primitives[i].node, (unsigned int)i);
+    }
+    std::sort(nodePrimitives.begin(), nodePrimitives.end());
+    bvh.build(boxes);
+
+    built = true;
+    pendingFirst = pendingEnd = 0;
+}
+
+void Picker::invalidate(SceneGraph::NodeId first, SceneGraph::NodeId count)
+{
+    if (!built || !count)
+        return;
+    if (pendingFirst == pendingEnd) {
+        pendingFirst = first;
+        pendingEnd = first + count;
+    }
+    else {
+        pendingFirst = std::min(pendingFirst, first);
+        pendingEnd = std::max(pendingEnd, first + count);
+    }
+}
+
+void Picker::refit(const SceneGraph &scene)
+{
+    if (pendingFirst == pendingEnd)
+        return;
+
+    // nur die Figuren und Felder der geänderten Knoten; unveränderte Boxen lassen den Baum in Ruhe
+    auto it = std::lower_bound(nodePrimitives.begin(), nodePrimitives.end(), std::make_pair(pendingFirst, 0u));
+    for (; it != nodePrimitives.end() && it->first < pendingEnd; ++it) {
+        const BVH::Box box = updatePrimitive(primitives[it->second], scene);
+        const BVH::Box &old = bvh.getBox(it->second);
+        if (!std::equal(box.afMin, box.afMin + 3, old.afMin) || !std::equal(box.afMax, box.afMax + 3, old.afMax))
+            bvh.setBox(it->second, box);
+    }
+    bvh.refit();
+    pendingFirst = pendingEnd = 0;
+}
+
+BVH::Box Picker::updatePrimitive(Primitive &primitive, const SceneGraph &scene) const
+{
+    const glm::mat4 &world = scene.getWorldTransform(primitive.node);
+    BVH::Box box;
+
+    if (primitive.piece >= 0) {
+        // Box der Figur im Objektraum; die Weltbox umschließt die gedrehte Box (Mittelpunkt
+        // transformieren, Ausdehnung mit den Beträgen der Matrix)
+        primitive.toLocal = glm::inverse(world);
+        const glm::vec3 localCenter = 0.5f * (glm::vec3(pieceBounds.afMin[0], pieceBounds.afMin[1], pieceBounds.afMin[2]) +
+                                              glm::vec3(pieceBounds.afMax[0], pieceBounds.afMax[1], pieceBounds.afMax[2]));
+        const glm::vec3 localExtent = 0.5f * (glm::vec3(pieceBounds.afMax[0], pieceBounds.afMax[1], pieceBounds.afMax[2]) -
+                                              glm::vec3(pieceBounds.afMin[0], pieceBounds.afMin[1], pieceBounds.afMin[2]));
+        const glm::vec3 center = glm::vec3(world * glm::vec4(localCenter, 1.0f));
+        for (int a = 0; a < 3; a++) {
+            const float extent = std::fabs(world[0][a]) * localExtent.x + std::fabs(world[1][a]) * localExtent.y +
+                                 std::fabs(world[2][a]) * localExtent.z;
+            box.afMin[a] = center[a] - extent;
+            box.afMax[a] = center[a] + extent;
+        }
+        return box;
+    }
+
+    // Kreisscheibe des Feldes auf der Brettoberfläche; Normalen mit der inversen Transponierten,
+    // das Brett ist in der Ebene gestreckt
+    primitive.center = glm::vec3(world * glm::vec4(BoardLayout::getPosition(primitive.field), 1.0f));
+    primitive.normal = glm::normalize(glm::vec3(glm::transpose(glm::inverse(world)) * glm::vec4(0.0f, 0.0f, 1.0f, 0.0f)));
+    primitive.radius = BoardLayout::FIELD_RADIUS * glm::length(glm::vec3(world[0]));
+    for (int a = 0; a < 3; a++) {
+        // Ausdehnung einer Scheibe entlang einer Achse: r * sqrt(1 - n²), etwas Dicke gegen leere Boxen
+        const float extent = primitive.radius * std::sqrt(std::max(0.0f, 1.0f - primitive.normal[a] * primitive.normal[a])) + 1.0e-4f;
+        box.afMin[a] = primitive.center[a] - extent;
+        box.afMax[a] = primitive.center[a] + extent;
+    }
+    return box;
+}
+
+float Picker::intersect(const Primitive &primitive, const glm::vec3 &origin, const glm::vec3 &direction) const
+{
+    if (primitive.piece >= 0) {
+        // Strahl in den Objektraum der Figur; affin, der Strahlparameter bleibt derselbe
+        const glm::vec3 localOrigin = glm::vec3(primitive.toLocal * glm::vec4(origin, 1.0f));
+        const glm::vec3 localDirection = glm::vec3(primitive.toLocal * glm::vec4(direction, 0.0f));
+        const BVH::Ray ray(&localOrigin.x, &localDirection.x);
+        float entry;
+        if (!BVH::intersectBox(ray, pieceBounds.afMin, pieceBounds.afMax, 1.0e30f, entry))
+            return -1.0f;
+        return entry;
+    }
+
+    const float denominator = glm::dot(direction, primitive.normal);
+    if (std::fabs(denominator) < 1.0e-8f)
+        return -1.0f;
+    const float t = glm::dot(primitive.center - origin, primitive.normal) / denominator;
+    if (t < 0.0f)
+        return -1.0f;
+    const glm::vec3 offset = origin + t * direction - primitive.center;
+    return glm::dot(offset, offset) <= primitive.radius * primitive.radius ? t : -1.0f;
+}
+
+PickResult Picker::pick(const glm::vec3 &origin, const glm::vec3 &direction, const SceneGraph &scene)
+{
+    PickResult result;
+    if (!built)
+        return result;
+    refit(scene);
+
+    const BVH::Ray ray(&origin.x, &direction.x);
+    float distance = 1.0e30f;
+    const int hit = bvh.intersect(ray, distance, [&](uint32_t index, float) {
+        return intersect(primitives[index], origin, direction);
+    });
+    if (hit < 0)
+        return result;
+
+    const Primitive &primitive = primitives[hit];
+    result.type = primitive.piece >= 0 ? PickResult::PIECE : PickResult::FIELD;
+    result.piece = primitive.piece;
+    result.board = primitive.board;
+    result.field = primitive.field;
+    result.distance = distance;
+    result.point = origin + distance * direction;
+    return result;
+}
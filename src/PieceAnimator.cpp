@@ -0,0 +1,80 @@
+#include "PieceAnimator.h"
+
+#include <algorithm>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+const float PieceAnimator::HOP_DURATION = 0.18f;
+const float PieceAnimator::HOP_HEIGHT = 0.05f;
+const float PieceAnimator::KNOCK_DURATION = 0.6f;
+const float PieceAnimator::KNOCK_HEIGHT = 0.3f;
+
+glm::mat4 PieceAnimator::pieceTransform(const glm::vec3 &position)
+{
+    glm::mat4 local = glm::translate(glm::mat4(1.0f), position);
+    return glm::scale(local, glm::vec3(0.1f));
+}
+
+void PieceAnimator::play(int piece, const glm::vec3 &from)
+{
+    if (!tweens.append((uint32_t)piece, keys.data(), keys.size()))
+        tweens.start((uint32_t)piece, &from.x, keys.data(), keys.size());
+}
+
+float PieceAnimator::hop(int piece, const glm::vec3 &from, const std::vector<glm::vec3> &path, float delay)
+{
+    const float remaining = getRemaining(piece);
+    keys.clear();
+    if (delay > 0.0f)
+        keys.push_back({ { from.x, from.y, from.z }, delay, 0.0f });  // auf der Stelle warten
+    for (const glm::vec3 &field : path)
+        keys.push_back({ { field.x, field.y, field.z }, HOP_DURATION, HOP_HEIGHT });
+
+    play(piece, from);
+    return remaining + delay + path.size() * HOP_DURATION;
+}
+
+float PieceAnimator::knockBack(int piece, const glm::vec3 &from, const glm::vec3 &home, float delay)
+{
+    // ein laufender Sprung wird zu Ende geführt, in der Luft bleibt die Figur nie stehen
+    const float remaining = getRemaining(piece);
+    const float wait = std::max(delay, remaining) - remaining;
+    keys.clear();
+    if (wait > 0.0f)
+        keys.push_back({ { from.x, from.y, from.z }, wait, 0.0f });
+    keys.push_back({ { home.x, home.y, home.z }, KNOCK_DURATION, KNOCK_HEIGHT });
+
+    play(piece, from);
+    return remaining + wait + KNOCK_DURATION;
+}
+
+glm::vec3 PieceAnimator::getPosition(int piece) const
+{
+    glm::vec3 position(0.0f);
+    tweens.getPosition((uint32_t)piece, &position.x);
+    return position;
+}
+
+void PieceAnimator::update(float dt, const std::vector<Figur*> &figuren)
+{
+    tweens.update(dt);
+    // beendete Animationen fallen aus interpolate() heraus, ihre Figur steht ab jetzt fest
+    for (const TweenSystem::Retired &retired : tweens.getRetired()) {
+        if (retired.uiUser < figuren.size())
+            figuren[retired.uiUser]->setLocalTransform(pieceTransform(glm::vec3(retired.afPos[0], retired.afPos[1], retired.afPos[2])));
+    }
+}
+
+void PieceAnimator::interpolate(float alpha, const std::vector<Figur*> &figuren)
+{
+    tweens.interpolate(alpha);
+
+    const uint32_t* users = tweens.getUsers();
+    const float* x = tweens.getDrawX();
+    const float* y = tweens.getDrawY();
+    const float* z = tweens.getDrawZ();
+    for (size_t i = 0; i < tweens.size(); i++) {
+        if (users[i] < figuren.size())
+            figuren[users[i]]->setLocalTransform(pieceTransform(glm::vec3(x[i], y[i], z[i])));
+    }
+}
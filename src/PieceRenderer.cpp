@@ -0,0 +1,273 @@
+#include "PieceRenderer.h"
+#include "Figur.h"
+#include "Camera.h"
+
+#include <algorithm>
+#include <glm/gtc/type_ptr.hpp>
+#include <iostream>
+#include <cstddef>
+#include <cstring>
+
+
+PieceRenderer::PieceRenderer(StreamBuffer &streamBuffer)
+    : stream(streamBuffer), positionScaleLoc(-1), positionOffsetLoc(-1), numLods(0),
+      uploadedVersion(~0u), uploadedCameraVersion(~0u), uploadedBytes(0), numCulled(0)
+{
+    for (int i = 0; i < NUM_LODS; ++i)
+        renderCounts[i] = 0;
+    setupProgram();
+
+    // Dieselben Meshes wie die einzelnen Figuren (Stufe 0) plus gröbere Stufen
+    cylinderChain = MeshLibrary::get().acquireLODChain(Figur::cylinderDesc(), NUM_LODS);
+    sphereChain = MeshLibrary::get().acquireLODChain(Figur::sphereDesc(), NUM_LODS);
+    numLods = std::min(cylinderChain.getNumLevels(), sphereChain.getNumLevels());
+    pieceBounds = MeshBounds::merge(cylinderChain.cLevels[0]->getBounds(), sphereChain.cLevels[0]->getBounds());
+
+    // Die Schwellwerte gelten für den Durchmesser des jeweiligen Meshes, gemessen wird aber die
+    // ganze Figur: umrechnen und je Stufe den strengeren Wert von Zylinder und Kugel nehmen
+    const float cylinderScale = pieceBounds.fRadius / cylinderChain.cLevels[0]->getBounds().fRadius;
+    const float sphereScale = pieceBounds.fRadius / sphereChain.cLevels[0]->getBounds().fRadius;
+    sphereChain.cMinPixels.resize(numLods - 1);
+    for (int i = 0; i < numLods - 1; ++i)
+    {
+        sphereChain.cMinPixels[i] = std::max(sphereChain.cMinPixels[i] * sphereScale,
+                                             cylinderChain.cMinPixels[i] * cylinderScale);
+    }
+
+    for (int i = 0; i < numLods; ++i)
+    {
+        LodLevel &lod = lods[i];
+        lod.cylinder = cylinderChain.cLevels[i];
+        lod.sphere = sphereChain.cLevels[i];
+        lod.cylinderVAO = setupInstancedVAO(*lod.cylinder);
+        lod.sphereVAO = setupInstancedVAO(*lod.sphere);
+    }
+}
+
+PieceRenderer::~PieceRenderer()
+{
+    for (int i = 0; i < numLods; ++i)
+    {
+        glDeleteVertexArrays(1, &lods[i].cylinderVAO);
+        glDeleteVertexArrays(1, &lods[i].sphereVAO);
+    }
+}
+
+void PieceRenderer::setupProgram()
+{
+    program = ShaderRegistry::get().acquire("shader/piece.vert", "shader/piece.frag");
+    if (!program)
+    {
+        std::cerr << "Fehler: Shader für Figuren konnte nicht geladen werden!" << std::endl;
+        return;
+    }
+
+    // Kameramatrizen kommen aus dem Uniform-Block, pro Mesh nur die Rückrechnung der Positionen
+    Camera::bindProgram(program->getPrgID());
+    positionScaleLoc = glGetUniformLocation(program->getPrgID(), "positionScale");
+    positionOffsetLoc = glGetUniformLocation(program->getPrgID(), "positionOffset");
+}
+
+unsigned int PieceRenderer::setupInstancedVAO(const Mesh &mesh)
+{
+    unsigned int vao = 0;
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+
+    // Attribut 0: Position aus dem geteilten Vertex-Buffer (die Meshes der Figuren haben keine Texturkoordinaten)
+    mesh.setupAttribs();
+
+    // Attribute 2-6 (Instanzdaten) zeigen erst nach dem ersten Upload in den Stream-Buffer
+    for (int i = 2; i <= 6; ++i)
+    {
+        glEnableVertexAttribArray(i);
+        glVertexAttribDivisor(i, 1);
+    }
+
+    glBindVertexArray(0);
+    return vao;
+}
+
+void PieceRenderer::bindInstances(unsigned int vao, size_t offset)
+{
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, stream.getBuffer());
+
+    // Attribute 2-5: Modellmatrix pro Instanz (eine Spalte je Attribut)
+    for (int i = 0; i < 4; ++i)
+    {
+        glVertexAttribPointer(2 + i, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+                              (void*)(offset + offsetof(InstanceData, model) + i * sizeof(glm::vec4)));
+    }
+
+    // Attribut 6: Farbe pro Instanz
+    glVertexAttribPointer(6, 3, GL_FLOAT, GL_FALSE, sizeof(InstanceData), (void*)(offset + offsetof(InstanceData, color)));
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void PieceRenderer::uploadInstances()
+{
+    const size_t total = renderInstances.size();
+    if (!total)
+        return;
+
+    // Alle Stufen in einem Stück: ein Orphan des Buffers zwischen zwei Stufen würde sonst
+    // die bereits geschriebenen Daten ungültig machen
+    unsigned char* data = (unsigned char*)stream.map(total * sizeof(InstanceData), 16, &instanceAllocation);
+    if (!data)
+    {
+        std::cerr << "Fehler: Instanzdaten konnten nicht in den Stream-Buffer geschrieben werden!" << std::endl;
+        return;
+    }
+
+    std::memcpy(data, renderInstances.data(), total * sizeof(InstanceData));
+    stream.unmap();
+
+    size_t offset = 0;
+    for (int i = 0; i < numLods; ++i)
+    {
+        lods[i].offset = instanceAllocation.iOffset + offset;
+        offset += renderCounts[i] * sizeof(InstanceData);
+        if (!renderCounts[i])
+            continue;
+        bindInstances(lods[i].cylinderVAO, lods[i].offset);
+        bindInstances(lods[i].sphereVAO, lods[i].offset);
+    }
+    uploadedBytes += total * sizeof(InstanceData);
+}
+
+std::function<void()> PieceRenderer::quantizationUniforms(const Mesh &mesh) const
+{
+    const VertexQuantization quantization = mesh.getQuantization();
+    const int scaleLoc = positionScaleLoc;
+    const int offsetLoc = positionOffsetLoc;
+    return [quantization, scaleLoc, offsetLoc]() {
+        glUniform3fv(scaleLoc, 1, quantization.afScale);
+        glUniform3fv(offsetLoc, 1, quantization.afOffset);
+    };
+}
+
+float PieceRenderer::projectedSize(const glm::vec3 &center, float radius, const Camera &camera) const
+{
+    const glm::vec4 viewCenter = camera.getView() * glm::vec4(center, 1.0f);
+
+    // Kamera innerhalb der Kugel: volle Auflösung
+    const float distance = -viewCenter.z;
+    if (distance <= radius)
+        return 1.0e9f;
+
+    // projection[1][1] = 1 / tan(fovY / 2), der Viewport ist height Pixel hoch
+    return 2.0f * radius * camera.getProjection()[1][1] * 0.5f * camera.getHeight() / distance;
+}
+
+void PieceRenderer::record(CommandList &commands, const std::vector<Figur*> &figuren, const SceneGraph &scene, const Camera &camera)
+{
+    if (figuren.empty() || !program || !numLods)
+        return;
+
+    // Instanzdaten und Detailstufen nur neu berechnen, wenn sich Szenengraph oder Kamera geändert haben
+    const bool rebuild = scene.getVersion() != uploadedVersion || camera.getVersion() != uploadedCameraVersion ||
+                         figuren.size() != currentLod.size();
+    if (rebuild)
+    {
+        if (currentLod.size() != figuren.size())
+            currentLod.assign(figuren.size(), 0xff);  // noch keine Stufe: ohne Hysterese wählen
+
+        for (int i = 0; i < numLods; ++i)
+            lods[i].instances.clear();
+
+        // Bounding-Sphere jeder Figur in Weltkoordinaten: Mittelpunkt transformieren, Radius mit
+        // der größten Skalierung der Modellmatrix. Die Weltmatrizen (boardModel * lokaler
+        // Transform) hat der Szenengraph bereits berechnet.
+        const glm::vec4 localCenter(pieceBounds.afCenter[0], pieceBounds.afCenter[1], pieceBounds.afCenter[2], 1.0f);
+        worldBounds.clear();
+        worldBounds.reserve(figuren.size());
+        for (size_t i = 0; i < figuren.size(); ++i)
+        {
+            const glm::mat4 &model = scene.getWorldTransform(figuren[i]->getNode());
+            const glm::vec4 center = model * localCenter;
+            const float scale = std::max(glm::length(glm::vec3(model[0])),
+                                         std::max(glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2]))));
+            worldBounds.add(center.x, center.y, center.z, pieceBounds.fRadius * scale);
+        }
+
+        // Culling gegen das Sichtvolumen, vier Figuren pro SIMD-Befehl
+        Frustum frustum;
+        frustum.setMatrix(glm::value_ptr(camera.getViewProjection()));
+        visible.resize(figuren.size());
+        numCulled = figuren.size() - frustum.cull(worldBounds, visible.data());
+
+        for (size_t i = 0; i < figuren.size(); ++i)
+        {
+            if (!visible[i])
+                continue;
+
+            InstanceData instance;
+            instance.model = scene.getWorldTransform(figuren[i]->getNode());
+            instance.color = figuren[i]->getColor();
+
+            const glm::vec3 center(worldBounds.getX()[i], worldBounds.getY()[i], worldBounds.getZ()[i]);
+            const int current = currentLod[i] == 0xff ? -1 : currentLod[i];
+            const int level = std::min(sphereChain.selectLevel(projectedSize(center, worldBounds.getRadius()[i], camera), current), numLods - 1);
+            currentLod[i] = (unsigned char)level;
+            lods[level].instances.push_back(instance);
+        }
+        uploadedVersion = scene.getVersion();
+        uploadedCameraVersion = camera.getVersion();
+
+        // Alle Stufen hintereinander in die Liste kopieren; beim Abspielen übernimmt der
+        // Render-Thread sie als seine Kopie und lädt sie hoch
+        packedInstances.clear();
+        std::vector<size_t> counts(NUM_LODS, 0);
+        for (int i = 0; i < numLods; ++i)
+        {
+            packedInstances.insert(packedInstances.end(), lods[i].instances.begin(), lods[i].instances.end());
+            counts[i] = lods[i].instances.size();
+        }
+        commands.upload(packedInstances.data(), packedInstances.size() * sizeof(InstanceData),
+                        [this, counts](const void *data, size_t size) {
+                            const InstanceData *instances = static_cast<const InstanceData*>(data);
+                            renderInstances.assign(instances, instances + size / sizeof(InstanceData));
+                            for (int i = 0; i < NUM_LODS; ++i)
+                                renderCounts[i] = counts[i];
+                            uploadInstances();
+                        });
+    }
+    else
+    {
+        // Neu hochladen, wenn der letzte Upload nicht mehr gelesen werden darf; bei persistentem
+        // Mapping also in jedem Frame in dessen eigenen Bereich (nur dieser ist eingezäunt)
+        commands.call([this]() {
+            if (!stream.isValid(instanceAllocation))
+                uploadInstances();
+        });
+    }
+
+    DrawItem item;
+    item.uiLayer = 1;
+    item.uiProgram = program->getPrgID();
+
+    for (int i = 0; i < numLods; ++i)
+    {
+        const LodLevel &lod = lods[i];
+        if (lod.instances.empty())
+            continue;
+        item.iInstances = static_cast<GLsizei>(lod.instances.size());
+
+        // Alle Zylinder (Körper) dieser Stufe mit einem Draw-Call
+        item.uiVAO = lod.cylinderVAO;
+        item.iCount = lod.cylinder->getIndexCount();
+        item.eIndexType = lod.cylinder->getIndexType();
+        item.fnUniforms = quantizationUniforms(*lod.cylinder);
+        commands.draw(item);
+
+        // Alle Kugeln (Köpfe) dieser Stufe mit einem Draw-Call
+        item.uiVAO = lod.sphereVAO;
+        item.iCount = lod.sphere->getIndexCount();
+        item.eIndexType = lod.sphere->getIndexType();
+        item.fnUniforms = quantizationUniforms(*lod.sphere);
+        commands.draw(item);
+    }
+}
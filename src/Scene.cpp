@@ -0,0 +1,412 @@
+#include "Scene.h"
+
+#include <algorithm>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+
+Scene::Scene()
+    : camera(nullptr), background(nullptr), pieceRenderer(nullptr),
+      recordSlot(0), executeSlot(0), recordedCommands(0), recordedBytes(0),
+      pendingWidth(0), pendingHeight(0), numCulledBoards(0)
+{
+    frameStats = renderQueue.getStats();
+}
+
+Scene::~Scene()
+{
+    destroy();
+}
+
+void Scene::init(int width, int height, const SceneConfig &config)
+{
+    glEnable(GL_DEPTH_TEST);
+
+    // Kamera erstellen (Uniform-Block wird einmalig gebunden)
+    camera = new Camera();
+    camera->setViewport(width, height);
+
+    // Board-Objekte erstellen
+    createBoards(config.numBoards);
+    boards[0]->setWindowSize(width, height);
+
+    // Hintergrund-Quad erstellen (die Texturen laden im Hintergrund weiter)
+    background = new Background();
+
+    createFiguren(config.numPieces);
+
+    // Ring-Buffer für Daten, die jeden Frame neu geschrieben werden (Platz für die
+    // Instanzdaten aller Figuren, wächst bei Bedarf)
+    streamBuffer.create(GL_ARRAY_BUFFER, std::max(config.numPieces, 16) * 128, config.persistentStreaming);
+
+    // Renderer für alle Figuren (ein instanzierter Draw-Call je Mesh)
+    pieceRenderer = new PieceRenderer(streamBuffer);
+
+    setupFrameGraph(width, height);
+}
+
+// Die Passes geben nur an, was sie lesen und schreiben; Reihenfolge, Löschen des Ziels und
+// Zeitmessung übernimmt der Frame-Graph
+void Scene::setupFrameGraph(int width, int height)
+{
+    frameGraph.setProfiler(&profiler);
+    frameGraph.setTargetSize(width, height);
+
+    // Brett und Figuren sind undurchsichtig und tiefengetestet, ihre Reihenfolge ist frei:
+    // die Figuren zuerst, damit der Early-Z-Test die verdeckten Teile des Bretts verwirft
+    frameGraph.addPass("board",
+        [](FrameGraph::Builder &builder) {
+            builder.writeDepthTested(FrameGraph::TARGET_COLOR);
+            builder.writeDepthTested(FrameGraph::TARGET_DEPTH);
+        },
+        [this]() { executePass(frames[executeSlot].boards); }, 1);
+    frameGraph.addPass("pieces",
+        [](FrameGraph::Builder &builder) {
+            builder.writeDepthTested(FrameGraph::TARGET_COLOR);
+            builder.writeDepthTested(FrameGraph::TARGET_DEPTH);
+        },
+        [this]() { executePass(frames[executeSlot].pieces); }, 0);
+
+    // Der Hintergrund liegt auf der Far-Plane und testet gegen die Tiefe der Szene, läuft
+    // also nach ihr und füllt nur die freien Pixel (statt vorher den ganzen Bildschirm)
+    frameGraph.addPass("background",
+        [](FrameGraph::Builder &builder) {
+            builder.read(FrameGraph::TARGET_DEPTH);
+            builder.writeDepthTested(FrameGraph::TARGET_COLOR);
+        },
+        [this]() { executePass(frames[executeSlot].background); });
+}
+
+void Scene::destroy()
+{
+    profiler.flush();
+    profiler.destroy();
+
+    // Aufgezeichnete Listen halten Texturen fest, die sonst mit den Brettern freigegeben werden
+    for (auto &frame : frames) {
+        frame.setup.clear();
+        frame.boards.clear();
+        frame.pieces.clear();
+        frame.background.clear();
+    }
+
+    for (auto board : boards)
+        board->uninitGL();
+
+    delete pieceRenderer;
+    streamBuffer.destroy();
+    frameGraph.destroy();
+    for (auto figur : figuren)
+        delete figur;
+    figuren.clear();
+    pieceStates.clear();
+    fieldPieces.clear();
+    animator.getTweens().clear();
+    for (auto board : boards)
+        delete board;   // Spielfelder löschen
+    boards.clear();
+    delete background;  // Hintergrund löschen
+    delete camera;
+
+    pieceRenderer = nullptr;
+    background = nullptr;
+    camera = nullptr;
+}
+
+void Scene::resize(int width, int height)
+{
+    // Minimierte Fenster liefern 0x0
+    if (width <= 0 || height <= 0)
+        return;
+    if (camera)
+        camera->setViewport(width, height);
+    // Viewport und Frame-Graph gehören dem GL-Thread, sie ändern sich mit dem nächsten Frame
+    pendingWidth = width;
+    pendingHeight = height;
+}
+
+void Scene::update(float dt)
+{
+    for (auto board : boards)
+        board->update(dt);
+    animator.update(dt, figuren);
+}
+
+void Scene::interpolate(float alpha)
+{
+    for (auto board : boards)
+        board->interpolate(alpha);
+    animator.interpolate(alpha, figuren);
+}
+
+void Scene::render()
+{
+    execute(record());
+}
+
+void Scene::renderAsync(RenderThread &renderThread, const std::function<void()> &present)
+{
+    const unsigned int slot = record();
+    renderThread.submit([this, slot, present]() {
+        execute(slot);
+        if (present)
+            present();
+    });
+}
+
+unsigned int Scene::record()
+{
+    // Der Satz, der vor NUM_FRAME_SLOTS Frames aufgezeichnet wurde, ist fertig abgespielt
+    recordSlot = (recordSlot + 1) % NUM_FRAME_SLOTS;
+    FrameCommands &frame = frames[recordSlot];
+    frame.setup.clear();
+    frame.boards.clear();
+    frame.pieces.clear();
+    frame.background.clear();
+
+    if (pendingWidth > 0) {
+        const int width = pendingWidth, height = pendingHeight;
+        frame.setup.call([this, width, height]() {
+            glViewport(0, 0, width, height);
+            frameGraph.setTargetSize(width, height);
+        });
+        pendingWidth = pendingHeight = 0;
+    }
+    camera->update(frame.setup);   // Kameramatrizen nur bei Änderung neu hochladen
+
+    // Jeder Pass zeichnet seine Draw-Items auf, beim Abspielen sortiert die Queue sie nach
+    // Programm, Textur, VAO und Tiefe und spart redundante Binds
+    recordBoards(frame.boards);
+    recordPieces(frame.pieces);
+    background->record(frame.background);
+    frame.background.flush();
+
+    recordedCommands = recordedBytes = 0;
+    for (const CommandList *commands : { &frame.setup, &frame.boards, &frame.pieces, &frame.background }) {
+        recordedCommands += commands->getNumCommands();
+        recordedBytes += commands->getDataBytes();
+    }
+    return recordSlot;
+}
+
+void Scene::execute(unsigned int slot)
+{
+    profiler.beginFrame();
+    streamBuffer.beginFrame();
+    frameStats = RenderQueueStats();
+    executeSlot = slot;
+
+    TextureManager::get().update();  // fertig geladene Texturen hochladen, Budget einhalten
+    executePass(frames[slot].setup);
+
+    // Die Passes spielen ihre Listen ab, das Ziel löscht der Frame-Graph
+    frameGraph.execute();
+
+    streamBuffer.endFrame();
+    profiler.endFrame();
+}
+
+void Scene::finishLoading()
+{
+    TextureManager::get().update(true);
+}
+
+void Scene::recordBoards(CommandList &commands)
+{
+    // Nur Bretter einreihen, deren Bounding-Sphere das Sichtvolumen schneidet
+    Frustum frustum;
+    frustum.setMatrix(glm::value_ptr(camera->getViewProjection()));
+    boardBounds.clear();
+    for (auto board : boards) {
+        const glm::vec4 bounds = board->getWorldBounds();
+        boardBounds.add(bounds.x, bounds.y, bounds.z, bounds.w);
+    }
+    boardVisible.resize(boards.size());
+    numCulledBoards = boards.size() - frustum.cull(boardBounds, boardVisible.data());
+
+    for (size_t i = 0; i < boards.size(); i++) {
+        if (boardVisible[i])
+            boards[i]->record(commands, camera->getView()); // Das Spielfeld rendern!
+    }
+    commands.flush();
+}
+
+void Scene::recordPieces(CommandList &commands)
+{
+    // Zeichne alle Figuren gebündelt (finale Modellmatrix = boardMatrix * lokaler Transform,
+    // berechnet vom Szenengraph nur für geänderte Teilbäume)
+    updateSceneGraph();
+    pieceRenderer->record(commands, figuren, sceneGraph, *camera);
+    commands.flush();
+}
+
+void Scene::updateSceneGraph()
+{
+    sceneGraph.update();
+    picker.invalidate(sceneGraph.getChangedFirst(), sceneGraph.getChangedCount());
+}
+
+PickResult Scene::pick(float x, float y)
+{
+    // Dieselben Weltmatrizen wie der nächste Frame (interpolierte Lage der Bretter)
+    updateSceneGraph();
+    if (!picker.isBuilt())
+        picker.build(boards, figuren, sceneGraph, pieceRenderer->getPieceBounds());
+
+    glm::vec3 origin, direction;
+    camera->getRay(x, y, origin, direction);
+    return picker.pick(origin, direction, sceneGraph);
+}
+
+int Scene::fieldOf(const PieceState &state, int progress) const
+{
+    if (progress == PROGRESS_HOME)
+        return BoardLayout::homeField(state.player, state.homeIndex);
+    if (progress >= PROGRESS_GOAL)
+        return BoardLayout::goalField(state.player, progress - PROGRESS_GOAL);
+    return BoardLayout::trackField(BoardLayout::getStartField(state.player) + progress);
+}
+
+int Scene::getPieceField(int piece) const
+{
+    if (piece < 0 || piece >= (int)pieceStates.size() || pieceStates[piece].progress == PROGRESS_NONE)
+        return -1;
+    return fieldOf(pieceStates[piece], pieceStates[piece].progress);
+}
+
+bool Scene::movePiece(int piece, int steps)
+{
+    if (piece < 0 || piece >= (int)pieceStates.size() || steps <= 0)
+        return false;
+    PieceState &state = pieceStates[piece];
+    if (state.progress == PROGRESS_NONE)
+        return false;
+
+    const int target = state.progress == PROGRESS_HOME ? 0 : state.progress + steps;
+    if (target >= PROGRESS_GOAL + BoardLayout::FIELDS_PER_PLAYER)
+        return false;
+    int* occupant = &fieldPieces[state.board * BoardLayout::NUM_FIELDS + fieldOf(state, target)];
+    if (*occupant >= 0 && pieceStates[*occupant].player == state.player)
+        return false;
+
+    // Ein Sprung je Feld; läuft noch ein Zug, werden die Sprünge an ihn angehängt und
+    // beginnen auf seinem Zielfeld
+    std::vector<glm::vec3> path;
+    for (int progress = state.progress + 1; progress <= target; progress++)
+        path.push_back(BoardLayout::getPosition(fieldOf(state, progress)));
+    const int field = fieldOf(state, state.progress);
+    const float landing = animator.hop(piece, BoardLayout::getPosition(field), path);
+
+    if (*occupant >= 0) {
+        // geschlagen: landet erst auf seinem Feld, steht, bis der Schlagende landet, und
+        // fliegt dann in sein Haus
+        const int victim = *occupant;
+        PieceState &victimState = pieceStates[victim];
+        const glm::vec3 victimFrom = BoardLayout::getPosition(fieldOf(victimState, victimState.progress));
+        victimState.progress = PROGRESS_HOME;
+        const int home = fieldOf(victimState, PROGRESS_HOME);
+        fieldPieces[victimState.board * BoardLayout::NUM_FIELDS + home] = victim;
+        animator.knockBack(victim, victimFrom, BoardLayout::getPosition(home), landing);
+    }
+
+    fieldPieces[state.board * BoardLayout::NUM_FIELDS + field] = -1;
+    *occupant = piece;
+    state.progress = target;
+    return true;
+}
+
+void Scene::executePass(const CommandList &commands)
+{
+    commands.execute(renderQueue, &frameStats);
+}
+
+size_t Scene::getUploadedBytes() const
+{
+    size_t bytes = 0;
+    if (camera) bytes += camera->getUploadedBytes();
+    if (pieceRenderer) bytes += pieceRenderer->getUploadedBytes();
+    return bytes;
+}
+
+// Bretter in einem quadratischen Raster um den Ursprung anlegen; die Kamera wird so
+// weit zurückgesetzt, dass alle sichtbar sind
+void Scene::createBoards(int numBoards)
+{
+    const float spacing = 6.0f;  // Brett ist 5 Einheiten breit (skaliert im Board-Konstruktor)
+    int columns = 1;
+    while (columns * columns < numBoards)
+        columns++;
+    int rows = (std::max(numBoards, 1) + columns - 1) / columns;
+
+    for (int i = 0; i < std::max(numBoards, 1); i++) {
+        Board* board = new Board();
+        board->initGL();
+        board->attachToScene(&sceneGraph);
+        if (numBoards > 1) {
+            board->translate(glm::vec3(((i % columns) - 0.5f * (columns - 1)) * spacing,
+                                       ((i / columns) - 0.5f * (rows - 1)) * spacing, 0.0f));
+        }
+        boards.push_back(board);
+    }
+
+    if (columns > 1) {
+        camera->lookAt(glm::vec3(0.0f, 3.0f, 10.0f) * (float)columns, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        camera->setPerspective(45.0f, 0.1f, 100.0f * columns);
+    }
+}
+
+// Erzeuge die Figuren und weise ihnen Position und Farbe zu: die ersten 16 Figuren eines
+// Brettes stehen in den Startfeldern, weitere (nur im Benchmark) zufällig auf dem Brett
+void Scene::createFiguren(int numPieces)
+{
+    // Definiere Farben:
+    glm::vec3 red   = glm::vec3(0.85f, 0.0f, 0.0f);
+    glm::vec3 green = glm::vec3(0.0f, 0.70f, 0.0f);
+    glm::vec3 yellow= glm::vec3(0.95f, 0.95f, 0.0f);
+    glm::vec3 blue  = glm::vec3(0.0f, 0.5f, 0.9f);
+    const glm::vec3 colors[4] = { red, green, yellow, blue };
+
+
+    // einfacher LCG, damit jeder Lauf dieselbe Szene erzeugt
+    unsigned int seed = 12345u;
+    auto random = [&seed]() {
+        seed = seed * 1664525u + 1013904223u;
+        return (seed >> 8) / 16777216.0f;  // 0 .. 1
+    };
+
+    fieldPieces.assign(boards.size() * BoardLayout::NUM_FIELDS, -1);
+    for (int i = 0; i < numPieces; i++) {
+        const size_t boardIndex = i % boards.size();
+        const int indexOnBoard = i / (int)boards.size();
+
+        glm::vec3 pos;
+        glm::vec3 color;
+        PieceState state;
+        state.board = (int)boardIndex;
+        if (indexOnBoard < 16) {
+            state.player = indexOnBoard / 4;
+            state.homeIndex = indexOnBoard % 4;
+            state.progress = PROGRESS_HOME;
+            const int home = BoardLayout::homeField(state.player, state.homeIndex);
+            fieldPieces[boardIndex * BoardLayout::NUM_FIELDS + home] = i;
+            pos = BoardLayout::getPosition(home);
+            color = colors[state.player];
+        }
+        else {
+            state.player = indexOnBoard % 4;
+            state.homeIndex = 0;
+            state.progress = PROGRESS_NONE;
+            pos = glm::vec3(random() * 0.9f - 0.45f, random() * 0.9f - 0.45f, 0.0f);
+            color = colors[indexOnBoard % 4];
+        }
+        pieceStates.push_back(state);
+
+        Figur* figur = new Figur();
+        // Setze den lokalen Transform als Translation (Figur auf ein Zehntel skaliert)
+        figur->attachToScene(&sceneGraph, boards[boardIndex]->getNode());
+        figur->setLocalTransform(PieceAnimator::pieceTransform(pos));
+        figur->setColor(color);
+        figuren.push_back(figur);
+    }
+}
@@ -0,0 +1,81 @@
+#include "SceneGraph.h"
+
+#include <iostream>
+
+
+SceneGraph::SceneGraph()
+    : anyDirty(false), changedFirst(0), changedCount(0), version(0)
+{
+}
+
+SceneGraph::NodeId SceneGraph::createNode(NodeId parent)
+{
+    if (parent != INVALID_NODE && parent >= parents.size())
+    {
+        std::cerr << "Fehler: Elternknoten " << parent << " existiert nicht!" << std::endl;
+        parent = INVALID_NODE;
+    }
+
+    NodeId node = static_cast<NodeId>(parents.size());
+    parents.push_back(parent);
+    locals.push_back(glm::mat4(1.0f));
+    worlds.push_back(glm::mat4(1.0f));
+    dirty.push_back(1);
+    changed.push_back(0);
+    anyDirty = true;
+    return node;
+}
+
+void SceneGraph::setLocalTransform(NodeId node, const glm::mat4 &local)
+{
+    locals[node] = local;
+    dirty[node] = 1;
+    anyDirty = true;
+}
+
+void SceneGraph::invalidate(NodeId node)
+{
+    dirty[node] = 1;
+    anyDirty = true;
+}
+
+size_t SceneGraph::update()
+{
+    changedCount = 0;
+    if (!anyDirty)
+        return 0;
+
+    // Eltern liegen vor ihren Kindern, daher genügt ein Durchlauf: ein Knoten wird neu
+    // berechnet, wenn er selbst oder sein Elternknoten in diesem Durchlauf geändert wurde
+    size_t updated = 0;
+    NodeId first = INVALID_NODE, last = 0;
+    const NodeId count = static_cast<NodeId>(parents.size());
+    for (NodeId i = 0; i < count; ++i)
+    {
+        const NodeId parent = parents[i];
+        const bool parentChanged = parent != INVALID_NODE && changed[parent];
+        if (!dirty[i] && !parentChanged)
+        {
+            changed[i] = 0;
+            continue;
+        }
+
+        worlds[i] = parent != INVALID_NODE ? worlds[parent] * locals[i] : locals[i];
+        dirty[i] = 0;
+        changed[i] = 1;
+        updated++;
+
+        if (first == INVALID_NODE)
+            first = i;
+        last = i;
+    }
+
+    anyDirty = false;
+    if (updated)
+    {
+        changedFirst = first;
+        changedCount = last - first + 1;
+        version++;
+    }
+    return updated;
+}
@@ -0,0 +1,215 @@
+#include "GLRender/BVH.h"
+
+#include <algorithm>
+#include <limits>
+
+
+
+BVH::Ray::Ray( const float* pfOrigin, const float* pfDir )
+{
+  for( int a = 0; a < 3; a++ )
+  {
+    afOrigin[a] = pfOrigin[a];
+    afDir[a]    = pfDir[a];
+    // a zero component gives +-infinity, the slab test then only checks the origin
+    afInvDir[a] = 1.0f / pfDir[a];
+  }
+}
+
+
+
+// constructor
+BVH::BVH()
+  : m_uiDepth( 0 )
+{
+}
+
+
+void
+BVH::clear()
+{
+  m_cBoxes.clear();
+  m_cNodes.clear();
+  m_cIndices.clear();
+  m_cParents.clear();
+  m_cLeaves.clear();
+  m_cDirty.clear();
+  m_cLeafDirty.clear();
+  m_uiDepth = 0;
+}
+
+
+void
+BVH::build( const std::vector<Box>& rcBoxes )
+{
+  clear();
+  if( rcBoxes.empty() ) return;
+
+  const uint32_t uiCount = (uint32_t)rcBoxes.size();
+  m_cBoxes = rcBoxes;
+  m_cLeaves.resize( uiCount );
+  m_cIndices.resize( uiCount );
+  std::vector<float> cCentres( (size_t)uiCount * 3 );
+  for( uint32_t i = 0; i < uiCount; i++ )
+  {
+    m_cIndices[i] = i;
+    for( int a = 0; a < 3; a++ ) cCentres[i * 3 + a] = 0.5f * ( rcBoxes[i].afMin[a] + rcBoxes[i].afMax[a] );
+  }
+
+  // a binary tree with leaves of at most MAX_LEAF_SIZE primitives has fewer than 2n nodes
+  m_cNodes.reserve( 2 * ( ( uiCount + MAX_LEAF_SIZE - 1 ) / MAX_LEAF_SIZE ) );
+  m_cNodes.resize( 1 );
+  m_cParents.assign( 1, ~0u );
+  buildNode( 0, 0, uiCount, 1, cCentres );
+  m_cLeafDirty.assign( m_cNodes.size(), 0 );
+}
+
+
+void
+BVH::buildNode( uint32_t uiNode, uint32_t uiFirst, uint32_t uiCount, uint32_t uiDepth, const std::vector<float>& rcCentres )
+{
+  m_uiDepth = std::max( m_uiDepth, uiDepth );
+
+  if( uiCount <= MAX_LEAF_SIZE )
+  {
+    m_cNodes[uiNode].uiFirst = uiFirst;
+    m_cNodes[uiNode].uiCount = uiCount;
+    for( uint32_t i = 0; i < uiCount; i++ ) m_cLeaves[m_cIndices[uiFirst + i]] = uiNode;
+    fitLeaf( uiNode );
+    return;
+  }
+
+  // split at the median of the centres along the axis in which they spread most; the
+  // halves differ by at most one primitive, so the depth stays logarithmic
+  float afMin[3], afMax[3];
+  for( int a = 0; a < 3; a++ )
+  {
+    afMin[a] =  std::numeric_limits<float>::max();
+    afMax[a] = -std::numeric_limits<float>::max();
+  }
+  for( uint32_t i = 0; i < uiCount; i++ )
+  {
+    const float* pfCentre = &rcCentres[(size_t)m_cIndices[uiFirst + i] * 3];
+    for( int a = 0; a < 3; a++ )
+    {
+      afMin[a] = std::min( afMin[a], pfCentre[a] );
+      afMax[a] = std::max( afMax[a], pfCentre[a] );
+    }
+  }
+  int iAxis = 0;
+  if( afMax[1] - afMin[1] > afMax[iAxis] - afMin[iAxis] ) iAxis = 1;
+  if( afMax[2] - afMin[2] > afMax[iAxis] - afMin[iAxis] ) iAxis = 2;
+
+  const uint32_t uiHalf = uiCount / 2;
+  uint32_t* puiIndices = &m_cIndices[uiFirst];
+  std::nth_element( puiIndices, puiIndices + uiHalf, puiIndices + uiCount,
+                    [&rcCentres, iAxis]( uint32_t uiA, uint32_t uiB ) { return rcCentres[(size_t)uiA * 3 + iAxis] < rcCentres[(size_t)uiB * 3 + iAxis]; } );
+
+  // children are stored next to each other
+  const uint32_t uiLeft = (uint32_t)m_cNodes.size();
+  m_cNodes.resize( uiLeft + 2 );
+  m_cParents.resize( uiLeft + 2, uiNode );
+  m_cNodes[uiNode].uiFirst = uiLeft;
+  m_cNodes[uiNode].uiCount = 0;
+
+  buildNode( uiLeft, uiFirst, uiHalf, uiDepth + 1, rcCentres );
+  buildNode( uiLeft + 1, uiFirst + uiHalf, uiCount - uiHalf, uiDepth + 1, rcCentres );
+  fitInner( uiNode );
+}
+
+
+void
+BVH::fitLeaf( uint32_t uiNode )
+{
+  Node& rcNode = m_cNodes[uiNode];
+  const Box& rcFirst = m_cBoxes[m_cIndices[rcNode.uiFirst]];
+  for( int a = 0; a < 3; a++ )
+  {
+    rcNode.afMin[a] = rcFirst.afMin[a];
+    rcNode.afMax[a] = rcFirst.afMax[a];
+  }
+  for( uint32_t i = 1; i < rcNode.uiCount; i++ )
+  {
+    const Box& rcBox = m_cBoxes[m_cIndices[rcNode.uiFirst + i]];
+    for( int a = 0; a < 3; a++ )
+    {
+      rcNode.afMin[a] = std::min( rcNode.afMin[a], rcBox.afMin[a] );
+      rcNode.afMax[a] = std::max( rcNode.afMax[a], rcBox.afMax[a] );
+    }
+  }
+}
+
+
+void
+BVH::fitInner( uint32_t uiNode )
+{
+  Node& rcNode = m_cNodes[uiNode];
+  const Node& rcLeft  = m_cNodes[rcNode.uiFirst];
+  const Node& rcRight = m_cNodes[rcNode.uiFirst + 1];
+  for( int a = 0; a < 3; a++ )
+  {
+    rcNode.afMin[a] = std::min( rcLeft.afMin[a], rcRight.afMin[a] );
+    rcNode.afMax[a] = std::max( rcLeft.afMax[a], rcRight.afMax[a] );
+  }
+}
+
+
+void
+BVH::setBox( uint32_t uiPrimitive, const Box& rcBox )
+{
+  m_cBoxes[uiPrimitive] = rcBox;
+  const uint32_t uiLeaf = m_cLeaves[uiPrimitive];
+  if( !m_cLeafDirty[uiLeaf] )
+  {
+    m_cLeafDirty[uiLeaf] = 1;
+    m_cDirty.push_back( uiLeaf );
+  }
+}
+
+
+size_t
+BVH::refit()
+{
+  size_t uiVisited = 0;
+  for( uint32_t uiLeaf : m_cDirty )
+  {
+    m_cLeafDirty[uiLeaf] = 0;
+    fitLeaf( uiLeaf );
+    uiVisited++;
+
+    // walk up while the boxes change; a parent whose box stays the same was already
+    // refit for another leaf, or does not need it
+    for( uint32_t uiNode = m_cParents[uiLeaf]; uiNode != ~0u; uiNode = m_cParents[uiNode] )
+    {
+      const Node cOld = m_cNodes[uiNode];
+      fitInner( uiNode );
+      uiVisited++;
+      const Node& rcNew = m_cNodes[uiNode];
+      bool bChanged = false;
+      for( int a = 0; a < 3; a++ ) bChanged |= cOld.afMin[a] != rcNew.afMin[a] || cOld.afMax[a] != rcNew.afMax[a];
+      if( !bChanged ) break;
+    }
+  }
+  m_cDirty.clear();
+  return uiVisited;
+}
+
+
+bool
+BVH::intersectBox( const Ray& rcRay, const float* pfMin, const float* pfMax, float fMaxT, float& rfEntry )
+{
+  float fNear = 0.0f;
+  float fFar  = fMaxT;
+  for( int a = 0; a < 3; a++ )
+  {
+    float fT0 = ( pfMin[a] - rcRay.afOrigin[a] ) * rcRay.afInvDir[a];
+    float fT1 = ( pfMax[a] - rcRay.afOrigin[a] ) * rcRay.afInvDir[a];
+    if( fT0 > fT1 ) std::swap( fT0, fT1 );
+    // written so that NaN (origin on a slab plane, zero direction) leaves the interval unchanged
+    fNear = fT0 > fNear ? fT0 : fNear;
+    fFar  = fT1 < fFar  ? fT1 : fFar;
+    if( fNear > fFar ) return false;
+  }
+  rfEntry = fNear;
+  return true;
+}
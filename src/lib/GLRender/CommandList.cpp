@@ -0,0 +1,147 @@
+#include "GLRender/CommandList.h"
+
+#include <cstring>
+
+
+
+// constructor
+CommandList::CommandList()
+{
+}
+
+
+void
+CommandList::draw( const DrawItem& rcItem, const TextureHandle& rcTexture )
+{
+  Command cCommand;
+  cCommand.eType   = CMD_DRAW;
+  cCommand.uiIndex = (uint32_t)m_cItems.size();
+  m_cCommands.push_back( cCommand );
+  m_cItems.push_back( rcItem );
+  m_cTextures.push_back( rcTexture );
+}
+
+
+void
+CommandList::flush()
+{
+  Command cCommand;
+  cCommand.eType = CMD_FLUSH;
+  m_cCommands.push_back( cCommand );
+}
+
+
+void
+CommandList::bufferSubData( GLenum eTarget, GLuint uiBuffer, GLintptr iOffset, const void* pvData, size_t uiSize )
+{
+  Command cCommand;
+  cCommand.eType        = CMD_BUFFER_SUB_DATA;
+  cCommand.eTarget      = eTarget;
+  cCommand.uiBuffer     = uiBuffer;
+  cCommand.iOffset      = iOffset;
+  cCommand.uiDataOffset = addData( pvData, uiSize );
+  cCommand.uiDataSize   = uiSize;
+  m_cCommands.push_back( cCommand );
+}
+
+
+void
+CommandList::upload( const void* pvData, size_t uiSize, const std::function<void( const void*, size_t )>& fnUpload )
+{
+  Command cCommand;
+  cCommand.eType        = CMD_UPLOAD;
+  cCommand.uiIndex      = (uint32_t)m_cUploads.size();
+  cCommand.uiDataOffset = addData( pvData, uiSize );
+  cCommand.uiDataSize   = uiSize;
+  m_cCommands.push_back( cCommand );
+  m_cUploads.push_back( fnUpload );
+}
+
+
+void
+CommandList::call( const std::function<void()>& fnCall )
+{
+  Command cCommand;
+  cCommand.eType   = CMD_CALL;
+  cCommand.uiIndex = (uint32_t)m_cCalls.size();
+  m_cCommands.push_back( cCommand );
+  m_cCalls.push_back( fnCall );
+}
+
+
+size_t
+CommandList::addData( const void* pvData, size_t uiSize )
+{
+  // offsets are multiples of 16 bytes, so that the data can be read as floats or vectors in place
+  const size_t uiOffset = ( m_cData.size() + 15 ) & ~(size_t)15;
+  m_cData.resize( uiOffset + uiSize );
+  if( uiSize ) std::memcpy( &m_cData[uiOffset], pvData, uiSize );
+  return uiOffset;
+}
+
+
+void
+CommandList::execute( RenderQueue& rcQueue, RenderQueueStats* pcStats ) const
+{
+  bool bPending = false;
+
+  auto fnFlush = [&]()
+  {
+    rcQueue.execute();
+    bPending = false;
+    if( pcStats )
+    {
+      const RenderQueueStats& rcStats = rcQueue.getStats();
+      pcStats->uiItems             += rcStats.uiItems;
+      pcStats->uiDrawCalls         += rcStats.uiDrawCalls;
+      pcStats->uiStateChanges      += rcStats.uiStateChanges;
+      pcStats->uiSavedStateChanges += rcStats.uiSavedStateChanges;
+    }
+  };
+
+  for( const Command& rcCommand : m_cCommands )
+  {
+    switch( rcCommand.eType )
+    {
+    case CMD_DRAW:
+      if( m_cTextures[rcCommand.uiIndex] )
+      {
+        DrawItem cItem = m_cItems[rcCommand.uiIndex];
+        cItem.uiTexture = m_cTextures[rcCommand.uiIndex]->use();
+        rcQueue.submit( cItem );
+      }
+      else rcQueue.submit( m_cItems[rcCommand.uiIndex] );
+      bPending = true;
+      break;
+    case CMD_FLUSH:
+      fnFlush();
+      break;
+    case CMD_BUFFER_SUB_DATA:
+      glBindBuffer( rcCommand.eTarget, rcCommand.uiBuffer );
+      glBufferSubData( rcCommand.eTarget, rcCommand.iOffset, (GLsizeiptr)rcCommand.uiDataSize, &m_cData[rcCommand.uiDataOffset] );
+      glBindBuffer( rcCommand.eTarget, 0 );
+      break;
+    case CMD_UPLOAD:
+      m_cUploads[rcCommand.uiIndex]( rcCommand.uiDataSize ? &m_cData[rcCommand.uiDataOffset] : NULL, rcCommand.uiDataSize );
+      break;
+    case CMD_CALL:
+      m_cCalls[rcCommand.uiIndex]();
+      break;
+    }
+  }
+
+  // draws recorded after the last flush
+  if( bPending ) fnFlush();
+}
+
+
+void
+CommandList::clear()
+{
+  m_cCommands.clear();
+  m_cItems.clear();
+  m_cTextures.clear();
+  m_cUploads.clear();
+  m_cCalls.clear();
+  m_cData.clear();
+}
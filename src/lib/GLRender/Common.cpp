@@ -64,3 +64,43 @@ int loadPNG(const std::string cFName, std::vector<unsigned char>& rcImgData, uns
 }
 
 
+
+
+
+int savePNG(const std::string cFName, const std::vector<unsigned char>& rcImgData, unsigned int uiWidth, unsigned int uiHeight)
+{
+  //encode RGBA
+  unsigned int error = lodepng::encode( cFName, rcImgData, uiWidth, uiHeight );
+
+  if(error)
+  {
+    std::cout << "cannot write image " << cFName << " error: " << error << ": " << lodepng_error_text(error) << std::endl;
+    return -1;
+  }
+
+  return 0;
+}
+
+
+
+
+
+std::string getJsonString( const std::string& rcStr )
+{
+  static const char acHex[] = "0123456789abcdef";
+
+  std::string cResult = "\"";
+  for( char c : rcStr )
+  {
+    if( c == '"' || c == '\\' ) { cResult += '\\'; cResult += c; }
+    else if( (unsigned char)c < 0x20 )
+    {
+      // control characters only as \u escapes
+      cResult += "\\u00";
+      cResult += acHex[( (unsigned char)c >> 4 ) & 0xf];
+      cResult += acHex[(unsigned char)c & 0xf];
+    }
+    else cResult += c;
+  }
+  return cResult + "\"";
+}
@@ -0,0 +1,69 @@
+#include "GLRender/FixedTimestep.h"
+
+#include <cmath>
+
+
+
+// constructor
+FixedTimestep::FixedTimestep( double dTicksPerSecond, unsigned int uiMaxTicksPerFrame )
+  : m_dStep( 1.0 / 60.0 )
+  , m_dAccumulator( 0.0 )
+  , m_uiMaxTicks( 1 )
+  , m_uiNumTicks( 0 )
+  , m_uiNumDropped( 0 )
+  , m_cLast( std::chrono::steady_clock::now() )
+{
+  setTickRate( dTicksPerSecond );
+  setMaxTicksPerFrame( uiMaxTicksPerFrame );
+}
+
+
+void
+FixedTimestep::setTickRate( double dTicksPerSecond )
+{
+  if( !( dTicksPerSecond > 0.0 ) ) return;
+  m_dStep        = 1.0 / dTicksPerSecond;
+  m_dAccumulator = 0.0;
+}
+
+
+unsigned int
+FixedTimestep::advance( double dElapsedSeconds )
+{
+  if( dElapsedSeconds > 0.0 ) m_dAccumulator += dElapsedSeconds;
+
+  double dTicks = std::floor( m_dAccumulator / m_dStep );
+  if( dTicks > (double)m_uiMaxTicks )
+  {
+    // keep the fraction, so the interpolation does not jump
+    m_uiNumDropped += (uint64_t)( dTicks - m_uiMaxTicks );
+    dTicks = m_uiMaxTicks;
+    m_dAccumulator = std::fmod( m_dAccumulator, m_dStep ) + dTicks * m_dStep;
+  }
+
+  const unsigned int uiTicks = (unsigned int)dTicks;
+  m_dAccumulator -= uiTicks * m_dStep;
+  // rounding must not leave a full step behind or go negative
+  if( m_dAccumulator < 0.0 ) m_dAccumulator = 0.0;
+  if( m_dAccumulator >= m_dStep ) m_dAccumulator = std::nextafter( m_dStep, 0.0 );
+  m_uiNumTicks += uiTicks;
+  return uiTicks;
+}
+
+
+unsigned int
+FixedTimestep::advance()
+{
+  const std::chrono::steady_clock::time_point cNow = std::chrono::steady_clock::now();
+  const double dElapsed = std::chrono::duration<double>( cNow - m_cLast ).count();
+  m_cLast = cNow;
+  return advance( dElapsed );
+}
+
+
+void
+FixedTimestep::reset()
+{
+  m_dAccumulator = 0.0;
+  m_cLast        = std::chrono::steady_clock::now();
+}
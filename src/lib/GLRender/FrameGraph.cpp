@@ -0,0 +1,456 @@
+#include "GLRender/FrameGraph.h"
+#include "GLRender/Profiler.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <set>
+
+
+
+bool
+FrameGraphTextureDesc::isDepth() const
+{
+  return eInternalFormat == GL_DEPTH_COMPONENT16 || eInternalFormat == GL_DEPTH_COMPONENT24 ||
+         eInternalFormat == GL_DEPTH_COMPONENT32F || eInternalFormat == GL_DEPTH24_STENCIL8 ||
+         eInternalFormat == GL_DEPTH_COMPONENT;
+}
+
+
+
+void
+FrameGraph::Builder::read( FrameGraphResource uiResource )
+{
+  m_rcGraph.addAccess( m_uiPass, uiResource, ACCESS_READ );
+}
+
+
+void
+FrameGraph::Builder::write( FrameGraphResource uiResource )
+{
+  m_rcGraph.addAccess( m_uiPass, uiResource, ACCESS_WRITE );
+}
+
+
+void
+FrameGraph::Builder::writeDepthTested( FrameGraphResource uiResource )
+{
+  m_rcGraph.addAccess( m_uiPass, uiResource, ACCESS_WRITE_DEPTH_TESTED );
+}
+
+
+
+// constructor
+FrameGraph::FrameGraph()
+  : m_bDirty( true )
+  , m_iWidth( 1 )
+  , m_iHeight( 1 )
+  , m_pcProfiler( NULL )
+{
+  // the target is imported, it is neither created nor released by the graph
+  Resource cColor;
+  cColor.cName      = "target.color";
+  cColor.bTransient = false;
+  cColor.uiTexture  = 0;
+  cColor.iLastUse   = -1;
+  m_cResources.push_back( cColor );
+
+  Resource cDepth = cColor;
+  cDepth.cName = "target.depth";
+  cDepth.cDesc = FrameGraphTextureDesc( GL_DEPTH_COMPONENT24 );
+  m_cResources.push_back( cDepth );
+}
+
+
+// destructor
+FrameGraph::~FrameGraph()
+{
+  destroy();
+}
+
+
+void
+FrameGraph::setTargetSize( int iWidth, int iHeight )
+{
+  if( iWidth == m_iWidth && iHeight == m_iHeight ) return;
+  m_iWidth  = std::max( iWidth, 1 );
+  m_iHeight = std::max( iHeight, 1 );
+
+  // transient textures are sized relative to the target
+  freeTextures();
+}
+
+
+void
+FrameGraph::setProfiler( Profiler* pcProfiler )
+{
+  m_pcProfiler = pcProfiler;
+  for( size_t i = 0; i < m_cPasses.size(); i++ )
+  {
+    m_cPasses[i].uiScope = m_pcProfiler ? m_pcProfiler->registerScope( m_cPasses[i].cName ) : 0;
+  }
+}
+
+
+FrameGraphResource
+FrameGraph::createTexture( const std::string& rcName, const FrameGraphTextureDesc& rcDesc )
+{
+  Resource cResource;
+  cResource.cName      = rcName;
+  cResource.bTransient = true;
+  cResource.cDesc      = rcDesc;
+  cResource.uiTexture  = 0;
+  cResource.iLastUse   = -1;
+  m_cResources.push_back( cResource );
+  m_bDirty = true;
+  return (FrameGraphResource)( m_cResources.size() - 1 );
+}
+
+
+unsigned int
+FrameGraph::addPass( const std::string& rcName, const std::function<void( Builder& )>& fnSetup,
+                     const std::function<void()>& fnExecute, int iOrder )
+{
+  Pass cPass;
+  cPass.cName     = rcName;
+  cPass.fnExecute = fnExecute;
+  cPass.iOrder    = iOrder;
+  cPass.uiScope   = m_pcProfiler ? m_pcProfiler->registerScope( rcName ) : 0;
+  cPass.bCulled   = false;
+  m_cPasses.push_back( cPass );
+
+  unsigned int uiPass = (unsigned int)( m_cPasses.size() - 1 );
+  Builder cBuilder( *this, uiPass );
+  if( fnSetup ) fnSetup( cBuilder );
+
+  m_bDirty = true;
+  return uiPass;
+}
+
+
+void
+FrameGraph::addAccess( unsigned int uiPass, FrameGraphResource uiResource, Access eAccess )
+{
+  if( uiResource >= m_cResources.size() )
+  {
+    std::cerr << "frame graph: pass " << m_cPasses[uiPass].cName << " uses unknown resource " << uiResource << std::endl;
+    return;
+  }
+  m_cPasses[uiPass].cAccesses.push_back( std::make_pair( uiResource, eAccess ) );
+}
+
+
+void
+FrameGraph::compile()
+{
+  const size_t uiNumPasses = m_cPasses.size();
+
+  // dependencies, resolved in the order the passes were added
+  std::vector<std::set<unsigned int> > cDeps( uiNumPasses );
+  {
+    struct State
+    {
+      int                       iWriter = -1;       // last ordered writer
+      std::vector<unsigned int> cTestedWriters;     // depth tested writers since
+      std::vector<unsigned int> cReaders;           // readers since the last write
+    };
+    std::vector<State> cStates( m_cResources.size() );
+
+    for( unsigned int p = 0; p < uiNumPasses; p++ )
+    {
+      for( auto& rcAccess : m_cPasses[p].cAccesses )
+      {
+        State& rcState = cStates[rcAccess.first];
+        std::set<unsigned int>& rcDeps = cDeps[p];
+        if( rcState.iWriter >= 0 ) rcDeps.insert( (unsigned int)rcState.iWriter );
+
+        switch( rcAccess.second )
+        {
+        case ACCESS_READ:
+          rcDeps.insert( rcState.cTestedWriters.begin(), rcState.cTestedWriters.end() );
+          rcState.cReaders.push_back( p );
+          break;
+        case ACCESS_WRITE:
+          rcDeps.insert( rcState.cTestedWriters.begin(), rcState.cTestedWriters.end() );
+          rcDeps.insert( rcState.cReaders.begin(), rcState.cReaders.end() );
+          rcState.iWriter = (int)p;
+          rcState.cTestedWriters.clear();
+          rcState.cReaders.clear();
+          break;
+        case ACCESS_WRITE_DEPTH_TESTED:
+          rcDeps.insert( rcState.cReaders.begin(), rcState.cReaders.end() );
+          rcState.cTestedWriters.push_back( p );
+          break;
+        }
+        rcDeps.erase( p );
+      }
+    }
+  }
+
+  // cull passes whose writes nobody needs; the target is always needed
+  std::vector<bool> cNeeded( m_cResources.size(), false );
+  cNeeded[TARGET_COLOR] = cNeeded[TARGET_DEPTH] = true;
+  for( size_t p = uiNumPasses; p-- > 0; )
+  {
+    Pass& rcPass = m_cPasses[p];
+    rcPass.bCulled = true;
+    for( auto& rcAccess : rcPass.cAccesses )
+    {
+      if( rcAccess.second != ACCESS_READ && cNeeded[rcAccess.first] ) rcPass.bCulled = false;
+    }
+    if( rcPass.bCulled ) continue;
+    for( auto& rcAccess : rcPass.cAccesses )
+    {
+      if( rcAccess.second == ACCESS_READ ) cNeeded[rcAccess.first] = true;
+    }
+  }
+
+  // topological order, the dependencies always point to earlier passes; among the passes
+  // that are ready the lowest iOrder (then the first added) goes first
+  std::vector<unsigned int> cPending( uiNumPasses, 0 );
+  std::vector<std::vector<unsigned int> > cUsers( uiNumPasses );
+  for( unsigned int p = 0; p < uiNumPasses; p++ )
+  {
+    for( unsigned int uiDep : cDeps[p] )
+    {
+      cPending[p]++;
+      cUsers[uiDep].push_back( p );
+    }
+  }
+  auto cLess = [this]( unsigned int a, unsigned int b )
+  {
+    return m_cPasses[a].iOrder != m_cPasses[b].iOrder ? m_cPasses[a].iOrder < m_cPasses[b].iOrder : a < b;
+  };
+  std::set<unsigned int, decltype( cLess )> cReady( cLess );
+  for( unsigned int p = 0; p < uiNumPasses; p++ )
+  {
+    if( !cPending[p] ) cReady.insert( p );
+  }
+
+  m_cOrder.clear();
+  while( !cReady.empty() )
+  {
+    unsigned int p = *cReady.begin();
+    cReady.erase( cReady.begin() );
+    if( !m_cPasses[p].bCulled ) m_cOrder.push_back( p );
+    for( unsigned int uiUser : cUsers[p] )
+    {
+      if( !--cPending[uiUser] ) cReady.insert( uiUser );
+    }
+  }
+
+  // last use of every resource, transient textures are released after it
+  for( auto& rcResource : m_cResources ) rcResource.iLastUse = -1;
+  for( size_t i = 0; i < m_cOrder.size(); i++ )
+  {
+    for( auto& rcAccess : m_cPasses[m_cOrder[i]].cAccesses ) m_cResources[rcAccess.first].iLastUse = (int)i;
+  }
+
+  m_bDirty = false;
+}
+
+
+void
+FrameGraph::execute()
+{
+  if( m_bDirty ) compile();
+
+  GLint iTarget = 0;
+  glGetIntegerv( GL_DRAW_FRAMEBUFFER_BINDING, &iTarget );
+
+  std::vector<bool> cWritten( m_cResources.size(), false );
+
+  for( size_t i = 0; i < m_cOrder.size(); i++ )
+  {
+    Pass& rcPass = m_cPasses[m_cOrder[i]];
+
+    // textures come alive with their first use
+    GLuint uiColor = 0, uiDepth = 0;
+    bool   bTarget = false;
+    GLbitfield uiClear = 0;
+    float  fScale = 0.0f;     // size scale of the written transient textures, 0 until one is seen
+    for( auto& rcAccess : rcPass.cAccesses )
+    {
+      Resource& rcResource = m_cResources[rcAccess.first];
+      if( rcResource.bTransient && !rcResource.uiTexture ) rcResource.uiTexture = acquireTexture( rcResource.cDesc );
+      if( rcAccess.second == ACCESS_READ ) continue;
+
+      // clear at the first write of the frame
+      if( !cWritten[rcAccess.first] )
+      {
+        cWritten[rcAccess.first] = true;
+        if( !rcResource.bTransient ) uiClear |= GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT;
+        else uiClear |= rcResource.cDesc.isDepth() ? GL_DEPTH_BUFFER_BIT : GL_COLOR_BUFFER_BIT;
+        if( !rcResource.bTransient ) cWritten[TARGET_COLOR] = cWritten[TARGET_DEPTH] = true;
+      }
+
+      if( !rcResource.bTransient ) bTarget = true;
+      else
+      {
+        // color and depth attachments of one framebuffer must have the same size
+        assert( fScale == 0.0f || fScale == rcResource.cDesc.fSizeScale );
+        if( rcResource.cDesc.isDepth() ) uiDepth = rcResource.uiTexture;
+        else uiColor = rcResource.uiTexture;
+        fScale = rcResource.cDesc.fSizeScale;
+      }
+    }
+    if( fScale == 0.0f ) fScale = 1.0f;
+
+    // passes render either into the target or into transient textures
+    if( bTarget || ( !uiColor && !uiDepth ) )
+    {
+      if( bTarget && ( uiColor || uiDepth ) ) std::cerr << "frame graph: pass " << rcPass.cName << " writes target and transient resources" << std::endl;
+      glBindFramebuffer( GL_FRAMEBUFFER, (GLuint)iTarget );
+      glViewport( 0, 0, m_iWidth, m_iHeight );
+    }
+    else
+    {
+      glBindFramebuffer( GL_FRAMEBUFFER, getFramebuffer( uiColor, uiDepth ) );
+      glViewport( 0, 0, std::max( 1, (int)std::lround( m_iWidth * fScale ) ), std::max( 1, (int)std::lround( m_iHeight * fScale ) ) );
+    }
+    if( uiClear )
+    {
+      if( uiClear & GL_DEPTH_BUFFER_BIT ) glDepthMask( GL_TRUE );
+      glClear( uiClear );
+    }
+
+    if( m_pcProfiler )
+    {
+      ProfileScope cScope( *m_pcProfiler, rcPass.uiScope );
+      rcPass.fnExecute();
+    }
+    else rcPass.fnExecute();
+
+    // hand textures back to the pool after their last use, later passes may alias them
+    for( auto& rcAccess : rcPass.cAccesses )
+    {
+      Resource& rcResource = m_cResources[rcAccess.first];
+      if( rcResource.bTransient && rcResource.uiTexture && rcResource.iLastUse == (int)i )
+      {
+        releaseTexture( rcResource.uiTexture );
+        rcResource.uiTexture = 0;
+      }
+    }
+  }
+
+  glBindFramebuffer( GL_FRAMEBUFFER, (GLuint)iTarget );
+  glViewport( 0, 0, m_iWidth, m_iHeight );
+}
+
+
+GLuint
+FrameGraph::getTexture( FrameGraphResource uiResource ) const
+{
+  return uiResource < m_cResources.size() ? m_cResources[uiResource].uiTexture : 0;
+}
+
+
+void
+FrameGraph::printOrder( std::ostream& rcStream ) const
+{
+  rcStream << "frame graph:";
+  for( size_t i = 0; i < m_cOrder.size(); i++ ) rcStream << ( i ? " -> " : " " ) << m_cPasses[m_cOrder[i]].cName;
+  for( size_t p = 0; p < m_cPasses.size(); p++ )
+  {
+    if( m_cPasses[p].bCulled ) rcStream << " (culled: " << m_cPasses[p].cName << ")";
+  }
+  rcStream << std::endl;
+}
+
+
+void
+FrameGraph::destroy()
+{
+  freeTextures();
+}
+
+
+GLuint
+FrameGraph::acquireTexture( const FrameGraphTextureDesc& rcDesc )
+{
+  for( auto& rcPooled : m_cPool )
+  {
+    if( !rcPooled.bInUse && rcPooled.cDesc.eInternalFormat == rcDesc.eInternalFormat && rcPooled.cDesc.fSizeScale == rcDesc.fSizeScale )
+    {
+      rcPooled.bInUse = true;
+      return rcPooled.uiTexture;
+    }
+  }
+
+  // external format and type only matter for the (empty) upload
+  GLenum eFormat = GL_RGBA, eType = GL_UNSIGNED_BYTE;
+  if( rcDesc.eInternalFormat == GL_DEPTH24_STENCIL8 )
+  {
+    eFormat = GL_DEPTH_STENCIL;
+    eType   = GL_UNSIGNED_INT_24_8;
+  }
+  else if( rcDesc.isDepth() )
+  {
+    eFormat = GL_DEPTH_COMPONENT;
+    eType   = GL_FLOAT;
+  }
+  else if( rcDesc.eInternalFormat == GL_RGBA16F || rcDesc.eInternalFormat == GL_RGBA32F || rcDesc.eInternalFormat == GL_R11F_G11F_B10F )
+  {
+    eType = GL_FLOAT;
+  }
+
+  PooledTexture cPooled;
+  cPooled.cDesc  = rcDesc;
+  cPooled.bInUse = true;
+  glGenTextures( 1, &cPooled.uiTexture );
+  glBindTexture( GL_TEXTURE_2D, cPooled.uiTexture );
+  glTexImage2D( GL_TEXTURE_2D, 0, rcDesc.eInternalFormat,
+                std::max( 1, (int)std::lround( m_iWidth * rcDesc.fSizeScale ) ), std::max( 1, (int)std::lround( m_iHeight * rcDesc.fSizeScale ) ),
+                0, eFormat, eType, NULL );
+  glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
+  glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+  glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+  glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+  glBindTexture( GL_TEXTURE_2D, 0 );
+
+  m_cPool.push_back( cPooled );
+  return cPooled.uiTexture;
+}
+
+
+void
+FrameGraph::releaseTexture( GLuint uiTexture )
+{
+  for( auto& rcPooled : m_cPool )
+  {
+    if( rcPooled.uiTexture == uiTexture ) rcPooled.bInUse = false;
+  }
+}
+
+
+GLuint
+FrameGraph::getFramebuffer( GLuint uiColor, GLuint uiDepth )
+{
+  GLuint& ruiFBO = m_cFramebuffers[std::make_pair( uiColor, uiDepth )];
+  if( ruiFBO ) return ruiFBO;
+
+  glGenFramebuffers( 1, &ruiFBO );
+  glBindFramebuffer( GL_FRAMEBUFFER, ruiFBO );
+  if( uiColor ) glFramebufferTexture2D( GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, uiColor, 0 );
+  else          glDrawBuffer( GL_NONE );
+  if( uiDepth ) glFramebufferTexture2D( GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, uiDepth, 0 );
+
+  GLenum eStatus = glCheckFramebufferStatus( GL_FRAMEBUFFER );
+  if( eStatus != GL_FRAMEBUFFER_COMPLETE )
+  {
+    std::cerr << "frame graph: framebuffer incomplete: 0x" << std::hex << eStatus << std::dec << std::endl;
+  }
+  return ruiFBO;
+}
+
+
+void
+FrameGraph::freeTextures()
+{
+  for( auto i = m_cFramebuffers.begin(); i != m_cFramebuffers.end(); ++i ) glDeleteFramebuffers( 1, &i->second );
+  m_cFramebuffers.clear();
+  for( auto& rcPooled : m_cPool ) glDeleteTextures( 1, &rcPooled.uiTexture );
+  m_cPool.clear();
+  for( auto& rcResource : m_cResources ) rcResource.uiTexture = 0;
+}
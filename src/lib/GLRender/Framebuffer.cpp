@@ -0,0 +1,100 @@
+#include "GLRender/Framebuffer.h"
+#include "GLRender/PixelConvert.h"
+
+#include <iostream>
+
+
+
+// constructor
+Framebuffer::Framebuffer()
+  : m_uiFBO( 0 )
+  , m_uiColorRB( 0 )
+  , m_uiDepthRB( 0 )
+  , m_iWidth( 0 )
+  , m_iHeight( 0 )
+{
+}
+
+
+// destructor
+Framebuffer::~Framebuffer()
+{
+  destroy();
+}
+
+
+int
+Framebuffer::create( int iWidth, int iHeight )
+{
+  destroy();
+  m_iWidth  = iWidth;
+  m_iHeight = iHeight;
+
+  glGenFramebuffers( 1, &m_uiFBO );
+  glBindFramebuffer( GL_FRAMEBUFFER, m_uiFBO );
+
+  glGenRenderbuffers( 1, &m_uiColorRB );
+  glBindRenderbuffer( GL_RENDERBUFFER, m_uiColorRB );
+  glRenderbufferStorage( GL_RENDERBUFFER, GL_RGBA8, iWidth, iHeight );
+  glFramebufferRenderbuffer( GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_uiColorRB );
+
+  glGenRenderbuffers( 1, &m_uiDepthRB );
+  glBindRenderbuffer( GL_RENDERBUFFER, m_uiDepthRB );
+  glRenderbufferStorage( GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, iWidth, iHeight );
+  glFramebufferRenderbuffer( GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_uiDepthRB );
+
+  glBindRenderbuffer( GL_RENDERBUFFER, 0 );
+
+  GLenum eStatus = glCheckFramebufferStatus( GL_FRAMEBUFFER );
+  if( eStatus != GL_FRAMEBUFFER_COMPLETE )
+  {
+    std::cerr << "framebuffer incomplete: 0x" << std::hex << eStatus << std::dec << std::endl;
+    bindDefault();
+    destroy();
+    return -1;
+  }
+
+  return 0;
+}
+
+
+void
+Framebuffer::destroy()
+{
+  if( m_uiFBO )     glDeleteFramebuffers( 1, &m_uiFBO );
+  if( m_uiColorRB ) glDeleteRenderbuffers( 1, &m_uiColorRB );
+  if( m_uiDepthRB ) glDeleteRenderbuffers( 1, &m_uiDepthRB );
+  m_uiFBO     = 0;
+  m_uiColorRB = 0;
+  m_uiDepthRB = 0;
+}
+
+
+void
+Framebuffer::bind() const
+{
+  glBindFramebuffer( GL_FRAMEBUFFER, m_uiFBO );
+  glViewport( 0, 0, m_iWidth, m_iHeight );
+}
+
+
+void
+Framebuffer::bindDefault()
+{
+  glBindFramebuffer( GL_FRAMEBUFFER, 0 );
+}
+
+
+void
+Framebuffer::readPixels( std::vector<unsigned char>& rcPixels ) const
+{
+  const size_t uiStride = (size_t)m_iWidth * 4;
+  rcPixels.resize( uiStride * m_iHeight );
+
+  glBindFramebuffer( GL_READ_FRAMEBUFFER, m_uiFBO );
+  glPixelStorei( GL_PACK_ALIGNMENT, 1 );
+  glReadPixels( 0, 0, m_iWidth, m_iHeight, GL_RGBA, GL_UNSIGNED_BYTE, rcPixels.data() );
+
+  // GL delivers the bottom row first
+  PixelConvert::flipRows( rcPixels.data(), uiStride, (size_t)m_iHeight );
+}
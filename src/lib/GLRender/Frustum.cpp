@@ -0,0 +1,156 @@
+#include "GLRender/Frustum.h"
+
+#include <cmath>
+
+#if defined(__SSE__) || defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 1 )
+#define GLRENDER_FRUSTUM_SSE
+#include <xmmintrin.h>
+#endif
+
+
+
+void
+BoundingSpheres::reserve( size_t uiSize )
+{
+  size_t uiPadded = ( uiSize + 3 ) & ~(size_t)3;
+  m_cX.reserve( uiPadded );
+  m_cY.reserve( uiPadded );
+  m_cZ.reserve( uiPadded );
+  m_cR.reserve( uiPadded );
+}
+
+
+void
+BoundingSpheres::add( float fX, float fY, float fZ, float fRadius )
+{
+  // overwrite the padding of the last group of four, or start a new group
+  if( m_uiSize == m_cX.size() )
+  {
+    m_cX.resize( m_uiSize + 4, 0.0f );
+    m_cY.resize( m_uiSize + 4, 0.0f );
+    m_cZ.resize( m_uiSize + 4, 0.0f );
+    m_cR.resize( m_uiSize + 4, 0.0f );
+  }
+  m_cX[m_uiSize] = fX;
+  m_cY[m_uiSize] = fY;
+  m_cZ[m_uiSize] = fZ;
+  m_cR[m_uiSize] = fRadius;
+  m_uiSize++;
+}
+
+
+
+// constructor
+Frustum::Frustum()
+{
+  // everything is inside until a matrix is set
+  for( int i = 0; i < 6; i++ )
+  {
+    m_aafPlanes[i][0] = m_aafPlanes[i][1] = m_aafPlanes[i][2] = 0.0f;
+    m_aafPlanes[i][3] = 1.0f;
+  }
+}
+
+
+void
+Frustum::setMatrix( const float* pfViewProj )
+{
+  // rows of the matrix, m[col * 4 + row]
+  float aafRow[4][4];
+  for( int r = 0; r < 4; r++ )
+  {
+    for( int c = 0; c < 4; c++ ) aafRow[r][c] = pfViewProj[c * 4 + r];
+  }
+
+  // left, right, bottom, top, near, far: row3 +- row0/1/2
+  for( int i = 0; i < 6; i++ )
+  {
+    const float fSign = ( i & 1 ) ? -1.0f : 1.0f;
+    const float* pfRow = aafRow[i >> 1];
+    for( int c = 0; c < 4; c++ ) m_aafPlanes[i][c] = aafRow[3][c] + fSign * pfRow[c];
+
+    // normalize, so that the plane equation gives the distance
+    float fLen = std::sqrt( m_aafPlanes[i][0] * m_aafPlanes[i][0] + m_aafPlanes[i][1] * m_aafPlanes[i][1] + m_aafPlanes[i][2] * m_aafPlanes[i][2] );
+    if( fLen > 0.0f )
+    {
+      for( int c = 0; c < 4; c++ ) m_aafPlanes[i][c] /= fLen;
+    }
+  }
+}
+
+
+bool
+Frustum::testSphere( float fX, float fY, float fZ, float fRadius ) const
+{
+  for( int i = 0; i < 6; i++ )
+  {
+    const float* pfP = m_aafPlanes[i];
+    if( pfP[0] * fX + pfP[1] * fY + pfP[2] * fZ + pfP[3] < -fRadius ) return false;
+  }
+  return true;
+}
+
+
+bool
+Frustum::testAABB( const float* pfMin, const float* pfMax ) const
+{
+  for( int i = 0; i < 6; i++ )
+  {
+    // corner furthest along the plane normal
+    const float* pfP = m_aafPlanes[i];
+    float fX = pfP[0] >= 0.0f ? pfMax[0] : pfMin[0];
+    float fY = pfP[1] >= 0.0f ? pfMax[1] : pfMin[1];
+    float fZ = pfP[2] >= 0.0f ? pfMax[2] : pfMin[2];
+    if( pfP[0] * fX + pfP[1] * fY + pfP[2] * fZ + pfP[3] < 0.0f ) return false;
+  }
+  return true;
+}
+
+
+size_t
+Frustum::cull( const BoundingSpheres& rcSpheres, unsigned char* pucVisible ) const
+{
+  const size_t uiSize = rcSpheres.size();
+  size_t uiVisible = 0;
+
+#ifdef GLRENDER_FRUSTUM_SSE
+  __m128 avPlane[6][4];
+  for( int i = 0; i < 6; i++ )
+  {
+    for( int c = 0; c < 4; c++ ) avPlane[i][c] = _mm_set1_ps( m_aafPlanes[i][c] );
+  }
+
+  // the arrays are padded, the last group may read up to three unused entries
+  for( size_t uiGroup = 0; uiGroup < uiSize; uiGroup += 4 )
+  {
+    __m128 vX    = _mm_loadu_ps( rcSpheres.getX() + uiGroup );
+    __m128 vY    = _mm_loadu_ps( rcSpheres.getY() + uiGroup );
+    __m128 vZ    = _mm_loadu_ps( rcSpheres.getZ() + uiGroup );
+    __m128 vNegR = _mm_sub_ps( _mm_setzero_ps(), _mm_loadu_ps( rcSpheres.getRadius() + uiGroup ) );
+
+    __m128 vInside = _mm_cmpeq_ps( _mm_setzero_ps(), _mm_setzero_ps() );   // all bits set
+    for( int i = 0; i < 6; i++ )
+    {
+      __m128 vDist = _mm_add_ps( _mm_add_ps( _mm_mul_ps( avPlane[i][0], vX ), _mm_mul_ps( avPlane[i][1], vY ) ),
+                                 _mm_add_ps( _mm_mul_ps( avPlane[i][2], vZ ), avPlane[i][3] ) );
+      vInside = _mm_and_ps( vInside, _mm_cmpge_ps( vDist, vNegR ) );
+    }
+
+    int iMask = _mm_movemask_ps( vInside );
+    size_t uiEnd = uiGroup + 4 < uiSize ? uiGroup + 4 : uiSize;
+    for( size_t i = uiGroup; i < uiEnd; i++ )
+    {
+      pucVisible[i] = ( iMask >> ( i - uiGroup ) ) & 1;
+      uiVisible += pucVisible[i];
+    }
+  }
+#else
+  for( size_t i = 0; i < uiSize; i++ )
+  {
+    pucVisible[i] = testSphere( rcSpheres.getX()[i], rcSpheres.getY()[i], rcSpheres.getZ()[i], rcSpheres.getRadius()[i] ) ? 1 : 0;
+    uiVisible += pucVisible[i];
+  }
+#endif
+
+  return uiVisible;
+}
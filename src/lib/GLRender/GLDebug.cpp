@@ -0,0 +1,132 @@
+#include "GLRender/GLDebug.h"
+#include "GLRender/GLExtensions.h"
+
+#include <iostream>
+
+
+
+#ifdef GLRENDER_GL_DEBUG
+bool GLDebug::s_bEnabled = true;
+#else
+bool GLDebug::s_bEnabled = false;
+#endif
+bool GLDebug::s_bCallback = false;
+bool GLDebug::s_bDebugOutput = false;
+unsigned int GLDebug::s_uiNumErrors = 0;
+
+
+
+static const char* getSourceName( GLenum eSource )
+{
+  switch( eSource )
+  {
+  case GL_DEBUG_SOURCE_API:             return "API";
+  case GL_DEBUG_SOURCE_WINDOW_SYSTEM:   return "window system";
+  case GL_DEBUG_SOURCE_SHADER_COMPILER: return "shader compiler";
+  case GL_DEBUG_SOURCE_THIRD_PARTY:     return "third party";
+  case GL_DEBUG_SOURCE_APPLICATION:     return "application";
+  default:                              return "other";
+  }
+}
+
+
+static const char* getTypeName( GLenum eType )
+{
+  switch( eType )
+  {
+  case GL_DEBUG_TYPE_ERROR:               return "error";
+  case GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR: return "deprecated";
+  case GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR:  return "undefined behavior";
+  case GL_DEBUG_TYPE_PORTABILITY:         return "portability";
+  case GL_DEBUG_TYPE_PERFORMANCE:         return "performance";
+  default:                                return "other";
+  }
+}
+
+
+static const char* getErrorName( GLenum eError )
+{
+  switch( eError )
+  {
+  case GL_INVALID_ENUM:                   return "GL_INVALID_ENUM";
+  case GL_INVALID_VALUE:                  return "GL_INVALID_VALUE";
+  case GL_INVALID_OPERATION:              return "GL_INVALID_OPERATION";
+  case GL_INVALID_FRAMEBUFFER_OPERATION:  return "GL_INVALID_FRAMEBUFFER_OPERATION";
+  case GL_OUT_OF_MEMORY:                  return "GL_OUT_OF_MEMORY";
+  default:                                return "unknown";
+  }
+}
+
+
+
+void
+GLDebug::init()
+{
+  s_bCallback = false;
+  s_bDebugOutput = false;
+  s_uiNumErrors = 0;
+  if( !GLEXT_debug_output ) return;
+
+  glDebugMessageCallback( messageCallback, NULL );
+  // notifications (buffer placement etc.) are too chatty to be useful
+  glDebugMessageControl( GL_DONT_CARE, GL_DONT_CARE, GL_DEBUG_SEVERITY_NOTIFICATION, 0, NULL, GL_FALSE );
+  s_bCallback = true;
+  // ARB_debug_output has no GL_DEBUG_OUTPUT switch, its output is always on
+  s_bDebugOutput = hasGLVersion( 4, 3 ) || hasGLExtension( "GL_KHR_debug" );
+
+  setEnabled( s_bEnabled );
+}
+
+
+void
+GLDebug::setEnabled( bool bEnabled )
+{
+  s_bEnabled = bEnabled;
+  if( !s_bCallback ) return;
+
+  // synchronous output reports the message inside the offending call, which is slower but
+  // gives a usable call stack; both are only paid for while the layer is on. Without
+  // GL_DEBUG_OUTPUT (ARB path) the callback drops the messages while the layer is off.
+  if( bEnabled )
+  {
+    if( s_bDebugOutput ) glEnable( GL_DEBUG_OUTPUT );
+    glEnable( GL_DEBUG_OUTPUT_SYNCHRONOUS );
+  }
+  else
+  {
+    glDisable( GL_DEBUG_OUTPUT_SYNCHRONOUS );
+    if( s_bDebugOutput ) glDisable( GL_DEBUG_OUTPUT );
+  }
+}
+
+
+void
+GLDebug::check( const char* pcLabel, const char* pcFile, int iLine )
+{
+  // the callback reports errors already, polling would only stall the pipeline
+  if( !s_bEnabled || s_bCallback ) return;
+
+  GLenum eError;
+  while( ( eError = glGetError() ) != GL_NO_ERROR )
+  {
+    s_uiNumErrors++;
+    std::cerr << "GL error " << getErrorName( eError ) << " (" << pcLabel << ") at " << pcFile << ":" << iLine << std::endl;
+  }
+}
+
+
+void APIENTRY
+GLDebug::messageCallback( GLenum eSource, GLenum eType, GLuint uiId, GLenum eSeverity,
+                          GLsizei /*iLength*/, const GLchar* pcMessage, const void* /*pvUser*/ )
+{
+  if( !s_bEnabled ) return;
+
+  const char* pcSeverity = "low";
+  if( eSeverity == GL_DEBUG_SEVERITY_HIGH )   pcSeverity = "high";
+  if( eSeverity == GL_DEBUG_SEVERITY_MEDIUM ) pcSeverity = "medium";
+
+  if( eType == GL_DEBUG_TYPE_ERROR ) s_uiNumErrors++;
+
+  std::cerr << "GL debug [" << getSourceName( eSource ) << ", " << getTypeName( eType ) << ", " << pcSeverity
+            << ", id " << uiId << "]: " << pcMessage << std::endl;
+}
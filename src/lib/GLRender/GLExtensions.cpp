@@ -0,0 +1,93 @@
+#include "GLRender/GLExtensions.h"
+
+#include <set>
+#include <string>
+
+
+
+PFNGLEXTGETPROGRAMBINARYPROC   glext_glGetProgramBinary  = NULL;
+PFNGLEXTPROGRAMBINARYPROC      glext_glProgramBinary     = NULL;
+PFNGLEXTPROGRAMPARAMETERIPROC  glext_glProgramParameteri = NULL;
+PFNGLEXTDEBUGMESSAGECALLBACKPROC glext_glDebugMessageCallback = NULL;
+PFNGLEXTDEBUGMESSAGECONTROLPROC  glext_glDebugMessageControl  = NULL;
+PFNGLEXTBUFFERSTORAGEPROC      glext_glBufferStorage     = NULL;
+
+bool GLEXT_program_binary = false;
+bool GLEXT_debug_output   = false;
+bool GLEXT_buffer_storage = false;
+bool GLEXT_texture_compression_s3tc = false;
+
+
+// extensions of the current context
+static std::set<std::string> s_cExtensions;
+
+
+
+int
+loadGLExtensions( GLADloadproc pfnLoad )
+{
+  if( NULL == pfnLoad ) return -1;
+
+  // collect the extension strings
+  s_cExtensions.clear();
+  GLint iNumExt = 0;
+  glGetIntegerv( GL_NUM_EXTENSIONS, &iNumExt );
+  for( GLint i = 0; i < iNumExt; i++ )
+  {
+    const GLubyte* pcExt = glGetStringi( GL_EXTENSIONS, i );
+    if( pcExt ) s_cExtensions.insert( (const char*)pcExt );
+  }
+
+  // program binaries
+  if( hasGLVersion( 4, 1 ) || hasGLExtension( "GL_ARB_get_program_binary" ) )
+  {
+    glext_glGetProgramBinary  = (PFNGLEXTGETPROGRAMBINARYPROC) pfnLoad( "glGetProgramBinary" );
+    glext_glProgramBinary     = (PFNGLEXTPROGRAMBINARYPROC) pfnLoad( "glProgramBinary" );
+    glext_glProgramParameteri = (PFNGLEXTPROGRAMPARAMETERIPROC) pfnLoad( "glProgramParameteri" );
+  }
+  GLint iNumFormats = 0;
+  if( glext_glGetProgramBinary && glext_glProgramBinary && glext_glProgramParameteri )
+  {
+    glGetIntegerv( GL_NUM_PROGRAM_BINARY_FORMATS, &iNumFormats );
+  }
+  GLEXT_program_binary = iNumFormats > 0;
+
+  // debug output, the ARB entry points share signature and enums
+  if( hasGLVersion( 4, 3 ) || hasGLExtension( "GL_KHR_debug" ) )
+  {
+    glext_glDebugMessageCallback = (PFNGLEXTDEBUGMESSAGECALLBACKPROC) pfnLoad( "glDebugMessageCallback" );
+    glext_glDebugMessageControl  = (PFNGLEXTDEBUGMESSAGECONTROLPROC) pfnLoad( "glDebugMessageControl" );
+  }
+  else if( hasGLExtension( "GL_ARB_debug_output" ) )
+  {
+    glext_glDebugMessageCallback = (PFNGLEXTDEBUGMESSAGECALLBACKPROC) pfnLoad( "glDebugMessageCallbackARB" );
+    glext_glDebugMessageControl  = (PFNGLEXTDEBUGMESSAGECONTROLPROC) pfnLoad( "glDebugMessageControlARB" );
+  }
+  GLEXT_debug_output = glext_glDebugMessageCallback && glext_glDebugMessageControl;
+
+  // immutable buffer storage (persistent mapping)
+  if( hasGLVersion( 4, 4 ) || hasGLExtension( "GL_ARB_buffer_storage" ) )
+  {
+    glext_glBufferStorage = (PFNGLEXTBUFFERSTORAGEPROC) pfnLoad( "glBufferStorage" );
+  }
+  GLEXT_buffer_storage = glext_glBufferStorage != NULL;
+
+  // compressed textures, no entry points of their own
+  GLEXT_texture_compression_s3tc = hasGLExtension( "GL_EXT_texture_compression_s3tc" );
+
+  return 0;
+}
+
+
+bool
+hasGLExtension( const char* pcName )
+{
+  return s_cExtensions.find( pcName ) != s_cExtensions.end();
+}
+
+
+bool
+hasGLVersion( int iMajor, int iMinor )
+{
+  return GLVersion.major > iMajor || ( GLVersion.major == iMajor && GLVersion.minor >= iMinor );
+}
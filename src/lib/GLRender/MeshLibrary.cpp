@@ -0,0 +1,407 @@
+#include "GLRender/MeshLibrary.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <iostream>
+#include <tuple>
+
+
+
+static const float s_fPi = 3.14159265358979f;
+
+
+
+bool
+MeshDesc::operator<( const MeshDesc& rcOther ) const
+{
+  return std::tie( eType, iSegments, iRings, fRadius, fTopRadius, fHeight, fOffsetZ, bTexCoords )
+       < std::tie( rcOther.eType, rcOther.iSegments, rcOther.iRings, rcOther.fRadius, rcOther.fTopRadius, rcOther.fHeight, rcOther.fOffsetZ, rcOther.bTexCoords );
+}
+
+
+MeshDesc
+MeshDesc::cylinder( int iSegments, float fRadius, float fTopRadius, float fHeight )
+{
+  MeshDesc cDesc;
+  cDesc.eType      = MESH_CYLINDER;
+  cDesc.iSegments  = iSegments;
+  cDesc.iRings     = 1;
+  cDesc.fRadius    = fRadius;
+  cDesc.fTopRadius = fTopRadius;
+  cDesc.fHeight    = fHeight;
+  cDesc.fOffsetZ   = 0.0f;
+  cDesc.bTexCoords = true;
+  return cDesc;
+}
+
+
+MeshDesc
+MeshDesc::sphere( int iSegments, int iRings, float fRadius, float fOffsetZ )
+{
+  MeshDesc cDesc;
+  cDesc.eType      = MESH_SPHERE;
+  cDesc.iSegments  = iSegments;
+  cDesc.iRings     = iRings;
+  cDesc.fRadius    = fRadius;
+  cDesc.fTopRadius = fRadius;
+  cDesc.fHeight    = 0.0f;
+  cDesc.fOffsetZ   = fOffsetZ;
+  cDesc.bTexCoords = true;
+  return cDesc;
+}
+
+
+MeshDesc
+MeshDesc::simplified( int iLevel ) const
+{
+  // keep enough segments for a closed, roughly round silhouette
+  MeshDesc cDesc = *this;
+  cDesc.iSegments = std::max( iSegments >> iLevel, std::min( iSegments, 6 ) );
+  if( eType == MESH_SPHERE ) cDesc.iRings = std::max( iRings >> iLevel, std::min( iRings, 4 ) );
+  return cDesc;
+}
+
+
+
+MeshBounds
+MeshBounds::fromVertices( const std::vector<float>& rcVertices, int iStride )
+{
+  MeshBounds cBounds;
+  for( int c = 0; c < 3; c++ )
+  {
+    cBounds.afMin[c] = rcVertices.empty() ? 0.0f :  FLT_MAX;
+    cBounds.afMax[c] = rcVertices.empty() ? 0.0f : -FLT_MAX;
+  }
+
+  for( size_t i = 0; i + 2 < rcVertices.size(); i += iStride )
+  {
+    for( int c = 0; c < 3; c++ )
+    {
+      cBounds.afMin[c] = std::min( cBounds.afMin[c], rcVertices[i + c] );
+      cBounds.afMax[c] = std::max( cBounds.afMax[c], rcVertices[i + c] );
+    }
+  }
+
+  // sphere around the box center, tighter than the half diagonal for round meshes
+  for( int c = 0; c < 3; c++ ) cBounds.afCenter[c] = 0.5f * ( cBounds.afMin[c] + cBounds.afMax[c] );
+  float fRadius2 = 0.0f;
+  for( size_t i = 0; i + 2 < rcVertices.size(); i += iStride )
+  {
+    float fDX = rcVertices[i]     - cBounds.afCenter[0];
+    float fDY = rcVertices[i + 1] - cBounds.afCenter[1];
+    float fDZ = rcVertices[i + 2] - cBounds.afCenter[2];
+    fRadius2 = std::max( fRadius2, fDX * fDX + fDY * fDY + fDZ * fDZ );
+  }
+  cBounds.fRadius = std::sqrt( fRadius2 );
+  return cBounds;
+}
+
+
+MeshBounds
+MeshBounds::merge( const MeshBounds& rcA, const MeshBounds& rcB )
+{
+  MeshBounds cBounds;
+  for( int c = 0; c < 3; c++ )
+  {
+    cBounds.afMin[c]    = std::min( rcA.afMin[c], rcB.afMin[c] );
+    cBounds.afMax[c]    = std::max( rcA.afMax[c], rcB.afMax[c] );
+    cBounds.afCenter[c] = 0.5f * ( cBounds.afMin[c] + cBounds.afMax[c] );
+  }
+
+  float fDistA = 0.0f, fDistB = 0.0f;
+  for( int c = 0; c < 3; c++ )
+  {
+    fDistA += ( rcA.afCenter[c] - cBounds.afCenter[c] ) * ( rcA.afCenter[c] - cBounds.afCenter[c] );
+    fDistB += ( rcB.afCenter[c] - cBounds.afCenter[c] ) * ( rcB.afCenter[c] - cBounds.afCenter[c] );
+  }
+  cBounds.fRadius = std::max( std::sqrt( fDistA ) + rcA.fRadius, std::sqrt( fDistB ) + rcB.fRadius );
+  return cBounds;
+}
+
+
+
+int
+MeshLODChain::selectLevel( float fPixels, int iCurrent ) const
+{
+  const int iNumLevels = getNumLevels();
+  if( iNumLevels <= 1 ) return 0;
+
+  // level for the size with the thresholds moved by the hysteresis margin
+  auto getLevel = [&]( float fScale )
+  {
+    int iLevel = 0;
+    while( iLevel < (int)cMinPixels.size() && fPixels < cMinPixels[iLevel] * fScale ) iLevel++;
+    return iLevel;
+  };
+
+  if( iCurrent < 0 || iCurrent >= iNumLevels ) return getLevel( 1.0f );
+
+  // refine only when clearly above, coarsen only when clearly below a threshold
+  int iFiner = getLevel( 1.0f + fHysteresis );
+  if( iFiner < iCurrent ) return iFiner;
+  int iCoarser = getLevel( 1.0f - fHysteresis );
+  if( iCoarser > iCurrent ) return iCoarser;
+  return iCurrent;
+}
+
+
+
+// constructor
+Mesh::Mesh( const std::vector<float>& rcVertices, const std::vector<unsigned int>& rcIndices,
+            const VertexFormat& rcFormat, const MeshOptimizeStats* pcStats )
+  : m_uiVAO( 0 )
+  , m_uiVBO( 0 )
+  , m_uiEBO( 0 )
+  , m_iIndexCount( (GLsizei)rcIndices.size() )
+  , m_iVertexCount( (GLsizei)(rcVertices.size() / 5) )
+  , m_eIndexType( m_iVertexCount <= 0x10000 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT )
+  , m_cBounds( MeshBounds::fromVertices( rcVertices, 5 ) )
+  , m_cFormat( rcFormat )
+  , m_cQuantization( VertexQuantization::identity() )
+  , m_cOptimizeStats()
+{
+  if( pcStats ) m_cOptimizeStats = *pcStats;
+
+  // create vertex array object
+  glGenVertexArrays( 1, &m_uiVAO );
+  glBindVertexArray( m_uiVAO );
+
+  // create buffer object for the encoded vertices
+  std::vector<unsigned char> cEncoded;
+  m_cFormat.encode( rcVertices, 5, 3, -1, cEncoded, &m_cQuantization );
+  glGenBuffers( 1, &m_uiVBO );
+  glBindBuffer( GL_ARRAY_BUFFER, m_uiVBO );
+  glBufferData( GL_ARRAY_BUFFER, cEncoded.size(), cEncoded.data(), GL_STATIC_DRAW );
+
+  // create buffer object for indices
+  glGenBuffers( 1, &m_uiEBO );
+  glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, m_uiEBO );
+  if( m_eIndexType == GL_UNSIGNED_SHORT )
+  {
+    // half the index memory and bandwidth
+    std::vector<unsigned short> cShortIndices( rcIndices.begin(), rcIndices.end() );
+    glBufferData( GL_ELEMENT_ARRAY_BUFFER, cShortIndices.size() * sizeof(unsigned short), cShortIndices.data(), GL_STATIC_DRAW );
+  }
+  else
+  {
+    glBufferData( GL_ELEMENT_ARRAY_BUFFER, rcIndices.size() * sizeof(unsigned int), rcIndices.data(), GL_STATIC_DRAW );
+  }
+
+  setupAttribs();
+
+  glBindVertexArray( 0 );
+}
+
+
+// destructor
+Mesh::~Mesh()
+{
+  glDeleteBuffers( 1, &m_uiVBO );
+  glDeleteBuffers( 1, &m_uiEBO );
+  glDeleteVertexArrays( 1, &m_uiVAO );
+}
+
+
+void
+Mesh::setupAttribs() const
+{
+  glBindBuffer( GL_ARRAY_BUFFER, m_uiVBO );
+  glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, m_uiEBO );
+  m_cFormat.setupAttribs();
+}
+
+
+
+MeshLibrary&
+MeshLibrary::get()
+{
+  static MeshLibrary s_cLibrary;
+  return s_cLibrary;
+}
+
+
+MeshHandle
+MeshLibrary::acquire( const MeshDesc& rcDesc )
+{
+  // return the existing mesh if somebody still holds it
+  std::weak_ptr<Mesh>& rcEntry = m_cMeshes[rcDesc];
+  MeshHandle cMesh = rcEntry.lock();
+  if( cMesh ) return cMesh;
+
+  std::vector<float>        cVertices;
+  std::vector<unsigned int> cIndices;
+  generate( rcDesc, cVertices, cIndices );
+
+  // weld seams (only positions have to match if the texture coordinates are unused) and
+  // reorder for the vertex cache
+  MeshOptimizeStats cStats;
+  MeshOptimizer::optimize( cVertices, cIndices, 5, rcDesc.bTexCoords ? 5 : 3, &cStats );
+
+  cMesh = std::make_shared<Mesh>( cVertices, cIndices, getFormat( rcDesc ), &cStats );
+  rcEntry = cMesh;
+  return cMesh;
+}
+
+
+MeshLODChain
+MeshLibrary::acquireLODChain( const MeshDesc& rcDesc, int iNumLevels, float fMaxEdgePixels )
+{
+  MeshLODChain cChain;
+  for( int i = 0; i < iNumLevels; i++ )
+  {
+    MeshDesc cLevelDesc = rcDesc.simplified( i );
+    // stop when the mesh cannot get any coarser
+    if( i > 0 && !( cLevelDesc < rcDesc.simplified( i - 1 ) ) && !( rcDesc.simplified( i - 1 ) < cLevelDesc ) ) break;
+
+    // a silhouette edge of the coarser level is about pi * d / segments pixels long;
+    // switch to it once that is below the allowed edge length
+    if( i > 0 ) cChain.cMinPixels.push_back( fMaxEdgePixels * cLevelDesc.iSegments / s_fPi );
+    cChain.cLevels.push_back( acquire( cLevelDesc ) );
+  }
+  return cChain;
+}
+
+
+size_t
+MeshLibrary::getNumMeshes() const
+{
+  size_t uiNum = 0;
+  for( auto i = m_cMeshes.begin(); i != m_cMeshes.end(); ++i )
+  {
+    if( !i->second.expired() ) uiNum++;
+  }
+  return uiNum;
+}
+
+
+VertexFormat
+MeshLibrary::getFormat( const MeshDesc& rcDesc )
+{
+  return VertexFormat( VertexFormat::POSITION_INT16, rcDesc.bTexCoords ? VertexFormat::TEXCOORD_UNORM16 : VertexFormat::TEXCOORD_NONE );
+}
+
+
+void
+MeshLibrary::printStats( std::ostream& rcStream ) const
+{
+  for( auto i = m_cMeshes.begin(); i != m_cMeshes.end(); ++i )
+  {
+    MeshHandle cMesh = i->second.lock();
+    if( !cMesh ) continue;
+
+    const MeshOptimizeStats& rcStats = cMesh->getOptimizeStats();
+    rcStream << ( i->first.eType == MeshDesc::MESH_SPHERE ? "sphere" : "cylinder" )
+             << " " << i->first.iSegments << "x" << i->first.iRings
+             << ": vertices " << rcStats.uiVerticesBefore << " -> " << rcStats.uiVerticesAfter
+             << ", triangles " << rcStats.uiTrianglesBefore << " -> " << rcStats.uiTrianglesAfter
+             << ", " << cMesh->getFormat().getStride() << " bytes/vertex"
+             << ", indices " << ( cMesh->getIndexType() == GL_UNSIGNED_SHORT ? 16 : 32 ) << " bit"
+             << ", ACMR " << rcStats.fAcmrBefore << " -> " << rcStats.fAcmrAfter << std::endl;
+  }
+}
+
+
+void
+MeshLibrary::generate( const MeshDesc& rcDesc, std::vector<float>& rcVertices, std::vector<unsigned int>& rcIndices )
+{
+  rcVertices.clear();
+  rcIndices.clear();
+
+  switch( rcDesc.eType )
+  {
+  case MeshDesc::MESH_CYLINDER: generateCylinder( rcDesc, rcVertices, rcIndices ); break;
+  case MeshDesc::MESH_SPHERE:   generateSphere( rcDesc, rcVertices, rcIndices );   break;
+  default:
+    std::cerr << "unknown mesh type: " << rcDesc.eType << std::endl;
+    break;
+  }
+}
+
+
+void
+MeshLibrary::generateCylinder( const MeshDesc& rcDesc, std::vector<float>& rcVertices, std::vector<unsigned int>& rcIndices )
+{
+  const int iSegments = rcDesc.iSegments;
+
+  // (segments+1)*2 vertices, the first column is duplicated to close the shell
+  for( int i = 0; i <= iSegments; i++ )
+  {
+    float fTheta = 2.0f * s_fPi * i / iSegments;
+    float fCos = std::cos( fTheta );
+    float fSin = std::sin( fTheta );
+
+    // bottom ring (z = 0)
+    rcVertices.push_back( rcDesc.fRadius * fCos );
+    rcVertices.push_back( rcDesc.fRadius * fSin );
+    rcVertices.push_back( 0.0f );
+    rcVertices.push_back( (float)i / iSegments );
+    rcVertices.push_back( 0.0f );
+
+    // top ring (z = height)
+    rcVertices.push_back( rcDesc.fTopRadius * fCos );
+    rcVertices.push_back( rcDesc.fTopRadius * fSin );
+    rcVertices.push_back( rcDesc.fHeight );
+    rcVertices.push_back( (float)i / iSegments );
+    rcVertices.push_back( 1.0f );
+  }
+
+  // two triangles per segment
+  for( int i = 0; i < iSegments; i++ )
+  {
+    unsigned int uiBottom0 = 2 * i;
+    unsigned int uiTop0    = uiBottom0 + 1;
+    unsigned int uiBottom1 = 2 * (i + 1);
+    unsigned int uiTop1    = uiBottom1 + 1;
+
+    rcIndices.push_back( uiBottom0 );
+    rcIndices.push_back( uiTop0 );
+    rcIndices.push_back( uiTop1 );
+
+    rcIndices.push_back( uiBottom0 );
+    rcIndices.push_back( uiTop1 );
+    rcIndices.push_back( uiBottom1 );
+  }
+}
+
+
+void
+MeshLibrary::generateSphere( const MeshDesc& rcDesc, std::vector<float>& rcVertices, std::vector<unsigned int>& rcIndices )
+{
+  const int iRings    = rcDesc.iRings;
+  const int iSegments = rcDesc.iSegments;
+
+  // vertices in spherical coordinates
+  for( int i = 0; i <= iRings; i++ )
+  {
+    float fPhi = s_fPi * i / iRings;                  // 0 .. pi
+    for( int j = 0; j <= iSegments; j++ )
+    {
+      float fTheta = 2.0f * s_fPi * j / iSegments;    // 0 .. 2pi
+
+      rcVertices.push_back( rcDesc.fRadius * std::sin( fPhi ) * std::cos( fTheta ) );
+      rcVertices.push_back( rcDesc.fRadius * std::sin( fPhi ) * std::sin( fTheta ) );
+      rcVertices.push_back( rcDesc.fRadius * std::cos( fPhi ) + rcDesc.fOffsetZ );
+      rcVertices.push_back( (float)j / iSegments );
+      rcVertices.push_back( (float)i / iRings );
+    }
+  }
+
+  // two triangles per quad
+  for( int i = 0; i < iRings; i++ )
+  {
+    for( int j = 0; j < iSegments; j++ )
+    {
+      unsigned int uiFirst  = i * (iSegments + 1) + j;
+      unsigned int uiSecond = uiFirst + iSegments + 1;
+
+      rcIndices.push_back( uiFirst );
+      rcIndices.push_back( uiSecond );
+      rcIndices.push_back( uiFirst + 1 );
+
+      rcIndices.push_back( uiSecond );
+      rcIndices.push_back( uiSecond + 1 );
+      rcIndices.push_back( uiFirst + 1 );
+    }
+  }
+}
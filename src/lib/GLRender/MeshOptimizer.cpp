@@ -0,0 +1,241 @@
+#include "GLRender/MeshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+
+
+
+// size of the cache modelled by the vertex cache optimization (LRU)
+static const int s_iCacheSize = 32;
+
+
+
+void
+MeshOptimizer::optimize( std::vector<float>& rcVertices, std::vector<unsigned int>& rcIndices, int iStride, int iCompare,
+                         MeshOptimizeStats* pcStats )
+{
+  MeshOptimizeStats cStats;
+  cStats.uiVerticesBefore  = (unsigned int)( rcVertices.size() / iStride );
+  cStats.uiTrianglesBefore = (unsigned int)( rcIndices.size() / 3 );
+  cStats.fAcmrBefore       = computeACMR( rcIndices, cStats.uiVerticesBefore );
+
+  weldVertices( rcVertices, rcIndices, iStride, iCompare );
+  removeDegenerates( rcIndices );
+  optimizeVertexCache( rcIndices, (unsigned int)( rcVertices.size() / iStride ) );
+  optimizeVertexFetch( rcVertices, rcIndices, iStride );
+
+  cStats.uiVerticesAfter  = (unsigned int)( rcVertices.size() / iStride );
+  cStats.uiTrianglesAfter = (unsigned int)( rcIndices.size() / 3 );
+  cStats.fAcmrAfter       = computeACMR( rcIndices, cStats.uiVerticesAfter );
+
+  if( pcStats ) *pcStats = cStats;
+}
+
+
+void
+MeshOptimizer::weldVertices( std::vector<float>& rcVertices, std::vector<unsigned int>& rcIndices, int iStride, int iCompare,
+                             float fEpsilon )
+{
+  const size_t uiNumVertices = rcVertices.size() / iStride;
+  iCompare = std::min( iCompare, iStride );
+
+  // key: compared attributes snapped to a grid of fEpsilon, so that e.g. sin( 2 pi ) and
+  // sin( 0 ) end up in the same cell
+  std::map<std::vector<long long>, unsigned int> cUnique;
+  std::vector<unsigned int> cRemap( uiNumVertices );
+  std::vector<float>        cWelded;
+  cWelded.reserve( rcVertices.size() );
+
+  std::vector<long long> cKey( iCompare );
+  for( size_t v = 0; v < uiNumVertices; v++ )
+  {
+    const float* pfVertex = &rcVertices[v * iStride];
+    for( int c = 0; c < iCompare; c++ ) cKey[c] = (long long)std::floor( pfVertex[c] / fEpsilon + 0.5f );
+
+    auto cResult = cUnique.insert( std::make_pair( cKey, (unsigned int)( cWelded.size() / iStride ) ) );
+    if( cResult.second ) cWelded.insert( cWelded.end(), pfVertex, pfVertex + iStride );
+    cRemap[v] = cResult.first->second;
+  }
+
+  for( size_t i = 0; i < rcIndices.size(); i++ ) rcIndices[i] = cRemap[rcIndices[i]];
+  rcVertices.swap( cWelded );
+}
+
+
+void
+MeshOptimizer::removeDegenerates( std::vector<unsigned int>& rcIndices )
+{
+  size_t uiOut = 0;
+  for( size_t i = 0; i + 2 < rcIndices.size(); i += 3 )
+  {
+    unsigned int uiA = rcIndices[i], uiB = rcIndices[i + 1], uiC = rcIndices[i + 2];
+    if( uiA == uiB || uiB == uiC || uiA == uiC ) continue;
+    rcIndices[uiOut++] = uiA;
+    rcIndices[uiOut++] = uiB;
+    rcIndices[uiOut++] = uiC;
+  }
+  rcIndices.resize( uiOut );
+}
+
+
+void
+MeshOptimizer::optimizeVertexCache( std::vector<unsigned int>& rcIndices, unsigned int uiNumVertices )
+{
+  const size_t uiNumTriangles = rcIndices.size() / 3;
+  if( uiNumTriangles == 0 ) return;
+
+  // score tables: recently used vertices score high (the last triangle slightly less, it
+  // cannot be reused as well), vertices with few remaining triangles get a boost so that
+  // no lonely triangles are left behind
+  float afCacheScore[s_iCacheSize];
+  for( int i = 0; i < s_iCacheSize; i++ )
+  {
+    afCacheScore[i] = i < 3 ? 0.75f : std::pow( 1.0f - (float)( i - 3 ) / ( s_iCacheSize - 3 ), 1.5f );
+  }
+  auto getVertexScore = [&]( int iCachePos, unsigned int uiRemaining ) -> float
+  {
+    if( uiRemaining == 0 ) return -1.0f;
+    float fScore = iCachePos >= 0 ? afCacheScore[iCachePos] : 0.0f;
+    return fScore + 2.0f / std::sqrt( (float)uiRemaining );
+  };
+
+  // triangles adjacent to each vertex (offsets into one array)
+  std::vector<unsigned int> cRemaining( uiNumVertices, 0 );
+  for( size_t i = 0; i < rcIndices.size(); i++ ) cRemaining[rcIndices[i]]++;
+  std::vector<unsigned int> cOffsets( uiNumVertices + 1, 0 );
+  for( unsigned int v = 0; v < uiNumVertices; v++ ) cOffsets[v + 1] = cOffsets[v] + cRemaining[v];
+  std::vector<unsigned int> cAdjacency( rcIndices.size() );
+  {
+    std::vector<unsigned int> cFill( cOffsets.begin(), cOffsets.end() - 1 );
+    for( size_t t = 0; t < uiNumTriangles; t++ )
+    {
+      for( int k = 0; k < 3; k++ ) cAdjacency[cFill[rcIndices[t * 3 + k]]++] = (unsigned int)t;
+    }
+  }
+
+  std::vector<int>   cCachePos( uiNumVertices, -1 );
+  std::vector<float> cVertexScore( uiNumVertices );
+  for( unsigned int v = 0; v < uiNumVertices; v++ ) cVertexScore[v] = getVertexScore( -1, cRemaining[v] );
+
+  std::vector<bool> cEmitted( uiNumTriangles, false );
+
+  // cache holds up to three more entries while the new triangle is inserted
+  std::vector<unsigned int> cCache, cNewCache;
+  cCache.reserve( s_iCacheSize + 3 );
+  cNewCache.reserve( s_iCacheSize + 3 );
+
+  std::vector<unsigned int> cResult;
+  cResult.reserve( rcIndices.size() );
+
+  size_t uiCursor = 0;
+  long long iBest = 0;
+  while( cResult.size() < rcIndices.size() )
+  {
+    // no candidate in the cache: continue with the next triangle in input order
+    if( iBest < 0 )
+    {
+      while( cEmitted[uiCursor] ) uiCursor++;
+      iBest = (long long)uiCursor;
+    }
+
+    const unsigned int* puiTri = &rcIndices[iBest * 3];
+    cEmitted[iBest] = true;
+    cResult.insert( cResult.end(), puiTri, puiTri + 3 );
+
+    // remove the triangle from the adjacency of its vertices
+    for( int k = 0; k < 3; k++ )
+    {
+      unsigned int v = puiTri[k];
+      unsigned int* puiBegin = &cAdjacency[cOffsets[v]];
+      unsigned int* puiEnd   = puiBegin + cRemaining[v];
+      std::iter_swap( std::find( puiBegin, puiEnd, (unsigned int)iBest ), puiEnd - 1 );
+      cRemaining[v]--;
+    }
+
+    // the triangle's vertices move to the front of the LRU cache
+    cNewCache.assign( puiTri, puiTri + 3 );
+    for( size_t i = 0; i < cCache.size(); i++ )
+    {
+      if( cCache[i] != puiTri[0] && cCache[i] != puiTri[1] && cCache[i] != puiTri[2] ) cNewCache.push_back( cCache[i] );
+    }
+    for( size_t i = s_iCacheSize; i < cNewCache.size(); i++ )
+    {
+      cCachePos[cNewCache[i]] = -1;
+      cVertexScore[cNewCache[i]] = getVertexScore( -1, cRemaining[cNewCache[i]] );
+    }
+    cNewCache.resize( std::min( cNewCache.size(), (size_t)s_iCacheSize ) );
+    cCache.swap( cNewCache );
+
+    for( size_t i = 0; i < cCache.size(); i++ )
+    {
+      cCachePos[cCache[i]] = (int)i;
+      cVertexScore[cCache[i]] = getVertexScore( (int)i, cRemaining[cCache[i]] );
+    }
+
+    // rescore the triangles touching the cache and pick the best one for the next step
+    iBest = -1;
+    float fBestScore = -1.0f;
+    for( size_t i = 0; i < cCache.size(); i++ )
+    {
+      unsigned int v = cCache[i];
+      for( unsigned int a = 0; a < cRemaining[v]; a++ )
+      {
+        unsigned int t = cAdjacency[cOffsets[v] + a];
+        float fScore = cVertexScore[rcIndices[t * 3]] + cVertexScore[rcIndices[t * 3 + 1]] + cVertexScore[rcIndices[t * 3 + 2]];
+        if( fScore > fBestScore )
+        {
+          fBestScore = fScore;
+          iBest = t;
+        }
+      }
+    }
+  }
+
+  rcIndices.swap( cResult );
+}
+
+
+void
+MeshOptimizer::optimizeVertexFetch( std::vector<float>& rcVertices, std::vector<unsigned int>& rcIndices, int iStride )
+{
+  const size_t uiNumVertices = rcVertices.size() / iStride;
+  std::vector<unsigned int> cRemap( uiNumVertices, ~0u );
+  std::vector<float> cReordered;
+  cReordered.reserve( rcVertices.size() );
+
+  // unreferenced vertices are dropped
+  for( size_t i = 0; i < rcIndices.size(); i++ )
+  {
+    unsigned int& ruiNew = cRemap[rcIndices[i]];
+    if( ruiNew == ~0u )
+    {
+      ruiNew = (unsigned int)( cReordered.size() / iStride );
+      cReordered.insert( cReordered.end(), &rcVertices[rcIndices[i] * iStride], &rcVertices[rcIndices[i] * iStride] + iStride );
+    }
+    rcIndices[i] = ruiNew;
+  }
+  rcVertices.swap( cReordered );
+}
+
+
+float
+MeshOptimizer::computeACMR( const std::vector<unsigned int>& rcIndices, unsigned int uiNumVertices, unsigned int uiCacheSize )
+{
+  if( rcIndices.size() < 3 ) return 0.0f;
+
+  // FIFO: a vertex is in the cache while fewer than uiCacheSize misses happened since it was loaded
+  std::vector<unsigned int> cLoaded( uiNumVertices, 0 );
+  unsigned int uiTime = uiCacheSize + 1;
+  unsigned int uiMisses = 0;
+  for( size_t i = 0; i < rcIndices.size(); i++ )
+  {
+    unsigned int v = rcIndices[i];
+    if( uiTime - cLoaded[v] > uiCacheSize )
+    {
+      cLoaded[v] = uiTime++;
+      uiMisses++;
+    }
+  }
+  return (float)uiMisses / ( rcIndices.size() / 3 );
+}
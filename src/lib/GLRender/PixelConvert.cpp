@@ -0,0 +1,380 @@
+#include "GLRender/PixelConvert.h"
+
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 )
+#define GLRENDER_PIXEL_SSE2
+#include <emmintrin.h>
+// AVX2 code is compiled per function and only called if the CPU supports it
+#if defined(__GNUC__) || defined(__clang__)
+#define GLRENDER_PIXEL_AVX2
+#define GLRENDER_TARGET_AVX2 __attribute__(( target( "avx2" ) ))
+#include <immintrin.h>
+#elif defined(_MSC_VER)
+#define GLRENDER_PIXEL_AVX2
+#define GLRENDER_TARGET_AVX2
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+#endif
+
+
+
+static PixelConvert::Isa detectIsa()
+{
+#if defined(GLRENDER_PIXEL_AVX2) && ( defined(__GNUC__) || defined(__clang__) )
+  __builtin_cpu_init();
+  if( __builtin_cpu_supports( "avx2" ) ) return PixelConvert::ISA_AVX2;
+#elif defined(GLRENDER_PIXEL_AVX2)
+  // AVX2 flag of the CPU and AVX state enabled by the OS
+  int aiInfo[4];
+  __cpuid( aiInfo, 0 );
+  if( aiInfo[0] >= 7 )
+  {
+    __cpuid( aiInfo, 1 );
+    const bool bOsAvx = ( aiInfo[2] & ( 1 << 27 ) ) && ( aiInfo[2] & ( 1 << 28 ) ) && ( _xgetbv( 0 ) & 6 ) == 6;
+    __cpuidex( aiInfo, 7, 0 );
+    if( bOsAvx && ( aiInfo[1] & ( 1 << 5 ) ) ) return PixelConvert::ISA_AVX2;
+  }
+#endif
+#ifdef GLRENDER_PIXEL_SSE2
+  return PixelConvert::ISA_SSE2;
+#else
+  return PixelConvert::ISA_SCALAR;
+#endif
+}
+
+static const PixelConvert::Isa s_eSupportedIsa = detectIsa();
+static PixelConvert::Isa       s_eIsa          = s_eSupportedIsa;
+
+
+
+// round( c * a / 255 ) without a division
+static inline unsigned char mulDiv255( unsigned int uiC, unsigned int uiA )
+{
+  const unsigned int uiX = uiC * uiA + 128;
+  return (unsigned char)( ( uiX + ( uiX >> 8 ) ) >> 8 );
+}
+
+
+static void expandScalar( const unsigned char* pucSrc, unsigned char* pucDst, size_t uiNumPixels, unsigned char ucAlpha )
+{
+  for( size_t i = 0; i < uiNumPixels; i++ )
+  {
+    pucDst[4 * i + 0] = pucSrc[3 * i + 0];
+    pucDst[4 * i + 1] = pucSrc[3 * i + 1];
+    pucDst[4 * i + 2] = pucSrc[3 * i + 2];
+    pucDst[4 * i + 3] = ucAlpha;
+  }
+}
+
+
+static void swapRedBlueScalar( const unsigned char* pucSrc, unsigned char* pucDst, size_t uiNumPixels )
+{
+  for( size_t i = 0; i < uiNumPixels; i++ )
+  {
+    const unsigned char ucRed = pucSrc[4 * i + 0];
+    pucDst[4 * i + 0] = pucSrc[4 * i + 2];
+    pucDst[4 * i + 1] = pucSrc[4 * i + 1];
+    pucDst[4 * i + 2] = ucRed;
+    pucDst[4 * i + 3] = pucSrc[4 * i + 3];
+  }
+}
+
+
+static void premultiplyScalar( unsigned char* pucPixels, size_t uiNumPixels )
+{
+  for( size_t i = 0; i < uiNumPixels; i++ )
+  {
+    unsigned char* pucPixel = pucPixels + 4 * i;
+    pucPixel[0] = mulDiv255( pucPixel[0], pucPixel[3] );
+    pucPixel[1] = mulDiv255( pucPixel[1], pucPixel[3] );
+    pucPixel[2] = mulDiv255( pucPixel[2], pucPixel[3] );
+  }
+}
+
+
+static void swapBytesScalar( unsigned char* pucA, unsigned char* pucB, size_t uiSize )
+{
+  std::swap_ranges( pucA, pucA + uiSize, pucB );
+}
+
+
+
+#ifdef GLRENDER_PIXEL_SSE2
+
+static void expandSSE2( const unsigned char* pucSrc, unsigned char* pucDst, size_t uiNumPixels, unsigned char ucAlpha )
+{
+  // four pixels from a 16 byte load: pixel i is moved from byte 3i to byte 4i by shifting
+  // the whole register by i bytes and keeping lane i
+  const __m128i vLane0 = _mm_set_epi32( 0, 0, 0, 0x00FFFFFF );
+  const __m128i vLane1 = _mm_set_epi32( 0, 0, 0x00FFFFFF, 0 );
+  const __m128i vLane2 = _mm_set_epi32( 0, 0x00FFFFFF, 0, 0 );
+  const __m128i vLane3 = _mm_set_epi32( 0x00FFFFFF, 0, 0, 0 );
+  const __m128i vAlpha = _mm_set1_epi32( (int)( (unsigned int)ucAlpha << 24 ) );
+
+  size_t i = 0;
+  // the load reads 4 bytes past the four pixels, stop while they are still inside the source
+  for( ; i + 6 <= uiNumPixels; i += 4 )
+  {
+    const __m128i v = _mm_loadu_si128( (const __m128i*)( pucSrc + 3 * i ) );
+    __m128i vOut = _mm_or_si128( _mm_and_si128( v, vLane0 ), _mm_and_si128( _mm_slli_si128( v, 1 ), vLane1 ) );
+    vOut = _mm_or_si128( vOut, _mm_and_si128( _mm_slli_si128( v, 2 ), vLane2 ) );
+    vOut = _mm_or_si128( vOut, _mm_and_si128( _mm_slli_si128( v, 3 ), vLane3 ) );
+    _mm_storeu_si128( (__m128i*)( pucDst + 4 * i ), _mm_or_si128( vOut, vAlpha ) );
+  }
+  expandScalar( pucSrc + 3 * i, pucDst + 4 * i, uiNumPixels - i, ucAlpha );
+}
+
+
+static void swapRedBlueSSE2( const unsigned char* pucSrc, unsigned char* pucDst, size_t uiNumPixels )
+{
+  const __m128i vGreenAlpha = _mm_set1_epi32( (int)0xFF00FF00 );
+  const __m128i vLow        = _mm_set1_epi32( 0x000000FF );
+  const __m128i vHigh       = _mm_set1_epi32( 0x00FF0000 );
+
+  size_t i = 0;
+  for( ; i + 4 <= uiNumPixels; i += 4 )
+  {
+    const __m128i v = _mm_loadu_si128( (const __m128i*)( pucSrc + 4 * i ) );
+    __m128i vOut = _mm_and_si128( v, vGreenAlpha );
+    vOut = _mm_or_si128( vOut, _mm_and_si128( _mm_srli_epi32( v, 16 ), vLow ) );
+    vOut = _mm_or_si128( vOut, _mm_and_si128( _mm_slli_epi32( v, 16 ), vHigh ) );
+    _mm_storeu_si128( (__m128i*)( pucDst + 4 * i ), vOut );
+  }
+  swapRedBlueScalar( pucSrc + 4 * i, pucDst + 4 * i, uiNumPixels - i );
+}
+
+
+// c * a / 255 for eight 16 bit values, a already broadcast per pixel
+static inline __m128i mulDiv255SSE2( __m128i vC, __m128i vA )
+{
+  __m128i vX = _mm_add_epi16( _mm_mullo_epi16( vC, vA ), _mm_set1_epi16( 128 ) );
+  return _mm_srli_epi16( _mm_add_epi16( vX, _mm_srli_epi16( vX, 8 ) ), 8 );
+}
+
+
+static void premultiplySSE2( unsigned char* pucPixels, size_t uiNumPixels )
+{
+  const __m128i vZero  = _mm_setzero_si128();
+  const __m128i vAlpha = _mm_set1_epi32( (int)0xFF000000 );
+
+  size_t i = 0;
+  for( ; i + 4 <= uiNumPixels; i += 4 )
+  {
+    const __m128i v   = _mm_loadu_si128( (const __m128i*)( pucPixels + 4 * i ) );
+    const __m128i vLo = _mm_unpacklo_epi8( v, vZero );
+    const __m128i vHi = _mm_unpackhi_epi8( v, vZero );
+    const __m128i vALo = _mm_shufflehi_epi16( _mm_shufflelo_epi16( vLo, 0xFF ), 0xFF );
+    const __m128i vAHi = _mm_shufflehi_epi16( _mm_shufflelo_epi16( vHi, 0xFF ), 0xFF );
+    const __m128i vOut = _mm_packus_epi16( mulDiv255SSE2( vLo, vALo ), mulDiv255SSE2( vHi, vAHi ) );
+    // alpha itself stays
+    _mm_storeu_si128( (__m128i*)( pucPixels + 4 * i ), _mm_or_si128( _mm_andnot_si128( vAlpha, vOut ), _mm_and_si128( v, vAlpha ) ) );
+  }
+  premultiplyScalar( pucPixels + 4 * i, uiNumPixels - i );
+}
+
+
+static void swapBytesSSE2( unsigned char* pucA, unsigned char* pucB, size_t uiSize )
+{
+  size_t i = 0;
+  for( ; i + 16 <= uiSize; i += 16 )
+  {
+    const __m128i vA = _mm_loadu_si128( (const __m128i*)( pucA + i ) );
+    const __m128i vB = _mm_loadu_si128( (const __m128i*)( pucB + i ) );
+    _mm_storeu_si128( (__m128i*)( pucA + i ), vB );
+    _mm_storeu_si128( (__m128i*)( pucB + i ), vA );
+  }
+  swapBytesScalar( pucA + i, pucB + i, uiSize - i );
+}
+
+#endif
+
+
+
+#ifdef GLRENDER_PIXEL_AVX2
+
+GLRENDER_TARGET_AVX2
+static void expandAVX2( const unsigned char* pucSrc, unsigned char* pucDst, size_t uiNumPixels, unsigned char ucAlpha )
+{
+  // eight pixels: bytes 0..11 go to the low lane and bytes 12..23 to the high lane, then a
+  // byte shuffle per lane inserts the alpha gaps
+  const __m256i vPermute = _mm256_setr_epi32( 0, 1, 2, 3, 3, 4, 5, 6 );
+  const __m256i vShuffle = _mm256_setr_epi8( 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1,
+                                             0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1 );
+  const __m256i vAlpha   = _mm256_set1_epi32( (int)( (unsigned int)ucAlpha << 24 ) );
+
+  size_t i = 0;
+  // the load reads 8 bytes past the eight pixels
+  for( ; i + 11 <= uiNumPixels; i += 8 )
+  {
+    __m256i v = _mm256_loadu_si256( (const __m256i*)( pucSrc + 3 * i ) );
+    v = _mm256_shuffle_epi8( _mm256_permutevar8x32_epi32( v, vPermute ), vShuffle );
+    _mm256_storeu_si256( (__m256i*)( pucDst + 4 * i ), _mm256_or_si256( v, vAlpha ) );
+  }
+  expandSSE2( pucSrc + 3 * i, pucDst + 4 * i, uiNumPixels - i, ucAlpha );
+}
+
+
+GLRENDER_TARGET_AVX2
+static void swapRedBlueAVX2( const unsigned char* pucSrc, unsigned char* pucDst, size_t uiNumPixels )
+{
+  const __m256i vShuffle = _mm256_setr_epi8( 2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+                                             2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15 );
+  size_t i = 0;
+  for( ; i + 8 <= uiNumPixels; i += 8 )
+  {
+    const __m256i v = _mm256_loadu_si256( (const __m256i*)( pucSrc + 4 * i ) );
+    _mm256_storeu_si256( (__m256i*)( pucDst + 4 * i ), _mm256_shuffle_epi8( v, vShuffle ) );
+  }
+  swapRedBlueSSE2( pucSrc + 4 * i, pucDst + 4 * i, uiNumPixels - i );
+}
+
+
+GLRENDER_TARGET_AVX2
+static void premultiplyAVX2( unsigned char* pucPixels, size_t uiNumPixels )
+{
+  const __m256i vZero  = _mm256_setzero_si256();
+  const __m256i vAlpha = _mm256_set1_epi32( (int)0xFF000000 );
+  const __m256i vRound = _mm256_set1_epi16( 128 );
+
+  size_t i = 0;
+  for( ; i + 8 <= uiNumPixels; i += 8 )
+  {
+    // unpack and pack work per lane, so the pixel order is kept
+    const __m256i v    = _mm256_loadu_si256( (const __m256i*)( pucPixels + 4 * i ) );
+    const __m256i vLo  = _mm256_unpacklo_epi8( v, vZero );
+    const __m256i vHi  = _mm256_unpackhi_epi8( v, vZero );
+    const __m256i vALo = _mm256_shufflehi_epi16( _mm256_shufflelo_epi16( vLo, 0xFF ), 0xFF );
+    const __m256i vAHi = _mm256_shufflehi_epi16( _mm256_shufflelo_epi16( vHi, 0xFF ), 0xFF );
+    __m256i vXLo = _mm256_add_epi16( _mm256_mullo_epi16( vLo, vALo ), vRound );
+    __m256i vXHi = _mm256_add_epi16( _mm256_mullo_epi16( vHi, vAHi ), vRound );
+    vXLo = _mm256_srli_epi16( _mm256_add_epi16( vXLo, _mm256_srli_epi16( vXLo, 8 ) ), 8 );
+    vXHi = _mm256_srli_epi16( _mm256_add_epi16( vXHi, _mm256_srli_epi16( vXHi, 8 ) ), 8 );
+    const __m256i vOut = _mm256_packus_epi16( vXLo, vXHi );
+    _mm256_storeu_si256( (__m256i*)( pucPixels + 4 * i ),
+                         _mm256_or_si256( _mm256_andnot_si256( vAlpha, vOut ), _mm256_and_si256( v, vAlpha ) ) );
+  }
+  premultiplySSE2( pucPixels + 4 * i, uiNumPixels - i );
+}
+
+
+GLRENDER_TARGET_AVX2
+static void swapBytesAVX2( unsigned char* pucA, unsigned char* pucB, size_t uiSize )
+{
+  size_t i = 0;
+  for( ; i + 32 <= uiSize; i += 32 )
+  {
+    const __m256i vA = _mm256_loadu_si256( (const __m256i*)( pucA + i ) );
+    const __m256i vB = _mm256_loadu_si256( (const __m256i*)( pucB + i ) );
+    _mm256_storeu_si256( (__m256i*)( pucA + i ), vB );
+    _mm256_storeu_si256( (__m256i*)( pucB + i ), vA );
+  }
+  swapBytesSSE2( pucA + i, pucB + i, uiSize - i );
+}
+
+#endif
+
+
+
+PixelConvert::Isa
+PixelConvert::getSupportedIsa()
+{
+  return s_eSupportedIsa;
+}
+
+
+PixelConvert::Isa
+PixelConvert::getIsa()
+{
+  return s_eIsa;
+}
+
+
+void
+PixelConvert::setIsa( Isa eIsa )
+{
+  s_eIsa = std::min( eIsa, s_eSupportedIsa );
+}
+
+
+const char*
+PixelConvert::getIsaName( Isa eIsa )
+{
+  switch( eIsa )
+  {
+  case ISA_SCALAR: return "scalar";
+  case ISA_SSE2:   return "sse2";
+  case ISA_AVX2:   return "avx2";
+  }
+  return "unknown";
+}
+
+
+void
+PixelConvert::expandRGBToRGBA( const unsigned char* pucSrc, unsigned char* pucDst, size_t uiNumPixels, unsigned char ucAlpha )
+{
+  switch( s_eIsa )
+  {
+#ifdef GLRENDER_PIXEL_AVX2
+  case ISA_AVX2: expandAVX2( pucSrc, pucDst, uiNumPixels, ucAlpha ); return;
+#endif
+#ifdef GLRENDER_PIXEL_SSE2
+  case ISA_SSE2: expandSSE2( pucSrc, pucDst, uiNumPixels, ucAlpha ); return;
+#endif
+  default:       expandScalar( pucSrc, pucDst, uiNumPixels, ucAlpha ); return;
+  }
+}
+
+
+void
+PixelConvert::swapRedBlue( const unsigned char* pucSrc, unsigned char* pucDst, size_t uiNumPixels )
+{
+  switch( s_eIsa )
+  {
+#ifdef GLRENDER_PIXEL_AVX2
+  case ISA_AVX2: swapRedBlueAVX2( pucSrc, pucDst, uiNumPixels ); return;
+#endif
+#ifdef GLRENDER_PIXEL_SSE2
+  case ISA_SSE2: swapRedBlueSSE2( pucSrc, pucDst, uiNumPixels ); return;
+#endif
+  default:       swapRedBlueScalar( pucSrc, pucDst, uiNumPixels ); return;
+  }
+}
+
+
+void
+PixelConvert::premultiplyAlpha( unsigned char* pucPixels, size_t uiNumPixels )
+{
+  switch( s_eIsa )
+  {
+#ifdef GLRENDER_PIXEL_AVX2
+  case ISA_AVX2: premultiplyAVX2( pucPixels, uiNumPixels ); return;
+#endif
+#ifdef GLRENDER_PIXEL_SSE2
+  case ISA_SSE2: premultiplySSE2( pucPixels, uiNumPixels ); return;
+#endif
+  default:       premultiplyScalar( pucPixels, uiNumPixels ); return;
+  }
+}
+
+
+void
+PixelConvert::flipRows( unsigned char* pucPixels, size_t uiRowBytes, size_t uiNumRows )
+{
+  for( size_t y = 0; y < uiNumRows / 2; y++ )
+  {
+    unsigned char* pucTop    = pucPixels + y * uiRowBytes;
+    unsigned char* pucBottom = pucPixels + ( uiNumRows - 1 - y ) * uiRowBytes;
+    switch( s_eIsa )
+    {
+#ifdef GLRENDER_PIXEL_AVX2
+    case ISA_AVX2: swapBytesAVX2( pucTop, pucBottom, uiRowBytes ); break;
+#endif
+#ifdef GLRENDER_PIXEL_SSE2
+    case ISA_SSE2: swapBytesSSE2( pucTop, pucBottom, uiRowBytes ); break;
+#endif
+    default:       swapBytesScalar( pucTop, pucBottom, uiRowBytes ); break;
+    }
+  }
+}
@@ -0,0 +1,338 @@
+#include "GLRender/Profiler.h"
+#include "GLRender/Common.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+
+
+// ring size, enough for a few hundred frames if nobody collects
+static const size_t s_uiRingCapacity = 4096;
+
+
+
+static double getPercentile( const std::vector<int64_t>& rcSorted, double dP )
+{
+  if( rcSorted.empty() ) return -1.0;
+
+  // nearest rank
+  size_t uiRank = (size_t)std::ceil( dP * rcSorted.size() );
+  if( uiRank > 0 ) uiRank--;
+  return rcSorted[std::min( uiRank, rcSorted.size() - 1 )] / 1.0e6;
+}
+
+
+const unsigned int Profiler::DEFAULT_HISTORY_FRAMES;
+
+
+// constructor
+Profiler::Profiler()
+  : m_bEnabled( true )
+  , m_bInFrame( false )
+  , m_uiFrame( 0 )
+  , m_iEpoch( 0 )
+  , m_iFrameStartNs( 0 )
+  , m_bGpuActive( false )
+  , m_cRing( s_uiRingCapacity )
+  , m_uiNumDropped( 0 )
+  , m_uiHistoryFrames( DEFAULT_HISTORY_FRAMES )
+{
+  m_iEpoch = now();
+  for( unsigned int i = 0; i < FRAMES_IN_FLIGHT; i++ ) m_acSlots[i].uiNumUsed = 0;
+
+  registerScope( "frame", false );
+}
+
+
+// destructor
+Profiler::~Profiler()
+{
+  // GL queries are released in destroy(), the context may be gone already
+}
+
+
+unsigned int
+Profiler::registerScope( const std::string& rcName, bool bGpu )
+{
+  Scope cScope;
+  cScope.cName = rcName;
+  cScope.bGpu  = bGpu;
+  m_cScopes.push_back( cScope );
+  return (unsigned int)m_cScopes.size() - 1;
+}
+
+
+int64_t
+Profiler::now() const
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now().time_since_epoch() ).count() - m_iEpoch;
+}
+
+
+void
+Profiler::beginFrame()
+{
+  if( !m_bEnabled ) return;
+
+  m_uiFrame++;
+
+  // the slot was used FRAMES_IN_FLIGHT frames ago, its queries are done by now
+  FrameSlot& rcSlot = m_acSlots[m_uiFrame % FRAMES_IN_FLIGHT];
+  resolve( rcSlot );
+  rcSlot.uiNumUsed = 0;
+
+  m_cOpen.clear();
+  m_bGpuActive    = false;
+  m_bInFrame      = true;
+  m_iFrameStartNs = now();
+}
+
+
+void
+Profiler::endFrame()
+{
+  if( !m_bInFrame ) return;
+
+  // close scopes left open
+  while( !m_cOpen.empty() ) end( m_cOpen.back().uiScope );
+
+  PendingScope cFrame;
+  cFrame.cSample.uiScope     = FRAME_SCOPE;
+  cFrame.cSample.uiFrame     = m_uiFrame;
+  cFrame.cSample.iCpuStartNs = m_iFrameStartNs;
+  cFrame.cSample.iCpuNs      = now() - m_iFrameStartNs;
+  cFrame.cSample.iGpuNs      = -1;
+  cFrame.uiQuery             = 0;
+  m_acSlots[m_uiFrame % FRAMES_IN_FLIGHT].cPending.push_back( cFrame );
+
+  m_bInFrame = false;
+}
+
+
+void
+Profiler::begin( unsigned int uiScope )
+{
+  if( !m_bInFrame ) return;
+
+  OpenScope cOpen;
+  cOpen.uiScope = uiScope;
+  cOpen.uiQuery = 0;
+
+  if( m_cScopes[uiScope].bGpu && !m_bGpuActive )
+  {
+    FrameSlot& rcSlot = m_acSlots[m_uiFrame % FRAMES_IN_FLIGHT];
+    if( rcSlot.uiNumUsed == rcSlot.cQueries.size() )
+    {
+      GLuint uiQuery = 0;
+      glGenQueries( 1, &uiQuery );
+      rcSlot.cQueries.push_back( uiQuery );
+    }
+    cOpen.uiQuery = rcSlot.cQueries[rcSlot.uiNumUsed++];
+    glBeginQuery( GL_TIME_ELAPSED, cOpen.uiQuery );
+    m_bGpuActive = true;
+  }
+
+  cOpen.iStartNs = now();
+  m_cOpen.push_back( cOpen );
+}
+
+
+void
+Profiler::end( unsigned int uiScope )
+{
+  if( !m_bInFrame || m_cOpen.empty() ) return;
+
+  int64_t iEndNs = now();
+  OpenScope cOpen = m_cOpen.back();
+  m_cOpen.pop_back();
+  if( cOpen.uiScope != uiScope )
+  {
+    std::cerr << "profiler: scope " << m_cScopes[uiScope].cName << " closed while " << m_cScopes[cOpen.uiScope].cName << " is open" << std::endl;
+  }
+
+  if( cOpen.uiQuery )
+  {
+    glEndQuery( GL_TIME_ELAPSED );
+    m_bGpuActive = false;
+  }
+
+  PendingScope cPending;
+  cPending.cSample.uiScope     = cOpen.uiScope;
+  cPending.cSample.uiFrame     = m_uiFrame;
+  cPending.cSample.iCpuStartNs = cOpen.iStartNs;
+  cPending.cSample.iCpuNs      = iEndNs - cOpen.iStartNs;
+  cPending.cSample.iGpuNs      = -1;
+  cPending.uiQuery             = cOpen.uiQuery;
+  m_acSlots[m_uiFrame % FRAMES_IN_FLIGHT].cPending.push_back( cPending );
+}
+
+
+void
+Profiler::resolve( FrameSlot& rcSlot )
+{
+  for( size_t i = 0; i < rcSlot.cPending.size(); i++ )
+  {
+    PendingScope& rcPending = rcSlot.cPending[i];
+    if( rcPending.uiQuery )
+    {
+      GLuint64 uiNs = 0;
+      glGetQueryObjectui64v( rcPending.uiQuery, GL_QUERY_RESULT, &uiNs );
+      rcPending.cSample.iGpuNs = (int64_t)uiNs;
+    }
+    publish( rcPending.cSample );
+  }
+  rcSlot.cPending.clear();
+}
+
+
+void
+Profiler::publish( const ProfileSample& rcSample )
+{
+  if( !m_cRing.push( rcSample ) ) m_uiNumDropped.fetch_add( 1, std::memory_order_relaxed );
+}
+
+
+void
+Profiler::flush()
+{
+  // oldest frame first, the current slot last
+  for( unsigned int i = 1; i <= FRAMES_IN_FLIGHT; i++ )
+  {
+    resolve( m_acSlots[( m_uiFrame + i ) % FRAMES_IN_FLIGHT] );
+  }
+}
+
+
+void
+Profiler::destroy()
+{
+  for( unsigned int i = 0; i < FRAMES_IN_FLIGHT; i++ )
+  {
+    FrameSlot& rcSlot = m_acSlots[i];
+    if( !rcSlot.cQueries.empty() ) glDeleteQueries( (GLsizei)rcSlot.cQueries.size(), rcSlot.cQueries.data() );
+    rcSlot.cQueries.clear();
+    rcSlot.cPending.clear();
+    rcSlot.uiNumUsed = 0;
+  }
+  m_cOpen.clear();
+  m_bGpuActive = false;
+  m_bInFrame   = false;
+}
+
+
+void
+Profiler::collect()
+{
+  ProfileSample cSample;
+  while( m_cRing.pop( cSample ) ) m_cHistory.push_back( cSample );
+
+  // keep a window of the most recent frames (frame numbers only grow)
+  if( m_cHistory.empty() ) return;
+  const uint32_t uiNewest = m_cHistory.back().uiFrame;
+  while( !m_cHistory.empty() && (int32_t)( uiNewest - m_cHistory.front().uiFrame ) >= (int32_t)m_uiHistoryFrames )
+  {
+    m_cHistory.pop_front();
+  }
+}
+
+
+void
+Profiler::getSummary( std::vector<ProfileSummary>& rcSummary ) const
+{
+  rcSummary.clear();
+
+  std::vector< std::vector<int64_t> > cCpu( m_cScopes.size() );
+  std::vector< std::vector<int64_t> > cGpu( m_cScopes.size() );
+  for( const ProfileSample& rcSample : m_cHistory )
+  {
+    if( rcSample.uiScope >= m_cScopes.size() ) continue;
+    cCpu[rcSample.uiScope].push_back( rcSample.iCpuNs );
+    if( rcSample.iGpuNs >= 0 ) cGpu[rcSample.uiScope].push_back( rcSample.iGpuNs );
+  }
+
+  const double adP[3] = { 0.50, 0.95, 0.99 };
+  for( size_t s = 0; s < m_cScopes.size(); s++ )
+  {
+    if( cCpu[s].empty() ) continue;
+    std::sort( cCpu[s].begin(), cCpu[s].end() );
+    std::sort( cGpu[s].begin(), cGpu[s].end() );
+
+    ProfileSummary cSummary;
+    cSummary.cName   = m_cScopes[s].cName;
+    cSummary.uiCount = cCpu[s].size();
+    for( int p = 0; p < 3; p++ )
+    {
+      cSummary.adCpuMs[p] = getPercentile( cCpu[s], adP[p] );
+      cSummary.adGpuMs[p] = getPercentile( cGpu[s], adP[p] );
+    }
+    rcSummary.push_back( cSummary );
+  }
+}
+
+
+void
+Profiler::printSummary( std::ostream& rcStrm ) const
+{
+  std::vector<ProfileSummary> cSummary;
+  getSummary( cSummary );
+
+  rcStrm << std::left << std::setw( 14 ) << "scope" << std::right << std::setw( 8 ) << "frames"
+         << "   cpu p50/p95/p99 [ms]     gpu p50/p95/p99 [ms]" << std::endl;
+  for( const ProfileSummary& rcScope : cSummary )
+  {
+    rcStrm << std::left << std::setw( 14 ) << rcScope.cName << std::right << std::setw( 8 ) << rcScope.uiCount << "   "
+           << std::fixed << std::setprecision( 3 );
+    for( int p = 0; p < 3; p++ ) rcStrm << std::setw( 7 ) << rcScope.adCpuMs[p] << ( p < 2 ? " " : "" );
+    rcStrm << "   ";
+    if( rcScope.adGpuMs[0] < 0.0 ) rcStrm << std::setw( 23 ) << "-";
+    else for( int p = 0; p < 3; p++ ) rcStrm << std::setw( 7 ) << rcScope.adGpuMs[p] << ( p < 2 ? " " : "" );
+    rcStrm << std::defaultfloat << std::endl;
+  }
+  if( getNumDropped() ) rcStrm << "(" << getNumDropped() << " samples dropped)" << std::endl;
+}
+
+
+int
+Profiler::writeChromeTrace( const std::string& rcFName ) const
+{
+  std::ofstream cStrm( rcFName, std::ios::trunc );
+  if( !cStrm.is_open() )
+  {
+    std::cerr << "cannot write trace " << rcFName << std::endl;
+    return -1;
+  }
+
+  // complete events ("ph":"X") in microseconds; CPU scopes on thread 1, GPU durations on
+  // thread 2. The GPU start is not measured, the events are placed at the CPU start.
+  cStrm << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[" << std::endl;
+  cStrm << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"CPU\"}}," << std::endl;
+  cStrm << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\"GPU\"}}";
+
+  cStrm << std::fixed << std::setprecision( 3 );
+  for( const ProfileSample& rcSample : m_cHistory )
+  {
+    if( rcSample.uiScope >= m_cScopes.size() ) continue;
+    const std::string& rcName = m_cScopes[rcSample.uiScope].cName;
+
+    cStrm << "," << std::endl << "{\"name\":";
+    cStrm << getJsonString( rcName );
+    cStrm << ",\"cat\":\"cpu\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":" << rcSample.iCpuStartNs / 1000.0
+          << ",\"dur\":" << rcSample.iCpuNs / 1000.0 << ",\"args\":{\"frame\":" << rcSample.uiFrame << "}}";
+
+    if( rcSample.iGpuNs >= 0 )
+    {
+      cStrm << "," << std::endl << "{\"name\":";
+      cStrm << getJsonString( rcName );
+      cStrm << ",\"cat\":\"gpu\",\"ph\":\"X\",\"pid\":1,\"tid\":2,\"ts\":" << rcSample.iCpuStartNs / 1000.0
+            << ",\"dur\":" << rcSample.iGpuNs / 1000.0 << ",\"args\":{\"frame\":" << rcSample.uiFrame << "}}";
+    }
+  }
+  cStrm << std::endl << "]}" << std::endl;
+
+  return cStrm ? 0 : -1;
+}
@@ -0,0 +1,163 @@
+#include "GLRender/RenderQueue.h"
+#include "GLRender/GLDebug.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+
+// constructor
+DrawItem::DrawItem()
+  : uiLayer( 0 )
+  , fDepth( 0.0f )
+  , uiProgram( 0 )
+  , uiTexture( 0 )
+  , uiVAO( 0 )
+  , bDepthTest( true )
+  , eDepthFunc( GL_LESS )
+  , bDepthWrite( true )
+  , eMode( GL_TRIANGLES )
+  , iCount( 0 )
+  , eIndexType( 0 )
+  , iInstances( 1 )
+  , uiKey( 0 )
+{
+}
+
+
+
+// constructor
+RenderQueue::RenderQueue()
+{
+  m_cStats.uiItems             = 0;
+  m_cStats.uiDrawCalls         = 0;
+  m_cStats.uiStateChanges      = 0;
+  m_cStats.uiSavedStateChanges = 0;
+}
+
+
+void
+RenderQueue::submit( const DrawItem& rcItem )
+{
+  m_cItems.push_back( rcItem );
+  m_cItems.back().uiKey = computeKey( rcItem );
+}
+
+
+uint64_t
+RenderQueue::computeKey( const DrawItem& rcItem )
+{
+  // | layer : 4 | depth test : 1 | program : 11 | texture : 12 | VAO : 12 | depth : 24 |
+  // GL names are small integers, so the low bits group equal states together; a collision
+  // only costs a bind, execute() compares the real names
+  uint64_t uiDepth = 0;
+  if( rcItem.fDepth > 0.0f )
+  {
+    // logarithmic distribution keeps precision near the camera
+    float fD = std::log2( 1.0f + rcItem.fDepth ) / 16.0f;
+    uiDepth = (uint64_t)( std::min( fD, 1.0f ) * 16777215.0f );
+  }
+
+  return ( (uint64_t)( rcItem.uiLayer & 0xf )            << 60 )
+       | ( (uint64_t)( rcItem.bDepthTest ? 1 : 0 )       << 59 )
+       | ( (uint64_t)( rcItem.uiProgram & 0x7ff )        << 48 )
+       | ( (uint64_t)( rcItem.uiTexture & 0xfff )        << 36 )
+       | ( (uint64_t)( rcItem.uiVAO & 0xfff )            << 24 )
+       | uiDepth;
+}
+
+
+void
+RenderQueue::execute()
+{
+  m_cStats.uiItems             = (unsigned int)m_cItems.size();
+  m_cStats.uiDrawCalls         = 0;
+  m_cStats.uiStateChanges      = 0;
+  m_cStats.uiSavedStateChanges = 0;
+
+  // sort indices instead of the items with their callbacks
+  m_cOrder.resize( m_cItems.size() );
+  for( uint32_t i = 0; i < m_cOrder.size(); i++ ) m_cOrder[i] = i;
+  std::stable_sort( m_cOrder.begin(), m_cOrder.end(),
+                    [this]( uint32_t a, uint32_t b ) { return m_cItems[a].uiKey < m_cItems[b].uiKey; } );
+
+  // current state, invalid before the first item
+  bool    bFirst     = true;
+  GLuint  uiProgram  = 0;
+  GLuint  uiTexture  = 0;
+  GLuint  uiVAO      = 0;
+  bool    bDepthTest = true;
+  GLenum  eDepthFunc = GL_LESS;
+  bool    bDepthWrite = true;
+
+  for( uint32_t uiIdx : m_cOrder )
+  {
+    const DrawItem& rcItem = m_cItems[uiIdx];
+
+    if( bFirst || rcItem.bDepthTest != bDepthTest || rcItem.eDepthFunc != eDepthFunc || rcItem.bDepthWrite != bDepthWrite )
+    {
+      if( rcItem.bDepthTest ) glEnable( GL_DEPTH_TEST );
+      else                    glDisable( GL_DEPTH_TEST );
+      glDepthFunc( rcItem.eDepthFunc );
+      glDepthMask( rcItem.bDepthWrite ? GL_TRUE : GL_FALSE );
+      bDepthTest  = rcItem.bDepthTest;
+      eDepthFunc  = rcItem.eDepthFunc;
+      bDepthWrite = rcItem.bDepthWrite;
+      m_cStats.uiStateChanges++;
+    }
+    else m_cStats.uiSavedStateChanges++;
+
+    if( bFirst || rcItem.uiProgram != uiProgram )
+    {
+      glUseProgram( rcItem.uiProgram );
+      uiProgram = rcItem.uiProgram;
+      m_cStats.uiStateChanges++;
+    }
+    else m_cStats.uiSavedStateChanges++;
+
+    if( bFirst || rcItem.uiTexture != uiTexture )
+    {
+      glActiveTexture( GL_TEXTURE0 );
+      glBindTexture( GL_TEXTURE_2D, rcItem.uiTexture );
+      uiTexture = rcItem.uiTexture;
+      m_cStats.uiStateChanges++;
+    }
+    else m_cStats.uiSavedStateChanges++;
+
+    if( bFirst || rcItem.uiVAO != uiVAO )
+    {
+      glBindVertexArray( rcItem.uiVAO );
+      uiVAO = rcItem.uiVAO;
+      m_cStats.uiStateChanges++;
+    }
+    else m_cStats.uiSavedStateChanges++;
+
+    bFirst = false;
+
+    if( rcItem.fnUniforms ) rcItem.fnUniforms();
+
+    if( rcItem.eIndexType )
+    {
+      if( rcItem.iInstances > 1 ) glDrawElementsInstanced( rcItem.eMode, rcItem.iCount, rcItem.eIndexType, 0, rcItem.iInstances );
+      else                        glDrawElements( rcItem.eMode, rcItem.iCount, rcItem.eIndexType, 0 );
+    }
+    else
+    {
+      if( rcItem.iInstances > 1 ) glDrawArraysInstanced( rcItem.eMode, 0, rcItem.iCount, rcItem.iInstances );
+      else                        glDrawArrays( rcItem.eMode, 0, rcItem.iCount );
+    }
+    m_cStats.uiDrawCalls++;
+  }
+
+  // leave the default state for code drawing outside of the queue
+  if( !bFirst )
+  {
+    glBindVertexArray( 0 );
+    if( !bDepthTest ) glEnable( GL_DEPTH_TEST );
+    if( eDepthFunc != GL_LESS ) glDepthFunc( GL_LESS );
+    if( !bDepthWrite ) glDepthMask( GL_TRUE );
+  }
+  GL_CHECK( "RenderQueue::execute" );
+
+  m_cItems.clear();
+}
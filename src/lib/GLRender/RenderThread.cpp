@@ -0,0 +1,124 @@
+#include "GLRender/RenderThread.h"
+
+#include <chrono>
+
+
+
+// constructor
+RenderThread::RenderThread()
+  : m_bStop( false )
+  , m_bBusy( false )
+  , m_uiNumFrames( 0 )
+  , m_dWaitMs( 0.0 )
+{
+}
+
+
+// destructor
+RenderThread::~RenderThread()
+{
+  stop();
+}
+
+
+void
+RenderThread::start( const std::function<void()>& fnAttach, const std::function<void()>& fnDetach )
+{
+  if( isRunning() ) return;
+  m_bStop = false;
+  m_cThread = std::thread( &RenderThread::threadLoop, this, fnAttach, fnDetach );
+}
+
+
+void
+RenderThread::stop()
+{
+  if( !isRunning() ) return;
+  {
+    std::lock_guard<std::mutex> cLock( m_cMutex );
+    m_bStop = true;
+  }
+  m_cWakeUp.notify_all();
+  m_cThread.join();
+}
+
+
+void
+RenderThread::submit( const std::function<void()>& fnFrame )
+{
+  if( !isRunning() )
+  {
+    fnFrame();
+    return;
+  }
+
+  std::unique_lock<std::mutex> cLock( m_cMutex );
+  if( m_cFrames.size() >= MAX_PENDING )
+  {
+    // the render thread is a full frame behind: wait instead of queueing up latency
+    const auto cStart = std::chrono::steady_clock::now();
+    m_cDone.wait( cLock, [this]() { return m_cFrames.size() < MAX_PENDING; } );
+    m_dWaitMs += std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - cStart ).count();
+  }
+  m_cFrames.push_back( fnFrame );
+  m_cWakeUp.notify_one();
+}
+
+
+void
+RenderThread::finish()
+{
+  if( !isRunning() ) return;
+
+  std::unique_lock<std::mutex> cLock( m_cMutex );
+  m_cDone.wait( cLock, [this]() { return m_cFrames.empty() && !m_bBusy; } );
+}
+
+
+uint64_t
+RenderThread::getNumFrames() const
+{
+  std::lock_guard<std::mutex> cLock( m_cMutex );
+  return m_uiNumFrames;
+}
+
+
+double
+RenderThread::getWaitMs() const
+{
+  std::lock_guard<std::mutex> cLock( m_cMutex );
+  return m_dWaitMs;
+}
+
+
+void
+RenderThread::threadLoop( std::function<void()> fnAttach, std::function<void()> fnDetach )
+{
+  if( fnAttach ) fnAttach();
+
+  for( ;; )
+  {
+    std::function<void()> fnFrame;
+    {
+      std::unique_lock<std::mutex> cLock( m_cMutex );
+      m_cWakeUp.wait( cLock, [this]() { return m_bStop || !m_cFrames.empty(); } );
+      // frames submitted before stop are still drawn
+      if( m_cFrames.empty() ) break;
+      fnFrame = std::move( m_cFrames.front() );
+      m_cFrames.pop_front();
+      m_bBusy = true;
+    }
+    m_cDone.notify_all();
+
+    fnFrame();
+
+    {
+      std::lock_guard<std::mutex> cLock( m_cMutex );
+      m_bBusy = false;
+      m_uiNumFrames++;
+    }
+    m_cDone.notify_all();
+  }
+
+  if( fnDetach ) fnDetach();
+}
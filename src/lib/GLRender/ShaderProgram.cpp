@@ -1,4 +1,5 @@
 #include "GLRender/ShaderProgram.h"
+#include "GLRender/GLExtensions.h"
 
 #include <iostream>
 #include <cmath>
@@ -107,3 +108,46 @@ ShaderProgram::useProgram()
   glUseProgram(m_uiShaderPrg);
 }
 
+
+
+void
+ShaderProgram::setBinaryRetrievable()
+{
+  if( GLEXT_program_binary ) glProgramParameteri( m_uiShaderPrg, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE );
+}
+
+
+int
+ShaderProgram::getBinary( GLenum& reFormat, std::vector<unsigned char>& rcBinary ) const
+{
+  if( !GLEXT_program_binary ) return -1;
+
+  GLint iLength = 0;
+  glGetProgramiv( m_uiShaderPrg, GL_PROGRAM_BINARY_LENGTH, &iLength );
+  if( iLength <= 0 ) return -1;
+
+  rcBinary.resize( iLength );
+  glGetProgramBinary( m_uiShaderPrg, iLength, &iLength, &reFormat, rcBinary.data() );
+  rcBinary.resize( iLength );
+
+  return iLength > 0 ? 0 : -1;
+}
+
+
+int
+ShaderProgram::loadBinary( GLenum eFormat, const void* pvBinary, GLsizei iLength )
+{
+  GLint   iLinked;
+
+  if( !GLEXT_program_binary ) return -1;
+
+  glProgramBinary( m_uiShaderPrg, eFormat, pvBinary, iLength );
+
+  // the driver rejects binaries of other versions, the caller has to compile then
+  glGetProgramiv( m_uiShaderPrg, GL_LINK_STATUS, &iLinked );
+  if( !iLinked ) return -1;
+
+  useProgram();
+
+  return 0;
+}
@@ -0,0 +1,232 @@
+#include "GLRender/ShaderRegistry.h"
+#include "GLRender/GLExtensions.h"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+
+
+// header of a cached program binary
+struct ProgramBinaryHeader
+{
+  char      acMagic[8];
+  uint64_t  uiDriverHash;
+  uint32_t  uiFormat;
+  uint32_t  uiLength;
+};
+
+static const char s_acBinaryMagic[8] = { 'M', 'A', 'D', 'N', 'P', 'R', 'G', '1' };
+
+
+
+// 64 bit FNV-1a
+static uint64_t hashBytes( uint64_t uiHash, const void* pvData, size_t uiSize )
+{
+  const unsigned char* pucData = (const unsigned char*)pvData;
+  for( size_t i = 0; i < uiSize; i++ )
+  {
+    uiHash ^= pucData[i];
+    uiHash *= 0x100000001b3ULL;
+  }
+  return uiHash;
+}
+
+static const uint64_t s_uiHashSeed = 0xcbf29ce484222325ULL;
+
+
+
+// constructor
+ShaderRegistry::ShaderRegistry()
+  : m_uiDriverHash( 0 )
+  , m_uiNumCompiled( 0 )
+  , m_uiNumBinaryLoads( 0 )
+  , m_uiNumShared( 0 )
+{
+}
+
+
+ShaderRegistry&
+ShaderRegistry::get()
+{
+  static ShaderRegistry s_cRegistry;
+  return s_cRegistry;
+}
+
+
+void
+ShaderRegistry::setCacheDirectory( const std::string& rcDir )
+{
+  m_cCacheDir = rcDir;
+  if( m_cCacheDir.empty() ) return;
+
+  std::error_code cErr;
+  std::filesystem::create_directories( m_cCacheDir, cErr );
+  if( cErr )
+  {
+    std::cerr << "cannot create shader cache directory " << m_cCacheDir << ": " << cErr.message() << std::endl;
+    m_cCacheDir.clear();
+  }
+}
+
+
+std::string
+ShaderRegistry::readShaderFile( const std::string& rcPath )
+{
+  std::ifstream cFile( rcPath );
+  if( !cFile.is_open() )
+  {
+    std::cerr << "cannot open shader file " << rcPath << std::endl;
+    return std::string();
+  }
+  std::stringstream cBuffer;
+  cBuffer << cFile.rdbuf();
+  return cBuffer.str();
+}
+
+
+ShaderHandle
+ShaderRegistry::acquire( const std::string& rcVertexPath, const std::string& rcFragmentPath )
+{
+  std::string cVertexSrc   = readShaderFile( rcVertexPath );
+  std::string cFragmentSrc = readShaderFile( rcFragmentPath );
+  if( cVertexSrc.empty() || cFragmentSrc.empty() ) return ShaderHandle();
+
+  return acquireSource( cVertexSrc, cFragmentSrc );
+}
+
+
+ShaderHandle
+ShaderRegistry::acquireSource( const std::string& rcVertexSrc, const std::string& rcFragmentSrc )
+{
+  uint64_t uiHash = hashSources( rcVertexSrc, rcFragmentSrc );
+
+  // share the program if it is alive already
+  std::weak_ptr<ShaderProgram>& rcEntry = m_cPrograms[uiHash];
+  ShaderHandle cProg = rcEntry.lock();
+  if( cProg )
+  {
+    m_uiNumShared++;
+    return cProg;
+  }
+
+  // try the binary from the last run
+  cProg = loadCachedBinary( uiHash );
+  if( cProg )
+  {
+    m_uiNumBinaryLoads++;
+    rcEntry = cProg;
+    return cProg;
+  }
+
+  // compile and link
+  cProg = std::make_shared<ShaderProgram>();
+  const GLchar* pcVertexSrc   = rcVertexSrc.c_str();
+  const GLchar* pcFragmentSrc = rcFragmentSrc.c_str();
+  if( cProg->addShader( &pcVertexSrc, GL_VERTEX_SHADER ) ) return ShaderHandle();
+  if( cProg->addShader( &pcFragmentSrc, GL_FRAGMENT_SHADER ) ) return ShaderHandle();
+  cProg->setBinaryRetrievable();
+  if( cProg->linkShaders() ) return ShaderHandle();
+  m_uiNumCompiled++;
+
+  storeCachedBinary( uiHash, *cProg );
+
+  rcEntry = cProg;
+  return cProg;
+}
+
+
+uint64_t
+ShaderRegistry::hashSources( const std::string& rcVertexSrc, const std::string& rcFragmentSrc )
+{
+  // include the terminating zero to separate both sources
+  uint64_t uiHash = hashBytes( s_uiHashSeed, rcVertexSrc.c_str(), rcVertexSrc.size() + 1 );
+  return hashBytes( uiHash, rcFragmentSrc.c_str(), rcFragmentSrc.size() + 1 );
+}
+
+
+uint64_t
+ShaderRegistry::getDriverHash()
+{
+  if( m_uiDriverHash ) return m_uiDriverHash;
+
+  uint64_t uiHash = s_uiHashSeed;
+  const GLenum aeNames[] = { GL_VENDOR, GL_RENDERER, GL_VERSION };
+  for( GLenum eName : aeNames )
+  {
+    const char* pcStr = (const char*)glGetString( eName );
+    if( pcStr ) uiHash = hashBytes( uiHash, pcStr, std::strlen( pcStr ) + 1 );
+  }
+  m_uiDriverHash = uiHash;
+  return m_uiDriverHash;
+}
+
+
+std::string
+ShaderRegistry::getCacheFileName( uint64_t uiHash ) const
+{
+  char acName[32];
+  std::snprintf( acName, sizeof(acName), "%016llx.bin", (unsigned long long)uiHash );
+  return m_cCacheDir + "/" + acName;
+}
+
+
+ShaderHandle
+ShaderRegistry::loadCachedBinary( uint64_t uiHash )
+{
+  if( m_cCacheDir.empty() || !GLEXT_program_binary ) return ShaderHandle();
+
+  std::ifstream cStrm( getCacheFileName( uiHash ), std::ios::binary );
+  if( !cStrm.is_open() ) return ShaderHandle();
+
+  ProgramBinaryHeader cHeader;
+  if( !cStrm.read( (char*)&cHeader, sizeof(cHeader) ) ) return ShaderHandle();
+  if( std::memcmp( cHeader.acMagic, s_acBinaryMagic, sizeof(s_acBinaryMagic) ) ) return ShaderHandle();
+  if( cHeader.uiDriverHash != getDriverHash() ) return ShaderHandle();
+
+  std::vector<unsigned char> cBinary( cHeader.uiLength );
+  if( !cStrm.read( (char*)cBinary.data(), cBinary.size() ) ) return ShaderHandle();
+
+  ShaderHandle cProg = std::make_shared<ShaderProgram>();
+  if( cProg->loadBinary( cHeader.uiFormat, cBinary.data(), (GLsizei)cBinary.size() ) )
+  {
+    std::cerr << "shader cache: binary rejected by the driver, recompiling" << std::endl;
+    return ShaderHandle();
+  }
+
+  return cProg;
+}
+
+
+void
+ShaderRegistry::storeCachedBinary( uint64_t uiHash, const ShaderProgram& rcProg )
+{
+  if( m_cCacheDir.empty() || !GLEXT_program_binary ) return;
+
+  ProgramBinaryHeader cHeader;
+  std::vector<unsigned char> cBinary;
+  GLenum eFormat = 0;
+  if( rcProg.getBinary( eFormat, cBinary ) ) return;
+
+  std::memcpy( cHeader.acMagic, s_acBinaryMagic, sizeof(s_acBinaryMagic) );
+  cHeader.uiDriverHash = getDriverHash();
+  cHeader.uiFormat     = eFormat;
+  cHeader.uiLength     = (uint32_t)cBinary.size();
+
+  // write to a temporary file first so that a crash never leaves a truncated binary
+  std::string cFName = getCacheFileName( uiHash );
+  std::string cTmpName = cFName + ".tmp";
+  {
+    std::ofstream cStrm( cTmpName, std::ios::binary | std::ios::trunc );
+    if( !cStrm.is_open() ) return;
+    cStrm.write( (const char*)&cHeader, sizeof(cHeader) );
+    cStrm.write( (const char*)cBinary.data(), cBinary.size() );
+    if( !cStrm ) return;
+  }
+  std::error_code cErr;
+  std::filesystem::rename( cTmpName, cFName, cErr );
+}
@@ -0,0 +1,232 @@
+#include "GLRender/StreamBuffer.h"
+#include "GLRender/GLExtensions.h"
+
+#include <algorithm>
+#include <iostream>
+
+
+
+// constructor
+StreamBuffer::StreamBuffer()
+  : m_eTarget( GL_ARRAY_BUFFER )
+  , m_uiBuffer( 0 )
+  , m_bPersistent( false )
+  , m_bMapped( false )
+  , m_uiRegionSize( 0 )
+  , m_uiHead( 0 )
+  , m_pucPersistent( NULL )
+  , m_uiFrame( 0 )
+  , m_uiGeneration( 0 )
+  , m_uiBytesMapped( 0 )
+  , m_uiNumWaits( 0 )
+  , m_uiNumOrphans( 0 )
+  , m_uiNumGrows( 0 )
+{
+  for( unsigned int i = 0; i < NUM_REGIONS; i++ ) m_apcFences[i] = NULL;
+}
+
+
+// destructor
+StreamBuffer::~StreamBuffer()
+{
+  destroy();
+}
+
+
+int
+StreamBuffer::create( GLenum eTarget, size_t uiFrameSize, bool bPersistent )
+{
+  destroy();
+  m_eTarget     = eTarget;
+  m_bPersistent = bPersistent && GLEXT_buffer_storage;
+  return allocate( std::max( uiFrameSize, (size_t)256 ) );
+}
+
+
+void
+StreamBuffer::destroy()
+{
+  for( unsigned int i = 0; i < NUM_REGIONS; i++ )
+  {
+    if( m_apcFences[i] ) glDeleteSync( m_apcFences[i] );
+    m_apcFences[i] = NULL;
+  }
+
+  if( m_uiBuffer )
+  {
+    if( m_pucPersistent || m_bMapped )
+    {
+      glBindBuffer( m_eTarget, m_uiBuffer );
+      glUnmapBuffer( m_eTarget );
+      glBindBuffer( m_eTarget, 0 );
+    }
+    glDeleteBuffers( 1, &m_uiBuffer );
+  }
+  m_uiBuffer      = 0;
+  m_pucPersistent = NULL;
+  m_bMapped       = false;
+  m_uiRegionSize  = 0;
+  m_uiHead        = 0;
+  m_uiGeneration++;
+}
+
+
+int
+StreamBuffer::allocate( size_t uiRegionSize )
+{
+  // the old buffer stays alive as long as a VAO or a pending draw references it
+  if( m_uiBuffer )
+  {
+    unsigned int uiGeneration = m_uiGeneration;
+    destroy();
+    m_uiGeneration = uiGeneration;
+  }
+  m_uiGeneration++;
+
+  m_uiRegionSize = uiRegionSize;
+  m_uiHead       = 0;
+  const GLsizeiptr iSize = (GLsizeiptr)( uiRegionSize * NUM_REGIONS );
+
+  glGenBuffers( 1, &m_uiBuffer );
+  glBindBuffer( m_eTarget, m_uiBuffer );
+  if( m_bPersistent )
+  {
+    // coherent: writes become visible without explicit flushes or barriers
+    const GLbitfield uiFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glBufferStorage( m_eTarget, iSize, NULL, uiFlags );
+    m_pucPersistent = (unsigned char*)glMapBufferRange( m_eTarget, 0, iSize, uiFlags );
+    if( !m_pucPersistent )
+    {
+      std::cerr << "StreamBuffer: persistent mapping failed, using orphaning" << std::endl;
+      glBindBuffer( m_eTarget, 0 );
+      glDeleteBuffers( 1, &m_uiBuffer );
+      m_bPersistent = false;
+      glGenBuffers( 1, &m_uiBuffer );
+      glBindBuffer( m_eTarget, m_uiBuffer );
+    }
+  }
+  if( !m_bPersistent ) glBufferData( m_eTarget, iSize, NULL, GL_STREAM_DRAW );
+  glBindBuffer( m_eTarget, 0 );
+
+  return m_uiBuffer ? 0 : -1;
+}
+
+
+void
+StreamBuffer::beginFrame()
+{
+  m_uiFrame++;
+  if( !m_bPersistent ) return;
+
+  // the region was last used NUM_REGIONS frames ago, normally the GPU is long done with it
+  GLsync& rpcFence = m_apcFences[m_uiFrame % NUM_REGIONS];
+  if( rpcFence )
+  {
+    GLenum eResult = glClientWaitSync( rpcFence, 0, 0 );
+    if( eResult == GL_TIMEOUT_EXPIRED )
+    {
+      m_uiNumWaits++;
+      do
+      {
+        eResult = glClientWaitSync( rpcFence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000 );
+      } while( eResult == GL_TIMEOUT_EXPIRED );
+    }
+    glDeleteSync( rpcFence );
+    rpcFence = NULL;
+  }
+  m_uiHead = 0;
+}
+
+
+void
+StreamBuffer::endFrame()
+{
+  if( !m_bPersistent ) return;
+
+  GLsync& rpcFence = m_apcFences[m_uiFrame % NUM_REGIONS];
+  if( rpcFence ) glDeleteSync( rpcFence );
+  rpcFence = glFenceSync( GL_SYNC_GPU_COMMANDS_COMPLETE, 0 );
+}
+
+
+void*
+StreamBuffer::map( size_t uiSize, size_t uiAlignment, StreamAllocation* pcAllocation )
+{
+  if( !m_uiBuffer || m_bMapped || !uiSize ) return NULL;
+  if( uiAlignment == 0 ) uiAlignment = 1;
+
+  size_t uiStart = ( m_uiHead + uiAlignment - 1 ) / uiAlignment * uiAlignment;
+  if( m_bPersistent )
+  {
+    // does not fit into this frame's region: grow, the other regions are empty in the new buffer
+    if( uiStart + uiSize > m_uiRegionSize )
+    {
+      if( allocate( std::max( m_uiRegionSize * 2, uiSize + uiAlignment ) ) ) return NULL;
+      m_uiNumGrows++;
+      uiStart = 0;
+    }
+  }
+  else if( uiStart + uiSize > m_uiRegionSize * NUM_REGIONS )
+  {
+    // end of the buffer: orphan the storage (the driver hands out fresh memory while the
+    // GPU still reads the old one), grow if a single range does not fit
+    if( uiSize > m_uiRegionSize * NUM_REGIONS )
+    {
+      if( allocate( ( uiSize + NUM_REGIONS - 1 ) / NUM_REGIONS * 2 ) ) return NULL;
+      m_uiNumGrows++;
+    }
+    else
+    {
+      glBindBuffer( m_eTarget, m_uiBuffer );
+      glBufferData( m_eTarget, (GLsizeiptr)( m_uiRegionSize * NUM_REGIONS ), NULL, GL_STREAM_DRAW );
+      glBindBuffer( m_eTarget, 0 );
+      m_uiGeneration++;
+      m_uiNumOrphans++;
+    }
+    uiStart = 0;
+  }
+
+  const size_t uiRegionBase = m_bPersistent ? ( m_uiFrame % NUM_REGIONS ) * m_uiRegionSize : 0;
+  m_uiHead = uiStart + uiSize;
+  m_uiBytesMapped += uiSize;
+
+  if( pcAllocation )
+  {
+    pcAllocation->iOffset      = (GLintptr)( uiRegionBase + uiStart );
+    pcAllocation->uiSize       = uiSize;
+    pcAllocation->uiFrame      = m_uiFrame;
+    pcAllocation->uiGeneration = m_uiGeneration;
+  }
+
+  if( m_bPersistent ) return m_pucPersistent + uiRegionBase + uiStart;
+
+  // nothing the GPU may still read lies in this range, no synchronization needed
+  glBindBuffer( m_eTarget, m_uiBuffer );
+  void* pvData = glMapBufferRange( m_eTarget, (GLintptr)uiStart, (GLsizeiptr)uiSize,
+                                   GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT );
+  glBindBuffer( m_eTarget, 0 );
+  m_bMapped = pvData != NULL;
+  return pvData;
+}
+
+
+void
+StreamBuffer::unmap()
+{
+  if( !m_bMapped ) return;
+
+  glBindBuffer( m_eTarget, m_uiBuffer );
+  glUnmapBuffer( m_eTarget );
+  glBindBuffer( m_eTarget, 0 );
+  m_bMapped = false;
+}
+
+
+bool
+StreamBuffer::isValid( const StreamAllocation& rcAllocation ) const
+{
+  if( rcAllocation.uiGeneration != m_uiGeneration ) return false;
+  // persistent: only the fence of the frame that wrote a region protects it, draws of later
+  // frames reading the same range are not waited for before the region is rewritten
+  return !m_bPersistent || rcAllocation.uiFrame == m_uiFrame;
+}
@@ -0,0 +1,371 @@
+#include "GLRender/TextureContainer.h"
+#include "GLRender/GLExtensions.h"
+#include "GLRender/TextureEncoder.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+
+static const char s_acMagic[8] = { 'M', 'A', 'D', 'N', 'T', 'E', 'X', '1' };
+
+static const size_t s_uiHeaderSize = 8 + 4 * sizeof( uint32_t );
+static const size_t s_uiImageSize  = 2 * sizeof( uint32_t );
+static const size_t s_uiLevelSize  = 2 * sizeof( uint64_t );
+
+// the container is little endian like every platform the game runs on, fields are copied
+// out because the table entries are not necessarily aligned
+static uint32_t readU32( const unsigned char* pucData )
+{
+  uint32_t uiValue;
+  memcpy( &uiValue, pucData, sizeof( uiValue ) );
+  return uiValue;
+}
+
+static uint64_t readU64( const unsigned char* pucData )
+{
+  uint64_t uiValue;
+  memcpy( &uiValue, pucData, sizeof( uiValue ) );
+  return uiValue;
+}
+
+static unsigned int levelExtent( unsigned int uiSize, unsigned int uiLevel )
+{
+  return std::max( uiSize >> uiLevel, 1u );
+}
+
+
+
+// constructor
+TextureContainer::TextureContainer()
+  : m_pucData( NULL )
+  , m_uiSize( 0 )
+  , m_pvMapping( NULL )
+  , m_uiWidth( 0 )
+  , m_uiHeight( 0 )
+  , m_uiNumLevels( 0 )
+  , m_uiNumImages( 0 )
+{
+}
+
+
+// destructor
+TextureContainer::~TextureContainer()
+{
+  close();
+}
+
+
+int
+TextureContainer::open( const std::string& rcPath )
+{
+  close();
+
+#ifdef _WIN32
+  HANDLE pvFile = CreateFileA( rcPath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL );
+  if( pvFile == INVALID_HANDLE_VALUE ) return -1;
+  LARGE_INTEGER cSize;
+  if( GetFileSizeEx( pvFile, &cSize ) && cSize.QuadPart > 0 )
+  {
+    m_pvMapping = CreateFileMappingA( pvFile, NULL, PAGE_READONLY, 0, 0, NULL );
+    if( m_pvMapping )
+    {
+      m_pucData = (const unsigned char*)MapViewOfFile( m_pvMapping, FILE_MAP_READ, 0, 0, 0 );
+      m_uiSize  = (size_t)cSize.QuadPart;
+    }
+  }
+  CloseHandle( pvFile );
+#else
+  int iFile = ::open( rcPath.c_str(), O_RDONLY );
+  if( iFile < 0 ) return -1;
+  struct stat cStat;
+  if( fstat( iFile, &cStat ) == 0 && cStat.st_size > 0 )
+  {
+    void* pvData = mmap( NULL, (size_t)cStat.st_size, PROT_READ, MAP_PRIVATE, iFile, 0 );
+    if( pvData != MAP_FAILED )
+    {
+      m_pucData = (const unsigned char*)pvData;
+      m_uiSize  = (size_t)cStat.st_size;
+    }
+  }
+  ::close( iFile );
+#endif
+
+  if( !m_pucData )
+  {
+    std::cerr << "TextureContainer: cannot map " << rcPath << std::endl;
+    close();
+    return -1;
+  }
+
+  // header and tables
+  bool bValid = m_uiSize >= s_uiHeaderSize && memcmp( m_pucData, s_acMagic, sizeof( s_acMagic ) ) == 0;
+  if( bValid )
+  {
+    m_uiWidth     = readU32( m_pucData + 8 );
+    m_uiHeight    = readU32( m_pucData + 12 );
+    m_uiNumLevels = readU32( m_pucData + 16 );
+    m_uiNumImages = readU32( m_pucData + 20 );
+    bValid = m_uiWidth && m_uiHeight && m_uiNumLevels && m_uiNumLevels <= 32 && m_uiNumImages && m_uiNumImages <= 16 &&
+             m_uiSize >= s_uiHeaderSize + m_uiNumImages * ( s_uiImageSize + m_uiNumLevels * s_uiLevelSize );
+  }
+
+  // every level lies inside the file and has the size its format needs
+  for( unsigned int uiImage = 0; bValid && uiImage < m_uiNumImages; uiImage++ )
+  {
+    for( unsigned int uiLevel = 0; bValid && uiLevel < m_uiNumLevels; uiLevel++ )
+    {
+      const unsigned char* pucEntry = m_pucData + s_uiHeaderSize + m_uiNumImages * s_uiImageSize +
+                                      ( uiImage * m_uiNumLevels + uiLevel ) * s_uiLevelSize;
+      const uint64_t uiOffset = readU64( pucEntry );
+      const uint64_t uiSize   = readU64( pucEntry + 8 );
+      const size_t   uiNeeded = getLevelSize( getFormat( uiImage ), levelExtent( m_uiWidth, uiLevel ),
+                                              levelExtent( m_uiHeight, uiLevel ) );
+      bValid = uiNeeded && uiSize == uiNeeded && uiOffset <= m_uiSize && uiSize <= m_uiSize - uiOffset;
+    }
+  }
+
+  if( !bValid )
+  {
+    std::cerr << "TextureContainer: " << rcPath << " is not a valid texture container" << std::endl;
+    close();
+    return -1;
+  }
+  return 0;
+}
+
+
+void
+TextureContainer::close()
+{
+  if( m_pucData )
+  {
+#ifdef _WIN32
+    UnmapViewOfFile( m_pucData );
+#else
+    munmap( (void*)m_pucData, m_uiSize );
+#endif
+  }
+#ifdef _WIN32
+  if( m_pvMapping ) CloseHandle( m_pvMapping );
+#endif
+  m_pucData     = NULL;
+  m_uiSize      = 0;
+  m_pvMapping   = NULL;
+  m_uiWidth     = 0;
+  m_uiHeight    = 0;
+  m_uiNumLevels = 0;
+  m_uiNumImages = 0;
+}
+
+
+void
+TextureContainer::prefetch() const
+{
+  // one read per page faults the file in; the sum keeps the reads from being optimized out
+  volatile unsigned char ucSum = 0;
+  for( size_t uiPos = 0; uiPos < m_uiSize; uiPos += 4096 )
+  {
+    ucSum = ucSum + m_pucData[uiPos];
+  }
+  (void)ucSum;
+}
+
+
+TextureContainer::Format
+TextureContainer::getFormat( unsigned int uiImage ) const
+{
+  return (Format)readU32( m_pucData + s_uiHeaderSize + uiImage * s_uiImageSize );
+}
+
+
+const unsigned char*
+TextureContainer::getLevelData( unsigned int uiImage, unsigned int uiLevel, size_t* puiSize ) const
+{
+  if( uiImage >= m_uiNumImages || uiLevel >= m_uiNumLevels ) return NULL;
+
+  const unsigned char* pucEntry = m_pucData + s_uiHeaderSize + m_uiNumImages * s_uiImageSize +
+                                  ( uiImage * m_uiNumLevels + uiLevel ) * s_uiLevelSize;
+  if( puiSize ) *puiSize = (size_t)readU64( pucEntry + 8 );
+  return m_pucData + readU64( pucEntry );
+}
+
+
+int
+TextureContainer::selectImage() const
+{
+  for( unsigned int uiImage = 0; uiImage < m_uiNumImages; uiImage++ )
+  {
+    switch( getFormat( uiImage ) )
+    {
+    case FORMAT_BC1:
+      if( GLEXT_texture_compression_s3tc ) return (int)uiImage;
+      break;
+    case FORMAT_RGBA8:
+    case FORMAT_R8:
+    case FORMAT_BC4:
+      return (int)uiImage;
+    }
+  }
+  return -1;
+}
+
+
+GLuint
+TextureContainer::upload( Format* peFormat ) const
+{
+  const int iImage = isOpen() ? selectImage() : -1;
+  if( iImage < 0 )
+  {
+    std::cerr << "TextureContainer: no image in a format the context supports" << std::endl;
+    return 0;
+  }
+  const Format eFormat = getFormat( (unsigned int)iImage );
+
+  GLuint uiTexture = 0;
+  glGenTextures( 1, &uiTexture );
+  glBindTexture( GL_TEXTURE_2D, uiTexture );
+
+  GLint iAlignment = 4;
+  glGetIntegerv( GL_UNPACK_ALIGNMENT, &iAlignment );
+  glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
+
+  for( unsigned int uiLevel = 0; uiLevel < m_uiNumLevels; uiLevel++ )
+  {
+    size_t uiSize = 0;
+    const unsigned char* pucData = getLevelData( (unsigned int)iImage, uiLevel, &uiSize );
+    const GLsizei iWidth  = (GLsizei)levelExtent( m_uiWidth, uiLevel );
+    const GLsizei iHeight = (GLsizei)levelExtent( m_uiHeight, uiLevel );
+    switch( eFormat )
+    {
+    case FORMAT_RGBA8:
+      glTexImage2D( GL_TEXTURE_2D, uiLevel, GL_RGBA8, iWidth, iHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, pucData );
+      break;
+    case FORMAT_R8:
+      glTexImage2D( GL_TEXTURE_2D, uiLevel, GL_R8, iWidth, iHeight, 0, GL_RED, GL_UNSIGNED_BYTE, pucData );
+      break;
+    case FORMAT_BC1:
+      glCompressedTexImage2D( GL_TEXTURE_2D, uiLevel, GL_COMPRESSED_RGB_S3TC_DXT1_EXT, iWidth, iHeight, 0, (GLsizei)uiSize, pucData );
+      break;
+    case FORMAT_BC4:
+      glCompressedTexImage2D( GL_TEXTURE_2D, uiLevel, GL_COMPRESSED_RED_RGTC1, iWidth, iHeight, 0, (GLsizei)uiSize, pucData );
+      break;
+    }
+  }
+  glPixelStorei( GL_UNPACK_ALIGNMENT, iAlignment );
+
+  // single channel images are grey scale
+  if( eFormat == FORMAT_R8 || eFormat == FORMAT_BC4 )
+  {
+    const GLint aiSwizzle[4] = { GL_RED, GL_RED, GL_RED, GL_ONE };
+    glTexParameteriv( GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, aiSwizzle );
+  }
+  glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (GLint)m_uiNumLevels - 1 );
+  glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, m_uiNumLevels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR );
+  glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+
+  if( glGetError() != GL_NO_ERROR )
+  {
+    std::cerr << "TextureContainer: upload of " << getFormatName( eFormat ) << " levels failed" << std::endl;
+    glDeleteTextures( 1, &uiTexture );
+    return 0;
+  }
+  if( peFormat ) *peFormat = eFormat;
+  return uiTexture;
+}
+
+
+int
+TextureContainer::write( const std::string& rcPath, unsigned int uiWidth, unsigned int uiHeight,
+                         const std::vector<TextureContainerImage>& rcImages )
+{
+  if( rcImages.empty() || rcImages[0].cLevels.empty() ) return -1;
+  const uint32_t uiNumLevels = (uint32_t)rcImages[0].cLevels.size();
+  const uint32_t uiNumImages = (uint32_t)rcImages.size();
+
+  // tables, then the data of all levels at aligned offsets
+  std::vector<unsigned char> cHeader( s_uiHeaderSize + uiNumImages * ( s_uiImageSize + uiNumLevels * s_uiLevelSize ), 0 );
+  memcpy( &cHeader[0], s_acMagic, sizeof( s_acMagic ) );
+  const uint32_t auiHeader[4] = { uiWidth, uiHeight, uiNumLevels, uiNumImages };
+  memcpy( &cHeader[8], auiHeader, sizeof( auiHeader ) );
+
+  uint64_t uiOffset = cHeader.size();
+  for( uint32_t uiImage = 0; uiImage < uiNumImages; uiImage++ )
+  {
+    const TextureContainerImage& rcImage = rcImages[uiImage];
+    if( rcImage.cLevels.size() != uiNumLevels ) return -1;
+
+    const uint32_t auiImage[2] = { rcImage.uiFormat, 0 };
+    memcpy( &cHeader[s_uiHeaderSize + uiImage * s_uiImageSize], auiImage, sizeof( auiImage ) );
+    for( uint32_t uiLevel = 0; uiLevel < uiNumLevels; uiLevel++ )
+    {
+      uiOffset = ( uiOffset + DATA_ALIGNMENT - 1 ) / DATA_ALIGNMENT * DATA_ALIGNMENT;
+      const uint64_t auiLevel[2] = { uiOffset, rcImage.cLevels[uiLevel].size() };
+      memcpy( &cHeader[s_uiHeaderSize + uiNumImages * s_uiImageSize + ( uiImage * uiNumLevels + uiLevel ) * s_uiLevelSize],
+              auiLevel, sizeof( auiLevel ) );
+      uiOffset += auiLevel[1];
+    }
+  }
+
+  std::ofstream cFile( rcPath, std::ios::binary | std::ios::trunc );
+  if( !cFile )
+  {
+    std::cerr << "TextureContainer: cannot write " << rcPath << std::endl;
+    return -1;
+  }
+  cFile.write( (const char*)&cHeader[0], (std::streamsize)cHeader.size() );
+  uint64_t uiPos = cHeader.size();
+  static const char s_acPadding[DATA_ALIGNMENT] = { 0 };
+  for( const TextureContainerImage& rcImage : rcImages )
+  {
+    for( const std::vector<unsigned char>& rcLevel : rcImage.cLevels )
+    {
+      const uint64_t uiPadding = ( DATA_ALIGNMENT - uiPos % DATA_ALIGNMENT ) % DATA_ALIGNMENT;
+      cFile.write( s_acPadding, (std::streamsize)uiPadding );
+      if( !rcLevel.empty() ) cFile.write( (const char*)&rcLevel[0], (std::streamsize)rcLevel.size() );
+      uiPos += uiPadding + rcLevel.size();
+    }
+  }
+  return cFile ? 0 : -1;
+}
+
+
+size_t
+TextureContainer::getLevelSize( Format eFormat, unsigned int uiWidth, unsigned int uiHeight )
+{
+  switch( eFormat )
+  {
+  case FORMAT_RGBA8: return (size_t)uiWidth * uiHeight * 4;
+  case FORMAT_R8:    return (size_t)uiWidth * uiHeight;
+  case FORMAT_BC1:   return TextureEncoder::getBlockDataSize( uiWidth, uiHeight, TextureEncoder::BC1_BLOCK_SIZE );
+  case FORMAT_BC4:   return TextureEncoder::getBlockDataSize( uiWidth, uiHeight, TextureEncoder::BC4_BLOCK_SIZE );
+  }
+  return 0;
+}
+
+
+const char*
+TextureContainer::getFormatName( Format eFormat )
+{
+  switch( eFormat )
+  {
+  case FORMAT_RGBA8: return "RGBA8";
+  case FORMAT_R8:    return "R8";
+  case FORMAT_BC1:   return "BC1";
+  case FORMAT_BC4:   return "BC4";
+  }
+  return "unknown";
+}
@@ -0,0 +1,299 @@
+#include "GLRender/TextureEncoder.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+
+// 5:6:5 packing with rounding and the expansion back to 8 bit a decoder does
+static unsigned short packRGB565( const float* pfColor )
+{
+  int iR = (int)std::lround( std::min( std::max( pfColor[0], 0.0f ), 255.0f ) * 31.0f / 255.0f );
+  int iG = (int)std::lround( std::min( std::max( pfColor[1], 0.0f ), 255.0f ) * 63.0f / 255.0f );
+  int iB = (int)std::lround( std::min( std::max( pfColor[2], 0.0f ), 255.0f ) * 31.0f / 255.0f );
+  return (unsigned short)( ( iR << 11 ) | ( iG << 5 ) | iB );
+}
+
+static void unpackRGB565( unsigned short usColor, int* piColor )
+{
+  const int iR = ( usColor >> 11 ) & 31;
+  const int iG = ( usColor >> 5 ) & 63;
+  const int iB = usColor & 31;
+  piColor[0] = ( iR << 3 ) | ( iR >> 2 );
+  piColor[1] = ( iG << 2 ) | ( iG >> 4 );
+  piColor[2] = ( iB << 3 ) | ( iB >> 2 );
+}
+
+
+// pixel (x, y) of a block at (uiBlockX, uiBlockY), clamped to the image so that partial
+// blocks at the border repeat the edge pixels
+static const unsigned char* blockPixel( const std::vector<unsigned char>& rcImage, unsigned int uiWidth, unsigned int uiHeight,
+                                        unsigned int uiChannels, unsigned int uiBlockX, unsigned int uiBlockY,
+                                        unsigned int x, unsigned int y )
+{
+  const unsigned int uiX = std::min( uiBlockX * 4 + x, uiWidth - 1 );
+  const unsigned int uiY = std::min( uiBlockY * 4 + y, uiHeight - 1 );
+  return &rcImage[( (size_t)uiY * uiWidth + uiX ) * uiChannels];
+}
+
+
+// nearest palette entry for every pixel, returns the squared error
+static int selectIndices( const float afPixels[16][3], const int aaiPalette[4][3], unsigned char* pucIndices )
+{
+  int iError = 0;
+  for( int i = 0; i < 16; i++ )
+  {
+    int iBest = 0, iBestDist = 0x7fffffff;
+    for( int j = 0; j < 4; j++ )
+    {
+      int iDist = 0;
+      for( int c = 0; c < 3; c++ )
+      {
+        const int iDiff = (int)afPixels[i][c] - aaiPalette[j][c];
+        iDist += iDiff * iDiff;
+      }
+      if( iDist < iBestDist )
+      {
+        iBestDist = iDist;
+        iBest     = j;
+      }
+    }
+    pucIndices[i] = (unsigned char)iBest;
+    iError += iBestDist;
+  }
+  return iError;
+}
+
+
+static void buildPalette( unsigned short usColor0, unsigned short usColor1, int aaiPalette[4][3] )
+{
+  unpackRGB565( usColor0, aaiPalette[0] );
+  unpackRGB565( usColor1, aaiPalette[1] );
+  for( int c = 0; c < 3; c++ )
+  {
+    aaiPalette[2][c] = ( 2 * aaiPalette[0][c] + aaiPalette[1][c] ) / 3;
+    aaiPalette[3][c] = ( aaiPalette[0][c] + 2 * aaiPalette[1][c] ) / 3;
+  }
+}
+
+
+// endpoints of one block: range along the principal axis, refined by least squares for the
+// chosen indices; returns the squared error
+static int encodeBC1Block( const float afPixels[16][3], unsigned char* pucBlock )
+{
+  float afMean[3] = { 0.0f, 0.0f, 0.0f };
+  for( int i = 0; i < 16; i++ )
+    for( int c = 0; c < 3; c++ ) afMean[c] += afPixels[i][c] / 16.0f;
+
+  float afCov[6] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+  for( int i = 0; i < 16; i++ )
+  {
+    const float fR = afPixels[i][0] - afMean[0];
+    const float fG = afPixels[i][1] - afMean[1];
+    const float fB = afPixels[i][2] - afMean[2];
+    afCov[0] += fR * fR; afCov[1] += fR * fG; afCov[2] += fR * fB;
+    afCov[3] += fG * fG; afCov[4] += fG * fB; afCov[5] += fB * fB;
+  }
+
+  // power iteration for the dominant eigenvector
+  float afAxis[3] = { 0.577f, 0.577f, 0.577f };
+  for( int iIter = 0; iIter < 8; iIter++ )
+  {
+    const float fX = afCov[0] * afAxis[0] + afCov[1] * afAxis[1] + afCov[2] * afAxis[2];
+    const float fY = afCov[1] * afAxis[0] + afCov[3] * afAxis[1] + afCov[4] * afAxis[2];
+    const float fZ = afCov[2] * afAxis[0] + afCov[4] * afAxis[1] + afCov[5] * afAxis[2];
+    const float fLen = std::sqrt( fX * fX + fY * fY + fZ * fZ );
+    if( fLen < 1.0e-6f ) break;
+    afAxis[0] = fX / fLen; afAxis[1] = fY / fLen; afAxis[2] = fZ / fLen;
+  }
+
+  float fMin = 1.0e9f, fMax = -1.0e9f;
+  for( int i = 0; i < 16; i++ )
+  {
+    float fT = 0.0f;
+    for( int c = 0; c < 3; c++ ) fT += ( afPixels[i][c] - afMean[c] ) * afAxis[c];
+    fMin = std::min( fMin, fT );
+    fMax = std::max( fMax, fT );
+  }
+  float afEnd0[3], afEnd1[3];
+  for( int c = 0; c < 3; c++ )
+  {
+    afEnd0[c] = afMean[c] + afAxis[c] * fMax;
+    afEnd1[c] = afMean[c] + afAxis[c] * fMin;
+  }
+
+  unsigned short usColor0 = packRGB565( afEnd0 );
+  unsigned short usColor1 = packRGB565( afEnd1 );
+  int aaiPalette[4][3];
+  unsigned char aucIndices[16];
+  buildPalette( usColor0, usColor1, aaiPalette );
+  int iError = selectIndices( afPixels, aaiPalette, aucIndices );
+
+  // least squares fit of both endpoints to the pixels with the chosen interpolation
+  // weights, repeated while the error drops
+  static const float s_afWeight[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+  for( int iIter = 0; iIter < 4; iIter++ )
+  {
+    float fAA = 0.0f, fAB = 0.0f, fBB = 0.0f;
+    float afAX[3] = { 0.0f, 0.0f, 0.0f }, afBX[3] = { 0.0f, 0.0f, 0.0f };
+    for( int i = 0; i < 16; i++ )
+    {
+      const float fB = s_afWeight[aucIndices[i]];
+      const float fA = 1.0f - fB;
+      fAA += fA * fA; fAB += fA * fB; fBB += fB * fB;
+      for( int c = 0; c < 3; c++ )
+      {
+        afAX[c] += fA * afPixels[i][c];
+        afBX[c] += fB * afPixels[i][c];
+      }
+    }
+    const float fDet = fAA * fBB - fAB * fAB;
+    if( std::fabs( fDet ) < 1.0e-6f ) break;
+
+    for( int c = 0; c < 3; c++ )
+    {
+      afEnd0[c] = ( afAX[c] * fBB - afBX[c] * fAB ) / fDet;
+      afEnd1[c] = ( afBX[c] * fAA - afAX[c] * fAB ) / fDet;
+    }
+    const unsigned short usRefined0 = packRGB565( afEnd0 );
+    const unsigned short usRefined1 = packRGB565( afEnd1 );
+    int aaiRefined[4][3];
+    unsigned char aucRefined[16];
+    buildPalette( usRefined0, usRefined1, aaiRefined );
+    const int iRefinedError = selectIndices( afPixels, aaiRefined, aucRefined );
+    if( iRefinedError >= iError ) break;
+
+    iError   = iRefinedError;
+    usColor0 = usRefined0;
+    usColor1 = usRefined1;
+    std::copy( aucRefined, aucRefined + 16, aucIndices );
+  }
+
+  // four color mode needs color0 > color1, swapping the endpoints swaps 0/1 and 2/3
+  if( usColor0 < usColor1 )
+  {
+    std::swap( usColor0, usColor1 );
+    for( int i = 0; i < 16; i++ ) aucIndices[i] ^= 1;
+  }
+  else if( usColor0 == usColor1 )
+  {
+    std::fill( aucIndices, aucIndices + 16, 0 );
+  }
+
+  pucBlock[0] = (unsigned char)( usColor0 & 0xff );
+  pucBlock[1] = (unsigned char)( usColor0 >> 8 );
+  pucBlock[2] = (unsigned char)( usColor1 & 0xff );
+  pucBlock[3] = (unsigned char)( usColor1 >> 8 );
+  for( int y = 0; y < 4; y++ )
+  {
+    pucBlock[4 + y] = (unsigned char)( aucIndices[y * 4] | ( aucIndices[y * 4 + 1] << 2 ) |
+                                       ( aucIndices[y * 4 + 2] << 4 ) | ( aucIndices[y * 4 + 3] << 6 ) );
+  }
+  return iError;
+}
+
+
+
+void
+TextureEncoder::downsample( const std::vector<unsigned char>& rcSrc, unsigned int uiWidth, unsigned int uiHeight,
+                            unsigned int uiChannels, std::vector<unsigned char>& rcDst )
+{
+  const unsigned int uiDstWidth  = std::max( uiWidth / 2, 1u );
+  const unsigned int uiDstHeight = std::max( uiHeight / 2, 1u );
+  rcDst.resize( (size_t)uiDstWidth * uiDstHeight * uiChannels );
+
+  for( unsigned int y = 0; y < uiDstHeight; y++ )
+  {
+    const size_t uiRow0 = (size_t)std::min( y * 2, uiHeight - 1 ) * uiWidth;
+    const size_t uiRow1 = (size_t)std::min( y * 2 + 1, uiHeight - 1 ) * uiWidth;
+    for( unsigned int x = 0; x < uiDstWidth; x++ )
+    {
+      const size_t uiCol0 = std::min( x * 2, uiWidth - 1 );
+      const size_t uiCol1 = std::min( x * 2 + 1, uiWidth - 1 );
+      for( unsigned int c = 0; c < uiChannels; c++ )
+      {
+        const unsigned int uiSum = rcSrc[( uiRow0 + uiCol0 ) * uiChannels + c] + rcSrc[( uiRow0 + uiCol1 ) * uiChannels + c] +
+                                   rcSrc[( uiRow1 + uiCol0 ) * uiChannels + c] + rcSrc[( uiRow1 + uiCol1 ) * uiChannels + c];
+        rcDst[( (size_t)y * uiDstWidth + x ) * uiChannels + c] = (unsigned char)( ( uiSum + 2 ) / 4 );
+      }
+    }
+  }
+}
+
+
+float
+TextureEncoder::encodeBC1( const std::vector<unsigned char>& rcRGBA, unsigned int uiWidth, unsigned int uiHeight,
+                           std::vector<unsigned char>& rcBlocks )
+{
+  const unsigned int uiBlocksX = ( uiWidth + 3 ) / 4;
+  const unsigned int uiBlocksY = ( uiHeight + 3 ) / 4;
+  rcBlocks.resize( getBlockDataSize( uiWidth, uiHeight, BC1_BLOCK_SIZE ) );
+
+  float afPixels[16][3];
+  double dError = 0.0;
+  for( unsigned int uiBlockY = 0; uiBlockY < uiBlocksY; uiBlockY++ )
+  {
+    for( unsigned int uiBlockX = 0; uiBlockX < uiBlocksX; uiBlockX++ )
+    {
+      for( unsigned int i = 0; i < 16; i++ )
+      {
+        const unsigned char* pucPixel = blockPixel( rcRGBA, uiWidth, uiHeight, 4, uiBlockX, uiBlockY, i % 4, i / 4 );
+        for( int c = 0; c < 3; c++ ) afPixels[i][c] = pucPixel[c];
+      }
+      dError += encodeBC1Block( afPixels, &rcBlocks[( (size_t)uiBlockY * uiBlocksX + uiBlockX ) * BC1_BLOCK_SIZE] );
+    }
+  }
+  // padding pixels of partial blocks are counted as well, they repeat the border
+  return (float)std::sqrt( dError / ( (double)uiBlocksX * uiBlocksY * 16 * 3 ) );
+}
+
+
+float
+TextureEncoder::encodeBC4( const std::vector<unsigned char>& rcRed, unsigned int uiWidth, unsigned int uiHeight,
+                           std::vector<unsigned char>& rcBlocks )
+{
+  const unsigned int uiBlocksX = ( uiWidth + 3 ) / 4;
+  const unsigned int uiBlocksY = ( uiHeight + 3 ) / 4;
+  rcBlocks.resize( getBlockDataSize( uiWidth, uiHeight, BC4_BLOCK_SIZE ) );
+
+  unsigned char aucValues[16];
+  double dError = 0.0;
+  for( unsigned int uiBlockY = 0; uiBlockY < uiBlocksY; uiBlockY++ )
+  {
+    for( unsigned int uiBlockX = 0; uiBlockX < uiBlocksX; uiBlockX++ )
+    {
+      unsigned char ucMin = 255, ucMax = 0;
+      for( unsigned int i = 0; i < 16; i++ )
+      {
+        aucValues[i] = *blockPixel( rcRed, uiWidth, uiHeight, 1, uiBlockX, uiBlockY, i % 4, i / 4 );
+        ucMin = std::min( ucMin, aucValues[i] );
+        ucMax = std::max( ucMax, aucValues[i] );
+      }
+
+      // eight value mode (red0 > red1): 0 = max, 1 = min, 2..7 interpolate from max to min
+      int aiPalette[8] = { ucMax, ucMin };
+      for( int i = 2; i < 8; i++ ) aiPalette[i] = ( ( 8 - i ) * ucMax + ( i - 1 ) * ucMin ) / 7;
+
+      unsigned long long ullBits = 0;
+      if( ucMax > ucMin )
+      {
+        for( int i = 0; i < 16; i++ )
+        {
+          int iBest = 0;
+          for( int j = 1; j < 8; j++ )
+          {
+            if( std::abs( aucValues[i] - aiPalette[j] ) < std::abs( aucValues[i] - aiPalette[iBest] ) ) iBest = j;
+          }
+          ullBits |= (unsigned long long)iBest << ( 3 * i );
+          dError += ( aucValues[i] - aiPalette[iBest] ) * ( aucValues[i] - aiPalette[iBest] );
+        }
+      }
+
+      unsigned char* pucBlock = &rcBlocks[( (size_t)uiBlockY * uiBlocksX + uiBlockX ) * BC4_BLOCK_SIZE];
+      pucBlock[0] = ucMax;
+      pucBlock[1] = ucMin;
+      for( int i = 0; i < 6; i++ ) pucBlock[2 + i] = (unsigned char)( ullBits >> ( 8 * i ) );
+    }
+  }
+  return (float)std::sqrt( dError / ( (double)uiBlocksX * uiBlocksY * 16 ) );
+}
@@ -0,0 +1,253 @@
+#include "GLRender/TextureLoader.h"
+#include "GLRender/PixelConvert.h"
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb/stb_image.h"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+
+
+
+GLuint
+TextureImage::upload() const
+{
+  if( pcContainer )
+  {
+    return pcContainer->upload();
+  }
+  if( cPixels.empty() || uiChannels < 1 || uiChannels > 4 )
+  {
+    return 0;
+  }
+
+  static const GLenum s_aeFormats[4]  = { GL_RED, GL_RG, GL_RGB, GL_RGBA };
+  static const GLint  s_aiInternal[4] = { GL_R8, GL_RG8, GL_RGB8, GL_RGBA8 };
+
+  GLuint uiTexture = 0;
+  glGenTextures( 1, &uiTexture );
+  glBindTexture( GL_TEXTURE_2D, uiTexture );
+
+  // rows are tightly packed, RGB rows are not necessarily a multiple of 4 bytes
+  GLint iAlignment = 4;
+  glGetIntegerv( GL_UNPACK_ALIGNMENT, &iAlignment );
+  glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
+  glTexImage2D( GL_TEXTURE_2D, 0, s_aiInternal[uiChannels - 1], (GLsizei)uiWidth, (GLsizei)uiHeight, 0,
+                s_aeFormats[uiChannels - 1], GL_UNSIGNED_BYTE, &cPixels[0] );
+  glPixelStorei( GL_UNPACK_ALIGNMENT, iAlignment );
+  glGenerateMipmap( GL_TEXTURE_2D );
+
+  // single channel images are grey scale
+  if( uiChannels == 1 )
+  {
+    const GLint aiSwizzle[4] = { GL_RED, GL_RED, GL_RED, GL_ONE };
+    glTexParameteriv( GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, aiSwizzle );
+  }
+  glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR );
+  glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+
+  if( glGetError() != GL_NO_ERROR )
+  {
+    std::cerr << "TextureLoader: upload of " << cPath << " failed" << std::endl;
+    glDeleteTextures( 1, &uiTexture );
+    return 0;
+  }
+  return uiTexture;
+}
+
+
+
+// constructor
+TextureLoader::TextureLoader()
+  : m_uiNumThreads( 0 )
+  , m_bStop( false )
+{
+}
+
+
+// destructor
+TextureLoader::~TextureLoader()
+{
+  shutdown();
+}
+
+
+TextureLoader&
+TextureLoader::get()
+{
+  static TextureLoader s_cLoader;
+  return s_cLoader;
+}
+
+
+void
+TextureLoader::setNumThreads( unsigned int uiNumThreads )
+{
+  std::lock_guard<std::mutex> cLock( m_cMutex );
+  m_uiNumThreads = uiNumThreads;
+}
+
+
+std::future<TextureImage>
+TextureLoader::load( const std::string& rcPath, unsigned int uiChannels, unsigned int uiFlags )
+{
+  std::packaged_task<TextureImage()> cTask( [rcPath, uiChannels, uiFlags]() { return read( rcPath, uiChannels, uiFlags ); } );
+  std::future<TextureImage> cFuture = cTask.get_future();
+
+  std::lock_guard<std::mutex> cLock( m_cMutex );
+  if( m_bStop )
+  {
+    // after shutdown the load runs synchronously
+    cTask();
+    return cFuture;
+  }
+
+  // workers are started with the first load; one core stays free for the GL thread
+  if( m_cThreads.empty() )
+  {
+    unsigned int uiNumThreads = m_uiNumThreads;
+    if( !uiNumThreads )
+    {
+      const unsigned int uiCores = std::thread::hardware_concurrency();
+      uiNumThreads = std::min( std::max( uiCores, 2u ) - 1, 4u );
+    }
+    for( unsigned int ui = 0; ui < uiNumThreads; ui++ )
+    {
+      m_cThreads.emplace_back( &TextureLoader::workerLoop, this );
+    }
+  }
+
+  m_cTasks.push_back( std::move( cTask ) );
+  m_cWakeUp.notify_one();
+  return cFuture;
+}
+
+
+void
+TextureLoader::shutdown()
+{
+  {
+    std::lock_guard<std::mutex> cLock( m_cMutex );
+    m_bStop = true;
+    m_cTasks.clear();
+  }
+  m_cWakeUp.notify_all();
+  for( std::thread& rcThread : m_cThreads )
+  {
+    rcThread.join();
+  }
+  m_cThreads.clear();
+}
+
+
+void
+TextureLoader::workerLoop()
+{
+  for( ;; )
+  {
+    std::packaged_task<TextureImage()> cTask;
+    {
+      std::unique_lock<std::mutex> cLock( m_cMutex );
+      m_cWakeUp.wait( cLock, [this]() { return m_bStop || !m_cTasks.empty(); } );
+      if( m_bStop ) return;
+      cTask = std::move( m_cTasks.front() );
+      m_cTasks.pop_front();
+    }
+    cTask();
+  }
+}
+
+
+TextureImage
+TextureLoader::read( const std::string& rcPath, unsigned int uiChannels, unsigned int uiFlags )
+{
+  TextureImage cImage;
+  cImage.cPath = rcPath;
+
+  // baked container: only mapped, faulting the pages in here keeps the disk reads off the GL thread
+  if( !( uiFlags & IGNORE_BAKED ) )
+  {
+    const std::string cBaked = std::filesystem::path( rcPath ).replace_extension( ".btex" ).string();
+    std::error_code cError;
+    if( std::filesystem::exists( cBaked, cError ) )
+    {
+      std::shared_ptr<TextureContainer> pcContainer = std::make_shared<TextureContainer>();
+      if( pcContainer->open( cBaked ) == 0 )
+      {
+        pcContainer->prefetch();
+        cImage.cPath       = cBaked;
+        cImage.pcContainer = pcContainer;
+        cImage.uiWidth     = pcContainer->getWidth();
+        cImage.uiHeight    = pcContainer->getHeight();
+        return cImage;
+      }
+    }
+  }
+
+  // stb_image only decodes; RGB to RGBA, the flip and premultiplication run in the SIMD
+  // kernels of PixelConvert. Other channel conversions are left to stb_image.
+  int iWidth = 0, iHeight = 0, iChannels = 0;
+  int iRequested = (int)uiChannels;
+  if( stbi_info( rcPath.c_str(), &iWidth, &iHeight, &iChannels ) &&
+      ( uiChannels == 0 || (int)uiChannels == iChannels || ( uiChannels == 4 && iChannels == 3 ) ) )
+  {
+    iRequested = 0;
+  }
+  stbi_set_flip_vertically_on_load_thread( 0 );
+  unsigned char* pucData = stbi_load( rcPath.c_str(), &iWidth, &iHeight, &iChannels, iRequested );
+  if( !pucData )
+  {
+    std::cerr << "TextureLoader: cannot load " << rcPath << ": " << stbi_failure_reason() << std::endl;
+    return cImage;
+  }
+
+  const size_t uiNumPixels = (size_t)iWidth * iHeight;
+  const unsigned int uiDecoded = iRequested ? (unsigned int)iRequested : (unsigned int)iChannels;
+  cImage.uiWidth    = (unsigned int)iWidth;
+  cImage.uiHeight   = (unsigned int)iHeight;
+  cImage.uiChannels = uiChannels ? uiChannels : uiDecoded;
+  cImage.cPixels.resize( uiNumPixels * cImage.uiChannels );
+  if( uiDecoded == 3 && cImage.uiChannels == 4 )
+  {
+    PixelConvert::expandRGBToRGBA( pucData, &cImage.cPixels[0], uiNumPixels );
+  }
+  else
+  {
+    std::copy( pucData, pucData + cImage.cPixels.size(), cImage.cPixels.begin() );
+  }
+  stbi_image_free( pucData );
+
+  if( uiFlags & FLIP_VERTICALLY )
+  {
+    PixelConvert::flipRows( &cImage.cPixels[0], (size_t)iWidth * cImage.uiChannels, (size_t)iHeight );
+  }
+  if( ( uiFlags & PREMULTIPLY_ALPHA ) && cImage.uiChannels == 4 )
+  {
+    PixelConvert::premultiplyAlpha( &cImage.cPixels[0], uiNumPixels );
+  }
+  return cImage;
+}
+
+
+GLuint
+TextureLoader::createPlaceholder( unsigned char ucRed, unsigned char ucGreen, unsigned char ucBlue, unsigned char ucAlpha )
+{
+  const unsigned char aucPixel[4] = { ucRed, ucGreen, ucBlue, ucAlpha };
+
+  GLuint uiTexture = 0;
+  glGenTextures( 1, &uiTexture );
+  glBindTexture( GL_TEXTURE_2D, uiTexture );
+  glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, aucPixel );
+  glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST );
+  glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST );
+  return uiTexture;
+}
+
+
+bool
+TextureLoader::isReady( const std::future<TextureImage>& rcFuture )
+{
+  return rcFuture.valid() && rcFuture.wait_for( std::chrono::seconds( 0 ) ) == std::future_status::ready;
+}
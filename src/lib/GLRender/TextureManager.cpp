@@ -0,0 +1,359 @@
+#include "GLRender/TextureManager.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <set>
+#include <tuple>
+#include <vector>
+
+
+
+bool
+TextureDesc::operator<( const TextureDesc& rcOther ) const
+{
+  return std::tie( cPath, uiChannels, uiFlags, eWrap ) < std::tie( rcOther.cPath, rcOther.uiChannels, rcOther.uiFlags, rcOther.eWrap );
+}
+
+
+
+// constructor
+Texture::Texture( TextureManager* pcManager, const TextureDesc& rcDesc )
+  : m_pcManager( pcManager )
+  , m_cDesc( rcDesc )
+  , m_uiTexture( 0 )
+  , m_uiWidth( 0 )
+  , m_uiHeight( 0 )
+  , m_uiNumLevels( 0 )
+  , m_uiDroppedLevels( 0 )
+  , m_uiBytes( 0 )
+  , m_uiLastUsed( 0 )
+{
+}
+
+
+// destructor
+Texture::~Texture()
+{
+  glDeleteTextures( 1, &m_uiTexture );
+}
+
+
+GLuint
+Texture::use()
+{
+  m_uiLastUsed = m_pcManager->getFrame();
+  return m_uiTexture;
+}
+
+
+bool
+Texture::finishLoad( bool bWait )
+{
+  if( !m_cPending.valid() ) return true;
+  if( !bWait && m_cPending.wait_for( std::chrono::seconds( 0 ) ) != std::future_status::ready ) return true;
+
+  TextureImage cImage;
+  try
+  {
+    cImage = m_cPending.get();
+  }
+  catch( const std::future_error& )
+  {
+    // the loader was shut down before the texture was read
+  }
+  const GLuint uiLoaded = cImage.upload();
+  if( !uiLoaded )
+  {
+    std::cerr << "TextureManager: cannot load " << m_cDesc.cPath << ", keeping the placeholder" << std::endl;
+    return false;
+  }
+
+  glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, (GLint)m_cDesc.eWrap );
+  glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, (GLint)m_cDesc.eWrap );
+  glDeleteTextures( 1, &m_uiTexture );
+  m_uiTexture = uiLoaded;
+  updateInfo();
+  return true;
+}
+
+
+void
+Texture::updateInfo()
+{
+  glBindTexture( GL_TEXTURE_2D, m_uiTexture );
+
+  GLint iMaxLevel = 1000;
+  glGetTexParameteriv( GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, &iMaxLevel );
+
+  // the driver reports the size of every level, the bits per component include its padding
+  m_uiNumLevels = 0;
+  m_uiBytes     = 0;
+  for( GLint iLevel = 0; iLevel <= iMaxLevel; iLevel++ )
+  {
+    GLint iWidth = 0, iHeight = 0, iCompressed = GL_FALSE;
+    glGetTexLevelParameteriv( GL_TEXTURE_2D, iLevel, GL_TEXTURE_WIDTH, &iWidth );
+    glGetTexLevelParameteriv( GL_TEXTURE_2D, iLevel, GL_TEXTURE_HEIGHT, &iHeight );
+    if( iWidth <= 0 || iHeight <= 0 ) break;
+
+    if( iLevel == 0 )
+    {
+      m_uiWidth  = (unsigned int)iWidth;
+      m_uiHeight = (unsigned int)iHeight;
+    }
+    glGetTexLevelParameteriv( GL_TEXTURE_2D, iLevel, GL_TEXTURE_COMPRESSED, &iCompressed );
+    if( iCompressed )
+    {
+      GLint iSize = 0;
+      glGetTexLevelParameteriv( GL_TEXTURE_2D, iLevel, GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &iSize );
+      m_uiBytes += (size_t)iSize;
+    }
+    else
+    {
+      static const GLenum s_aeSizes[4] = { GL_TEXTURE_RED_SIZE, GL_TEXTURE_GREEN_SIZE, GL_TEXTURE_BLUE_SIZE, GL_TEXTURE_ALPHA_SIZE };
+      GLint iBits = 0;
+      for( GLenum eSize : s_aeSizes )
+      {
+        GLint iComponent = 0;
+        glGetTexLevelParameteriv( GL_TEXTURE_2D, iLevel, eSize, &iComponent );
+        iBits += iComponent;
+      }
+      m_uiBytes += (size_t)iWidth * iHeight * ( ( iBits + 7 ) / 8 );
+    }
+    m_uiNumLevels++;
+  }
+}
+
+
+bool
+Texture::dropLevels( unsigned int uiNumLevels )
+{
+  if( !uiNumLevels || uiNumLevels >= m_uiNumLevels ) return false;
+
+  glBindTexture( GL_TEXTURE_2D, m_uiTexture );
+  GLint iInternal = 0, iCompressed = GL_FALSE;
+  glGetTexLevelParameteriv( GL_TEXTURE_2D, 0, GL_TEXTURE_INTERNAL_FORMAT, &iInternal );
+  glGetTexLevelParameteriv( GL_TEXTURE_2D, 0, GL_TEXTURE_COMPRESSED, &iCompressed );
+
+  // format to read uncompressed levels back in (the formats the loader creates)
+  GLenum eFormat = GL_NONE;
+  GLint  iBytesPerPixel = 0;
+  switch( iInternal )
+  {
+  case GL_R8:    eFormat = GL_RED;  iBytesPerPixel = 1; break;
+  case GL_RG8:   eFormat = GL_RG;   iBytesPerPixel = 2; break;
+  case GL_RGB8:  eFormat = GL_RGB;  iBytesPerPixel = 3; break;
+  case GL_RGBA8: eFormat = GL_RGBA; iBytesPerPixel = 4; break;
+  }
+  if( !iCompressed && eFormat == GL_NONE ) return false;
+
+  // read the remaining levels back; this waits for the GPU, but only happens when the
+  // budget is exceeded
+  struct Level
+  {
+    GLint                       iWidth, iHeight;
+    std::vector<unsigned char>  cData;
+  };
+  std::vector<Level> cLevels( m_uiNumLevels - uiNumLevels );
+
+  GLint iPackAlignment = 4;
+  glGetIntegerv( GL_PACK_ALIGNMENT, &iPackAlignment );
+  glPixelStorei( GL_PACK_ALIGNMENT, 1 );
+  for( size_t ui = 0; ui < cLevels.size(); ui++ )
+  {
+    const GLint iLevel = (GLint)( ui + uiNumLevels );
+    Level& rcLevel = cLevels[ui];
+    glGetTexLevelParameteriv( GL_TEXTURE_2D, iLevel, GL_TEXTURE_WIDTH, &rcLevel.iWidth );
+    glGetTexLevelParameteriv( GL_TEXTURE_2D, iLevel, GL_TEXTURE_HEIGHT, &rcLevel.iHeight );
+    if( iCompressed )
+    {
+      GLint iSize = 0;
+      glGetTexLevelParameteriv( GL_TEXTURE_2D, iLevel, GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &iSize );
+      rcLevel.cData.resize( (size_t)iSize );
+      glGetCompressedTexImage( GL_TEXTURE_2D, iLevel, rcLevel.cData.data() );
+    }
+    else
+    {
+      rcLevel.cData.resize( (size_t)rcLevel.iWidth * rcLevel.iHeight * iBytesPerPixel );
+      glGetTexImage( GL_TEXTURE_2D, iLevel, eFormat, GL_UNSIGNED_BYTE, rcLevel.cData.data() );
+    }
+  }
+  glPixelStorei( GL_PACK_ALIGNMENT, iPackAlignment );
+
+  // sampling state of the old texture
+  GLint iMinFilter = GL_LINEAR_MIPMAP_LINEAR, iMagFilter = GL_LINEAR;
+  GLint aiSwizzle[4] = { GL_RED, GL_GREEN, GL_BLUE, GL_ALPHA };
+  glGetTexParameteriv( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, &iMinFilter );
+  glGetTexParameteriv( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, &iMagFilter );
+  glGetTexParameteriv( GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, aiSwizzle );
+
+  GLuint uiTexture = 0;
+  glGenTextures( 1, &uiTexture );
+  glBindTexture( GL_TEXTURE_2D, uiTexture );
+  GLint iUnpackAlignment = 4;
+  glGetIntegerv( GL_UNPACK_ALIGNMENT, &iUnpackAlignment );
+  glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
+  for( size_t ui = 0; ui < cLevels.size(); ui++ )
+  {
+    const Level& rcLevel = cLevels[ui];
+    if( iCompressed )
+      glCompressedTexImage2D( GL_TEXTURE_2D, (GLint)ui, (GLenum)iInternal, rcLevel.iWidth, rcLevel.iHeight, 0,
+                              (GLsizei)rcLevel.cData.size(), rcLevel.cData.data() );
+    else
+      glTexImage2D( GL_TEXTURE_2D, (GLint)ui, iInternal, rcLevel.iWidth, rcLevel.iHeight, 0, eFormat, GL_UNSIGNED_BYTE,
+                    rcLevel.cData.data() );
+  }
+  glPixelStorei( GL_UNPACK_ALIGNMENT, iUnpackAlignment );
+
+  glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (GLint)cLevels.size() - 1 );
+  glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, iMinFilter );
+  glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, iMagFilter );
+  glTexParameteriv( GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, aiSwizzle );
+  glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, (GLint)m_cDesc.eWrap );
+  glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, (GLint)m_cDesc.eWrap );
+
+  if( glGetError() != GL_NO_ERROR )
+  {
+    std::cerr << "TextureManager: cannot drop levels of " << m_cDesc.cPath << std::endl;
+    glDeleteTextures( 1, &uiTexture );
+    return false;
+  }
+
+  glDeleteTextures( 1, &m_uiTexture );
+  m_uiTexture = uiTexture;
+  m_uiDroppedLevels += uiNumLevels;
+  updateInfo();
+  return true;
+}
+
+
+
+TextureManager&
+TextureManager::get()
+{
+  static TextureManager s_cManager;
+  return s_cManager;
+}
+
+
+TextureHandle
+TextureManager::acquire( const TextureDesc& rcDesc, unsigned char ucRed, unsigned char ucGreen, unsigned char ucBlue )
+{
+  // return the existing texture if somebody still holds it
+  std::weak_ptr<Texture>& rcEntry = m_cTextures[rcDesc];
+  TextureHandle cTexture = rcEntry.lock();
+  if( cTexture )
+  {
+    m_uiNumShared++;
+    return cTexture;
+  }
+
+  cTexture.reset( new Texture( this, rcDesc ) );
+  cTexture->m_uiTexture = TextureLoader::createPlaceholder( ucRed, ucGreen, ucBlue );
+  cTexture->updateInfo();
+  cTexture->m_uiLastUsed = m_uiFrame;
+  cTexture->m_cPending = TextureLoader::get().load( rcDesc.cPath, rcDesc.uiChannels, rcDesc.uiFlags );
+  rcEntry = cTexture;
+  return cTexture;
+}
+
+
+void
+TextureManager::update( bool bWait )
+{
+  m_uiFrame++;
+
+  for( auto i = m_cTextures.begin(); i != m_cTextures.end(); )
+  {
+    TextureHandle cTexture = i->second.lock();
+    if( !cTexture )
+    {
+      i = m_cTextures.erase( i );
+      continue;
+    }
+    cTexture->finishLoad( bWait );
+    ++i;
+  }
+
+  enforceBudget();
+}
+
+
+void
+TextureManager::enforceBudget()
+{
+  if( !m_uiBudget ) return;
+
+  std::set<Texture*> cFailed;
+  size_t uiBytes = getGPUBytes();
+  while( uiBytes > m_uiBudget )
+  {
+    // least recently used texture that can still lose a level, the larger one on a tie
+    TextureHandle cVictim;
+    for( auto i = m_cTextures.begin(); i != m_cTextures.end(); ++i )
+    {
+      TextureHandle cTexture = i->second.lock();
+      if( !cTexture || !cTexture->isLoaded() || cTexture->m_uiNumLevels < 2 || cFailed.count( cTexture.get() ) ) continue;
+      if( std::max( cTexture->m_uiWidth, cTexture->m_uiHeight ) / 2 < MIN_EXTENT ) continue;
+      if( !cVictim || cTexture->m_uiLastUsed < cVictim->m_uiLastUsed ||
+          ( cTexture->m_uiLastUsed == cVictim->m_uiLastUsed && cTexture->m_uiBytes > cVictim->m_uiBytes ) )
+      {
+        cVictim = cTexture;
+      }
+    }
+    if( !cVictim ) break;
+
+    const size_t uiBefore = cVictim->m_uiBytes;
+    if( !cVictim->dropLevels( 1 ) )
+    {
+      cFailed.insert( cVictim.get() );
+      continue;
+    }
+    m_uiNumDroppedLevels++;
+    uiBytes = uiBytes - uiBefore + cVictim->m_uiBytes;
+  }
+}
+
+
+size_t
+TextureManager::getNumTextures() const
+{
+  size_t uiNum = 0;
+  for( auto i = m_cTextures.begin(); i != m_cTextures.end(); ++i )
+  {
+    if( !i->second.expired() ) uiNum++;
+  }
+  return uiNum;
+}
+
+
+size_t
+TextureManager::getGPUBytes() const
+{
+  size_t uiBytes = 0;
+  for( auto i = m_cTextures.begin(); i != m_cTextures.end(); ++i )
+  {
+    TextureHandle cTexture = i->second.lock();
+    if( cTexture ) uiBytes += cTexture->m_uiBytes;
+  }
+  return uiBytes;
+}
+
+
+void
+TextureManager::printStats( std::ostream& rcStream ) const
+{
+  for( auto i = m_cTextures.begin(); i != m_cTextures.end(); ++i )
+  {
+    TextureHandle cTexture = i->second.lock();
+    if( !cTexture ) continue;
+
+    rcStream << i->first.cPath << ": " << cTexture->m_uiWidth << "x" << cTexture->m_uiHeight
+             << ", " << cTexture->m_uiNumLevels << " levels (" << cTexture->m_uiDroppedLevels << " dropped)"
+             << ", " << cTexture->m_uiBytes << " bytes, " << cTexture.use_count() - 1 << " users"
+             << ( cTexture->isLoaded() ? "" : ", loading" ) << std::endl;
+  }
+  rcStream << "textures: " << getGPUBytes() << " bytes";
+  if( m_uiBudget ) rcStream << " of " << m_uiBudget << " budget";
+  rcStream << ", " << m_uiNumShared << " shared acquires, " << m_uiNumDroppedLevels << " levels dropped" << std::endl;
+}
@@ -0,0 +1,431 @@
+#include "GLRender/TweenSystem.h"
+
+#include <algorithm>
+
+#if defined(__SSE__) || defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 1 )
+#define GLRENDER_TWEEN_SSE
+#include <xmmintrin.h>
+#endif
+
+
+const uint32_t TweenSystem::NO_USER;
+
+
+// constructor
+TweenSystem::TweenSystem()
+  : m_uiSize( 0 )
+  , m_bSimd( hasSimd() )
+{
+}
+
+
+bool
+TweenSystem::hasSimd()
+{
+#ifdef GLRENDER_TWEEN_SSE
+  return true;
+#else
+  return false;
+#endif
+}
+
+
+void
+TweenSystem::start( uint32_t uiUser, const float* pfStart, const Keyframe* pcKeys, size_t uiNumKeys )
+{
+  if( isActive( uiUser ) ) freeSlot( m_cSlotOfUser[uiUser] );
+  uint32_t uiSlot = addSlot( uiUser );
+
+  m_cKeys[uiSlot].assign( pcKeys, pcKeys + uiNumKeys );
+  m_cKeyNext[uiSlot] = 0;
+
+  // an empty segment at the start, advanceSegment() loads the first keyframe
+  for( int c = 0; c < 3; c++ )
+  {
+    m_acChannels[CH_START_X + c][uiSlot] = pfStart[c];
+    m_acChannels[CH_END_X + c][uiSlot]   = pfStart[c];
+  }
+  m_acChannels[CH_TIME][uiSlot]         = 0.0f;
+  m_acChannels[CH_INV_DURATION][uiSlot] = 0.0f;
+  m_acChannels[CH_ARC][uiSlot]          = 0.0f;
+  m_cDuration[uiSlot] = 0.0f;
+  advanceSegment( uiSlot );
+  evaluate( uiSlot );
+
+  // no motion before the first step
+  for( int c = 0; c < 3; c++ )
+  {
+    m_acChannels[CH_PREV_X + c][uiSlot] = m_acChannels[CH_X + c][uiSlot];
+    m_acChannels[CH_DRAW_X + c][uiSlot] = m_acChannels[CH_X + c][uiSlot];
+  }
+}
+
+
+bool
+TweenSystem::append( uint32_t uiUser, const Keyframe* pcKeys, size_t uiNumKeys )
+{
+  if( !isActive( uiUser ) ) return false;
+  uint32_t uiSlot = m_cSlotOfUser[uiUser];
+  m_cKeys[uiSlot].insert( m_cKeys[uiSlot].end(), pcKeys, pcKeys + uiNumKeys );
+
+  if( m_cEnded[uiSlot] )
+  {
+    // resting at its end until update() retires it: time and duration are 0, so the first
+    // new keyframe is loaded right away (update() skips slots no longer marked as ended)
+    m_cEnded[uiSlot] = 0;
+    advanceSegment( uiSlot );
+    evaluate( uiSlot );
+  }
+  return true;
+}
+
+
+void
+TweenSystem::stop( uint32_t uiUser )
+{
+  if( isActive( uiUser ) ) freeSlot( m_cSlotOfUser[uiUser] );
+}
+
+
+void
+TweenSystem::clear()
+{
+  for( int c = 0; c < NUM_CHANNELS; c++ ) m_acChannels[c].clear();
+  m_uiSize = 0;
+  m_cDuration.clear();
+  m_cUsers.clear();
+  m_cKeys.clear();
+  m_cKeyNext.clear();
+  m_cEnded.clear();
+  m_cSlotOfUser.clear();
+  m_cFreeSlots.clear();
+  m_cEndedSlots.clear();
+  m_cRetired.clear();
+}
+
+
+bool
+TweenSystem::getPosition( uint32_t uiUser, float* pfPos ) const
+{
+  if( !isActive( uiUser ) ) return false;
+  uint32_t uiSlot = m_cSlotOfUser[uiUser];
+  pfPos[0] = m_acChannels[CH_X][uiSlot];
+  pfPos[1] = m_acChannels[CH_Y][uiSlot];
+  pfPos[2] = m_acChannels[CH_Z][uiSlot];
+  return true;
+}
+
+
+float
+TweenSystem::getRemaining( uint32_t uiUser ) const
+{
+  if( !isActive( uiUser ) ) return 0.0f;
+  uint32_t uiSlot = m_cSlotOfUser[uiUser];
+  if( m_cEnded[uiSlot] ) return 0.0f;
+
+  float fRemaining = m_cDuration[uiSlot] - m_acChannels[CH_TIME][uiSlot];
+  if( fRemaining < 0.0f ) fRemaining = 0.0f;
+  const std::vector<Keyframe>& rcKeys = m_cKeys[uiSlot];
+  for( size_t i = m_cKeyNext[uiSlot]; i < rcKeys.size(); i++ )
+  {
+    if( rcKeys[i].fDuration > 0.0f ) fRemaining += rcKeys[i].fDuration;
+  }
+  return fRemaining;
+}
+
+
+uint32_t
+TweenSystem::addSlot( uint32_t uiUser )
+{
+  uint32_t uiSlot;
+  if( !m_cFreeSlots.empty() )
+  {
+    uiSlot = m_cFreeSlots.back();
+    m_cFreeSlots.pop_back();
+    m_cEnded[uiSlot] = 0;
+  }
+  else
+  {
+    // overwrite the padding of the last group of four, or start a new group
+    if( m_uiSize == m_acChannels[0].size() )
+    {
+      for( int c = 0; c < NUM_CHANNELS; c++ ) m_acChannels[c].resize( m_uiSize + 4, 0.0f );
+    }
+    uiSlot = (uint32_t)m_uiSize++;
+
+    m_cDuration.push_back( 0.0f );
+    m_cUsers.push_back( NO_USER );
+    m_cKeys.emplace_back();
+    m_cKeyNext.push_back( 0 );
+    m_cEnded.push_back( 0 );
+  }
+
+  m_cUsers[uiSlot] = uiUser;
+  if( uiUser >= m_cSlotOfUser.size() ) m_cSlotOfUser.resize( uiUser + 1, NO_USER );
+  m_cSlotOfUser[uiUser] = uiSlot;
+  return uiSlot;
+}
+
+
+void
+TweenSystem::freeSlot( uint32_t uiSlot )
+{
+  // a hole stands still at its start until start() reuses it (and its keyframe storage)
+  m_cKeys[uiSlot].clear();
+  m_cKeyNext[uiSlot] = 0;
+  m_cSlotOfUser[m_cUsers[uiSlot]] = NO_USER;
+  m_cUsers[uiSlot] = NO_USER;
+  m_cEnded[uiSlot] = 0;
+  m_cDuration[uiSlot] = 0.0f;
+  m_acChannels[CH_INV_DURATION][uiSlot] = 0.0f;
+  m_acChannels[CH_ARC][uiSlot] = 0.0f;
+  m_cFreeSlots.push_back( uiSlot );
+}
+
+
+void
+TweenSystem::moveSlot( uint32_t uiFrom, uint32_t uiTo )
+{
+  // the draw channels are rewritten by interpolate() before they are read
+  for( int c = 0; c < CH_DRAW_X; c++ ) m_acChannels[c][uiTo] = m_acChannels[c][uiFrom];
+  m_cDuration[uiTo] = m_cDuration[uiFrom];
+  m_cUsers[uiTo]    = m_cUsers[uiFrom];
+  m_cKeys[uiTo].swap( m_cKeys[uiFrom] );
+  m_cKeyNext[uiTo]  = m_cKeyNext[uiFrom];
+  m_cEnded[uiTo]    = m_cEnded[uiFrom];
+  if( m_cUsers[uiTo] != NO_USER ) m_cSlotOfUser[m_cUsers[uiTo]] = uiTo;
+}
+
+
+void
+TweenSystem::compactSlots()
+{
+  // fill the holes from the front with the last active slots; holes at the end are dropped
+  std::sort( m_cFreeSlots.begin(), m_cFreeSlots.end() );
+  size_t uiSize = m_uiSize;
+  for( size_t i = 0; i < m_cFreeSlots.size(); i++ )
+  {
+    while( uiSize > 0 && m_cUsers[uiSize - 1] == NO_USER ) uiSize--;
+    if( m_cFreeSlots[i] >= uiSize ) break;
+    moveSlot( (uint32_t)( uiSize - 1 ), m_cFreeSlots[i] );
+    uiSize--;
+  }
+  m_cFreeSlots.clear();
+
+  // the entries behind the last slot become padding, which never ends a segment
+  size_t uiPadded = ( uiSize + 3 ) & ~(size_t)3;
+  for( int c = 0; c < NUM_CHANNELS; c++ )
+  {
+    m_acChannels[c].resize( uiPadded );
+    std::fill( m_acChannels[c].begin() + uiSize, m_acChannels[c].end(), 0.0f );
+  }
+  m_cDuration.resize( uiSize );
+  m_cUsers.resize( uiSize );
+  m_cKeys.resize( uiSize );
+  m_cKeyNext.resize( uiSize );
+  m_cEnded.resize( uiSize );
+  m_uiSize = uiSize;
+}
+
+
+void
+TweenSystem::advanceSegment( uint32_t uiSlot )
+{
+  float fTime = m_acChannels[CH_TIME][uiSlot];
+
+  // carry the time past the end into the next segments; segments of zero duration are jumps
+  while( !m_cEnded[uiSlot] && fTime >= m_cDuration[uiSlot] )
+  {
+    fTime -= m_cDuration[uiSlot];
+    for( int c = 0; c < 3; c++ ) m_acChannels[CH_START_X + c][uiSlot] = m_acChannels[CH_END_X + c][uiSlot];
+
+    if( m_cKeyNext[uiSlot] == m_cKeys[uiSlot].size() )
+    {
+      // rest at the last position until update() retires the slot
+      m_cEnded[uiSlot] = 1;
+      m_cEndedSlots.push_back( uiSlot );
+      m_cDuration[uiSlot] = 0.0f;
+      m_acChannels[CH_INV_DURATION][uiSlot] = 0.0f;
+      m_acChannels[CH_ARC][uiSlot] = 0.0f;
+      fTime = 0.0f;
+      break;
+    }
+
+    const Keyframe& rcKey = m_cKeys[uiSlot][m_cKeyNext[uiSlot]++];
+    for( int c = 0; c < 3; c++ ) m_acChannels[CH_END_X + c][uiSlot] = rcKey.afPos[c];
+    m_cDuration[uiSlot] = rcKey.fDuration > 0.0f ? rcKey.fDuration : 0.0f;
+    m_acChannels[CH_INV_DURATION][uiSlot] = rcKey.fDuration > 0.0f ? 1.0f / rcKey.fDuration : 0.0f;
+    m_acChannels[CH_ARC][uiSlot] = rcKey.fArc;
+  }
+
+  m_acChannels[CH_TIME][uiSlot] = fTime;
+}
+
+
+void
+TweenSystem::evaluate( uint32_t uiSlot )
+{
+  float fU = m_acChannels[CH_TIME][uiSlot] * m_acChannels[CH_INV_DURATION][uiSlot];
+  if( fU > 1.0f ) fU = 1.0f;
+
+  for( int c = 0; c < 3; c++ )
+  {
+    float fStart = m_acChannels[CH_START_X + c][uiSlot];
+    m_acChannels[CH_X + c][uiSlot] = fStart + ( m_acChannels[CH_END_X + c][uiSlot] - fStart ) * fU;
+  }
+  m_acChannels[CH_Z][uiSlot] += ( m_acChannels[CH_ARC][uiSlot] * 4.0f ) * ( fU * ( 1.0f - fU ) );
+}
+
+
+void
+TweenSystem::update( float fDt )
+{
+  // animations that ended in the last step were shown at their final position once; a slot
+  // that was stopped or reused in the meantime is no longer marked as ended
+  m_cRetired.clear();
+  for( size_t i = 0; i < m_cEndedSlots.size(); i++ )
+  {
+    uint32_t uiSlot = m_cEndedSlots[i];
+    if( !m_cEnded[uiSlot] ) continue;
+    Retired cRetired;
+    cRetired.uiUser = m_cUsers[uiSlot];
+    for( int c = 0; c < 3; c++ ) cRetired.afPos[c] = m_acChannels[CH_X + c][uiSlot];
+    m_cRetired.push_back( cRetired );
+    freeSlot( uiSlot );
+  }
+  m_cEndedSlots.clear();
+  if( m_cFreeSlots.size() * 4 > m_uiSize ) compactSlots();
+
+  // the last step becomes the previous one, the new step is written over the older buffer
+  for( int c = 0; c < 3; c++ ) m_acChannels[CH_X + c].swap( m_acChannels[CH_PREV_X + c] );
+  if( m_bSimd ) updateSimd( fDt );
+  else          updateScalar( fDt );
+}
+
+
+void
+TweenSystem::interpolate( float fAlpha )
+{
+  if( m_bSimd ) interpolateSimd( fAlpha );
+  else          interpolateScalar( fAlpha );
+}
+
+
+void
+TweenSystem::updateScalar( float fDt )
+{
+  float* pfTime = m_acChannels[CH_TIME].data();
+  const float* pfInvDuration = m_acChannels[CH_INV_DURATION].data();
+  const float* pfArc = m_acChannels[CH_ARC].data();
+
+  for( size_t i = 0; i < m_uiSize; i++ )
+  {
+    pfTime[i] += fDt;
+    float fU = pfTime[i] * pfInvDuration[i];
+    if( fU >= 1.0f )
+    {
+      advanceSegment( (uint32_t)i );
+      evaluate( (uint32_t)i );
+      continue;
+    }
+
+    for( int c = 0; c < 3; c++ )
+    {
+      float fStart = m_acChannels[CH_START_X + c][i];
+      m_acChannels[CH_X + c][i] = fStart + ( m_acChannels[CH_END_X + c][i] - fStart ) * fU;
+    }
+    m_acChannels[CH_Z][i] += ( pfArc[i] * 4.0f ) * ( fU * ( 1.0f - fU ) );
+  }
+}
+
+
+void
+TweenSystem::interpolateScalar( float fAlpha )
+{
+  for( int c = 0; c < 3; c++ )
+  {
+    const float* pfPrev = m_acChannels[CH_PREV_X + c].data();
+    const float* pfCur  = m_acChannels[CH_X + c].data();
+    float* pfDraw = m_acChannels[CH_DRAW_X + c].data();
+    for( size_t i = 0; i < m_uiSize; i++ ) pfDraw[i] = pfPrev[i] + ( pfCur[i] - pfPrev[i] ) * fAlpha;
+  }
+}
+
+
+#ifdef GLRENDER_TWEEN_SSE
+void
+TweenSystem::updateSimd( float fDt )
+{
+  float* apfChannel[NUM_CHANNELS];
+  for( int c = 0; c < NUM_CHANNELS; c++ ) apfChannel[c] = m_acChannels[c].data();
+
+  const __m128 vDt   = _mm_set1_ps( fDt );
+  const __m128 vOne  = _mm_set1_ps( 1.0f );
+  const __m128 vFour = _mm_set1_ps( 4.0f );
+
+  // the arrays are padded; padding has no duration, so its u stays 0
+  for( size_t uiGroup = 0; uiGroup < m_uiSize; uiGroup += 4 )
+  {
+    __m128 vTime = _mm_add_ps( _mm_loadu_ps( apfChannel[CH_TIME] + uiGroup ), vDt );
+    _mm_storeu_ps( apfChannel[CH_TIME] + uiGroup, vTime );
+
+    __m128 vU = _mm_mul_ps( vTime, _mm_loadu_ps( apfChannel[CH_INV_DURATION] + uiGroup ) );
+    int iEnded = _mm_movemask_ps( _mm_cmpge_ps( vU, vOne ) );
+    vU = _mm_min_ps( vU, vOne );
+
+    for( int c = 0; c < 3; c++ )
+    {
+      __m128 vStart = _mm_loadu_ps( apfChannel[CH_START_X + c] + uiGroup );
+      __m128 vEnd   = _mm_loadu_ps( apfChannel[CH_END_X + c] + uiGroup );
+      __m128 vPos   = _mm_add_ps( vStart, _mm_mul_ps( _mm_sub_ps( vEnd, vStart ), vU ) );
+      if( c == 2 )
+      {
+        // parabola through 0 at both ends with the arc height in the middle
+        __m128 vArc = _mm_mul_ps( _mm_loadu_ps( apfChannel[CH_ARC] + uiGroup ), vFour );
+        vPos = _mm_add_ps( vPos, _mm_mul_ps( vArc, _mm_mul_ps( vU, _mm_sub_ps( vOne, vU ) ) ) );
+      }
+      _mm_storeu_ps( apfChannel[CH_X + c] + uiGroup, vPos );
+    }
+
+    // next keyframe for the lanes whose segment ended, while the group is in the cache
+    for( int iLane = 0; iEnded; iLane++, iEnded >>= 1 )
+    {
+      if( !( iEnded & 1 ) ) continue;
+      advanceSegment( (uint32_t)( uiGroup + iLane ) );
+      evaluate( (uint32_t)( uiGroup + iLane ) );
+    }
+  }
+}
+
+
+void
+TweenSystem::interpolateSimd( float fAlpha )
+{
+  const __m128 vAlpha = _mm_set1_ps( fAlpha );
+  for( int c = 0; c < 3; c++ )
+  {
+    const float* pfPrev = m_acChannels[CH_PREV_X + c].data();
+    const float* pfCur  = m_acChannels[CH_X + c].data();
+    float* pfDraw = m_acChannels[CH_DRAW_X + c].data();
+    for( size_t uiGroup = 0; uiGroup < m_uiSize; uiGroup += 4 )
+    {
+      __m128 vPrev = _mm_loadu_ps( pfPrev + uiGroup );
+      __m128 vCur  = _mm_loadu_ps( pfCur + uiGroup );
+      _mm_storeu_ps( pfDraw + uiGroup, _mm_add_ps( vPrev, _mm_mul_ps( _mm_sub_ps( vCur, vPrev ), vAlpha ) ) );
+    }
+  }
+}
+#else
+void
+TweenSystem::updateSimd( float fDt )
+{
+  updateScalar( fDt );
+}
+
+
+void
+TweenSystem::interpolateSimd( float fAlpha )
+{
+  interpolateScalar( fAlpha );
+}
+#endif
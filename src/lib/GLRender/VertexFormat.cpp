@@ -0,0 +1,261 @@
+#include "GLRender/VertexFormat.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+
+
+VertexQuantization
+VertexQuantization::identity()
+{
+  VertexQuantization cQuant;
+  for( int c = 0; c < 3; c++ )
+  {
+    cQuant.afScale[c]  = 1.0f;
+    cQuant.afOffset[c] = 0.0f;
+  }
+  return cQuant;
+}
+
+
+void
+VertexQuantization::getMatrix( float* pfMat4 ) const
+{
+  for( int i = 0; i < 16; i++ ) pfMat4[i] = 0.0f;
+  for( int c = 0; c < 3; c++ )
+  {
+    pfMat4[c * 5]  = afScale[c];
+    pfMat4[12 + c] = afOffset[c];
+  }
+  pfMat4[15] = 1.0f;
+}
+
+
+
+// constructor
+VertexFormat::VertexFormat( PositionEncoding ePosition, TexCoordEncoding eTexCoord, NormalEncoding eNormal )
+  : m_ePosition( ePosition )
+  , m_eTexCoord( eTexCoord )
+  , m_eNormal( eNormal )
+  , m_iStride( 0 )
+  , m_iTexCoordOffset( 0 )
+  , m_iNormalOffset( 0 )
+{
+  // every attribute starts at a multiple of four bytes, 16 bit positions are padded to four
+  // components for that reason
+  m_iStride = m_ePosition == POSITION_INT16 ? 4 * sizeof(short) : 3 * sizeof(float);
+
+  m_iTexCoordOffset = m_iStride;
+  switch( m_eTexCoord )
+  {
+  case TEXCOORD_FLOAT2:  m_iStride += 2 * sizeof(float); break;
+  case TEXCOORD_HALF2:
+  case TEXCOORD_UNORM16: m_iStride += 2 * sizeof(short); break;
+  default: break;
+  }
+
+  m_iNormalOffset = m_iStride;
+  switch( m_eNormal )
+  {
+  case NORMAL_FLOAT3: m_iStride += 3 * sizeof(float); break;
+  case NORMAL_OCT16:  m_iStride += 2 * sizeof(short); break;
+  default: break;
+  }
+}
+
+
+void
+VertexFormat::setupAttribs() const
+{
+  // positions: integers are converted to float without normalization, the scale is applied
+  // with the model matrix (VertexQuantization)
+  if( m_ePosition == POSITION_INT16 ) glVertexAttribPointer( LOCATION_POSITION, 3, GL_SHORT, GL_FALSE, m_iStride, (void*)0 );
+  else                                glVertexAttribPointer( LOCATION_POSITION, 3, GL_FLOAT, GL_FALSE, m_iStride, (void*)0 );
+  glEnableVertexAttribArray( LOCATION_POSITION );
+
+  const void* pvTexCoord = (void*)(size_t)m_iTexCoordOffset;
+  switch( m_eTexCoord )
+  {
+  case TEXCOORD_FLOAT2:   glVertexAttribPointer( LOCATION_TEXCOORD, 2, GL_FLOAT, GL_FALSE, m_iStride, pvTexCoord ); break;
+  case TEXCOORD_HALF2:    glVertexAttribPointer( LOCATION_TEXCOORD, 2, GL_HALF_FLOAT, GL_FALSE, m_iStride, pvTexCoord ); break;
+  case TEXCOORD_UNORM16:  glVertexAttribPointer( LOCATION_TEXCOORD, 2, GL_UNSIGNED_SHORT, GL_TRUE, m_iStride, pvTexCoord ); break;
+  default: break;
+  }
+  if( hasTexCoords() ) glEnableVertexAttribArray( LOCATION_TEXCOORD );
+
+  const void* pvNormal = (void*)(size_t)m_iNormalOffset;
+  switch( m_eNormal )
+  {
+  case NORMAL_FLOAT3: glVertexAttribPointer( LOCATION_NORMAL, 3, GL_FLOAT, GL_FALSE, m_iStride, pvNormal ); break;
+  case NORMAL_OCT16:  glVertexAttribPointer( LOCATION_NORMAL, 2, GL_SHORT, GL_TRUE, m_iStride, pvNormal ); break;
+  default: break;
+  }
+  if( hasNormals() ) glEnableVertexAttribArray( LOCATION_NORMAL );
+}
+
+
+void
+VertexFormat::encode( const std::vector<float>& rcSource, int iSrcStride, int iTexCoordOffset, int iNormalOffset,
+                      std::vector<unsigned char>& rcOut, VertexQuantization* pcQuantization ) const
+{
+  const size_t uiNumVertices = rcSource.size() / iSrcStride;
+  rcOut.assign( uiNumVertices * m_iStride, 0 );
+
+  // box of the positions, mapped to [-32767, 32767] on every axis
+  VertexQuantization cQuant = VertexQuantization::identity();
+  if( m_ePosition == POSITION_INT16 && uiNumVertices )
+  {
+    for( int c = 0; c < 3; c++ )
+    {
+      float fMin = FLT_MAX, fMax = -FLT_MAX;
+      for( size_t v = 0; v < uiNumVertices; v++ )
+      {
+        fMin = std::min( fMin, rcSource[v * iSrcStride + c] );
+        fMax = std::max( fMax, rcSource[v * iSrcStride + c] );
+      }
+      cQuant.afOffset[c] = 0.5f * ( fMin + fMax );
+      cQuant.afScale[c]  = fMax > fMin ? 0.5f * ( fMax - fMin ) / 32767.0f : 1.0f;
+    }
+  }
+  if( pcQuantization ) *pcQuantization = cQuant;
+
+  for( size_t v = 0; v < uiNumVertices; v++ )
+  {
+    const float*   pfSrc = &rcSource[v * iSrcStride];
+    unsigned char* pucDst = &rcOut[v * m_iStride];
+
+    if( m_ePosition == POSITION_INT16 )
+    {
+      short asPos[4] = { 0, 0, 0, 0 };
+      for( int c = 0; c < 3; c++ )
+      {
+        float fValue = ( pfSrc[c] - cQuant.afOffset[c] ) / cQuant.afScale[c];
+        asPos[c] = (short)std::lround( std::max( -32767.0f, std::min( 32767.0f, fValue ) ) );
+      }
+      memcpy( pucDst, asPos, sizeof(asPos) );
+    }
+    else
+    {
+      memcpy( pucDst, pfSrc, 3 * sizeof(float) );
+    }
+
+    const float afNoTexCoord[2] = { 0.0f, 0.0f };
+    const float* pfTexCoord = iTexCoordOffset >= 0 ? pfSrc + iTexCoordOffset : afNoTexCoord;
+    switch( m_eTexCoord )
+    {
+    case TEXCOORD_FLOAT2:
+      memcpy( pucDst + m_iTexCoordOffset, pfTexCoord, 2 * sizeof(float) );
+      break;
+    case TEXCOORD_HALF2:
+    {
+      unsigned short ausUV[2] = { floatToHalf( pfTexCoord[0] ), floatToHalf( pfTexCoord[1] ) };
+      memcpy( pucDst + m_iTexCoordOffset, ausUV, sizeof(ausUV) );
+      break;
+    }
+    case TEXCOORD_UNORM16:
+    {
+      unsigned short ausUV[2];
+      for( int c = 0; c < 2; c++ ) ausUV[c] = (unsigned short)std::lround( std::max( 0.0f, std::min( 1.0f, pfTexCoord[c] ) ) * 65535.0f );
+      memcpy( pucDst + m_iTexCoordOffset, ausUV, sizeof(ausUV) );
+      break;
+    }
+    default:
+      break;
+    }
+
+    const float afNoNormal[3] = { 0.0f, 0.0f, 1.0f };
+    const float* pfNormal = iNormalOffset >= 0 ? pfSrc + iNormalOffset : afNoNormal;
+    switch( m_eNormal )
+    {
+    case NORMAL_FLOAT3:
+      memcpy( pucDst + m_iNormalOffset, pfNormal, 3 * sizeof(float) );
+      break;
+    case NORMAL_OCT16:
+    {
+      short asOct[2];
+      encodeOctahedral( pfNormal, asOct );
+      memcpy( pucDst + m_iNormalOffset, asOct, sizeof(asOct) );
+      break;
+    }
+    default:
+      break;
+    }
+  }
+}
+
+
+unsigned short
+VertexFormat::floatToHalf( float fValue )
+{
+  unsigned int uiBits;
+  memcpy( &uiBits, &fValue, sizeof(uiBits) );
+
+  unsigned int   uiSign     = ( uiBits >> 16 ) & 0x8000;
+  int            iExponent  = (int)( ( uiBits >> 23 ) & 0xff ) - 127 + 15;
+  unsigned int   uiMantissa = uiBits & 0x7fffff;
+
+  // nan and infinity
+  if( ( ( uiBits >> 23 ) & 0xff ) == 0xff ) return (unsigned short)( uiSign | 0x7c00 | ( uiMantissa ? 0x200 : 0 ) );
+  // overflow to infinity
+  if( iExponent >= 31 ) return (unsigned short)( uiSign | 0x7c00 );
+  // too small even for a denormal
+  if( iExponent < -10 ) return (unsigned short)uiSign;
+
+  // denormal: shift in the implicit one
+  if( iExponent <= 0 )
+  {
+    uiMantissa |= 0x800000;
+    unsigned int uiShift = (unsigned int)( 14 - iExponent );
+    unsigned int uiHalf  = uiMantissa >> uiShift;
+    // round to nearest
+    if( ( uiMantissa >> ( uiShift - 1 ) ) & 1 ) uiHalf++;
+    return (unsigned short)( uiSign | uiHalf );
+  }
+
+  // round to nearest, a carry into the exponent is correct
+  unsigned int uiHalf = uiSign | ( (unsigned int)iExponent << 10 ) | ( uiMantissa >> 13 );
+  if( uiMantissa & 0x1000 ) uiHalf++;
+  return (unsigned short)uiHalf;
+}
+
+
+void
+VertexFormat::encodeOctahedral( const float* pfNormal, short* psOut )
+{
+  // project onto the octahedron |x| + |y| + |z| = 1 and fold the lower half over the diagonals
+  float fLen = std::fabs( pfNormal[0] ) + std::fabs( pfNormal[1] ) + std::fabs( pfNormal[2] );
+  if( fLen <= 0.0f ) fLen = 1.0f;
+  float fX = pfNormal[0] / fLen;
+  float fY = pfNormal[1] / fLen;
+  if( pfNormal[2] < 0.0f )
+  {
+    float fFoldX = ( 1.0f - std::fabs( fY ) ) * ( fX >= 0.0f ? 1.0f : -1.0f );
+    float fFoldY = ( 1.0f - std::fabs( fX ) ) * ( fY >= 0.0f ? 1.0f : -1.0f );
+    fX = fFoldX;
+    fY = fFoldY;
+  }
+  psOut[0] = (short)std::lround( std::max( -1.0f, std::min( 1.0f, fX ) ) * 32767.0f );
+  psOut[1] = (short)std::lround( std::max( -1.0f, std::min( 1.0f, fY ) ) * 32767.0f );
+}
+
+
+void
+VertexFormat::decodeOctahedral( const short* psIn, float* pfNormal )
+{
+  float fX = std::max( -1.0f, psIn[0] / 32767.0f );
+  float fY = std::max( -1.0f, psIn[1] / 32767.0f );
+  float fZ = 1.0f - std::fabs( fX ) - std::fabs( fY );
+  if( fZ < 0.0f )
+  {
+    float fUnfoldX = ( 1.0f - std::fabs( fY ) ) * ( fX >= 0.0f ? 1.0f : -1.0f );
+    float fUnfoldY = ( 1.0f - std::fabs( fX ) ) * ( fY >= 0.0f ? 1.0f : -1.0f );
+    fX = fUnfoldX;
+    fY = fUnfoldY;
+  }
+  float fLen = std::sqrt( fX * fX + fY * fY + fZ * fZ );
+  pfNormal[0] = fX / fLen;
+  pfNormal[1] = fY / fLen;
+  pfNormal[2] = fZ / fLen;
+}
@@ -505,6 +505,10 @@ typedef struct HuffmanTree
   unsigned* lengths; /*the lengths of the codes of the 1d-tree*/
   unsigned maxbitlen; /*maximum number of bits a single code can get*/
   unsigned numcodes; /*number of symbols in the alphabet = number of codes*/
+  /*lookup tables of the fast inflater (only made by HuffmanTree_makeTable): code length and symbol
+  per entry; a first level entry with a length above FIRSTBITS points to a second level table instead*/
+  unsigned char* table_len;
+  unsigned short* table_value;
 } HuffmanTree;
 
 /*function used for debug purposes to draw the tree in ascii art with C++*/
@@ -525,6 +529,8 @@ static void HuffmanTree_init(HuffmanTree* tree)
   tree->tree2d = 0;
   tree->tree1d = 0;
   tree->lengths = 0;
+  tree->table_len = 0;
+  tree->table_value = 0;
 }
 
 static void HuffmanTree_cleanup(HuffmanTree* tree)
@@ -532,6 +538,8 @@ static void HuffmanTree_cleanup(HuffmanTree* tree)
   lodepng_free(tree->tree2d);
   lodepng_free(tree->tree1d);
   lodepng_free(tree->lengths);
+  lodepng_free(tree->table_len);
+  lodepng_free(tree->table_value);
 }
 
 /*the tree representation used by the decoder. return value is error*/
@@ -938,6 +946,199 @@ static unsigned huffmanDecodeSymbol(const unsigned char* in, size_t* bp,
     if(treepos >= codetree->numcodes) return (unsigned)(-1); /*error: it appeared outside the codetree*/
   }
 }
+
+/* ////////////////////////////////////////////////////////////////////////// */
+/* / Table-driven Huffman decoding                                          / */
+/* ////////////////////////////////////////////////////////////////////////// */
+
+/*
+Instead of walking tree2d one bit at a time, the fast inflater looks up the next FIRSTBITS bits
+of the stream in a table that gives the symbol and the length of its code at once. Codes longer
+than FIRSTBITS continue in a second level table per FIRSTBITS-bit prefix, sized for the longest
+code with that prefix. The bits are read from lsb to msb of each byte while deflate stores the
+codes msb first, so the tables are indexed with the reversed codes.
+*/
+#define FIRSTBITS 9u
+#define FIRSTMASK ((1u << FIRSTBITS) - 1u)
+/*table_value of an unused code, larger than any symbol*/
+#define INVALIDSYMBOL 65535u
+
+static unsigned reverseBits(unsigned bits, unsigned num)
+{
+  unsigned i, result = 0;
+  for(i = 0; i != num; ++i) result |= ((bits >> (num - i - 1u)) & 1u) << i;
+  return result;
+}
+
+/*makes table_len and table_value, tree1d and lengths must already be filled in. return value is error*/
+static unsigned HuffmanTree_makeTable(HuffmanTree* tree)
+{
+  unsigned maxlens[FIRSTMASK + 1]; /*longest code per first level entry*/
+  size_t size, pointer, i, j;
+
+  for(i = 0; i <= FIRSTMASK; ++i) maxlens[i] = 0;
+  for(i = 0; i != tree->numcodes; ++i)
+  {
+    unsigned l = tree->lengths[i];
+    if(l <= FIRSTBITS) continue;
+    if(l > 15) return 55; /*deflate codes have at most 15 bits*/
+    j = reverseBits(tree->tree1d[i] >> (l - FIRSTBITS), FIRSTBITS);
+    if(l > maxlens[j]) maxlens[j] = l;
+  }
+
+  size = FIRSTMASK + 1;
+  for(i = 0; i <= FIRSTMASK; ++i)
+  {
+    if(maxlens[i] > FIRSTBITS) size += (size_t)1u << (maxlens[i] - FIRSTBITS);
+  }
+  tree->table_len = (unsigned char*)lodepng_malloc(size * sizeof(unsigned char));
+  tree->table_value = (unsigned short*)lodepng_malloc(size * sizeof(unsigned short));
+  if(!tree->table_len || !tree->table_value) return 83; /*alloc fail*/
+
+  /*a length of 0 marks entries that are not filled in yet*/
+  for(i = 0; i != size; ++i)
+  {
+    tree->table_len[i] = 0;
+    tree->table_value[i] = INVALIDSYMBOL;
+  }
+
+  /*first level entries of the long codes point to their second level table*/
+  pointer = FIRSTMASK + 1;
+  for(i = 0; i <= FIRSTMASK; ++i)
+  {
+    if(maxlens[i] <= FIRSTBITS) continue;
+    tree->table_len[i] = (unsigned char)maxlens[i];
+    tree->table_value[i] = (unsigned short)pointer;
+    pointer += (size_t)1u << (maxlens[i] - FIRSTBITS);
+  }
+
+  /*every entry whose low bits are the reversed code gets the symbol*/
+  for(i = 0; i != tree->numcodes; ++i)
+  {
+    unsigned l = tree->lengths[i];
+    unsigned reverse;
+    if(l == 0) continue;
+    reverse = reverseBits(tree->tree1d[i], l);
+    if(l <= FIRSTBITS)
+    {
+      for(j = 0; j != ((size_t)1u << (FIRSTBITS - l)); ++j)
+      {
+        size_t index = reverse | (j << l);
+        if(tree->table_len[index] != 0) return 55; /*oversubscribed, see comment in lodepng_error_text*/
+        tree->table_len[index] = (unsigned char)l;
+        tree->table_value[index] = (unsigned short)i;
+      }
+    }
+    else
+    {
+      unsigned maxlen = tree->table_len[reverse & FIRSTMASK];
+      size_t start = tree->table_value[reverse & FIRSTMASK];
+      if(maxlen < l) return 55; /*the prefix is already used by a shorter code*/
+      for(j = 0; j != ((size_t)1u << (maxlen - l)); ++j)
+      {
+        size_t index = start + ((reverse >> FIRSTBITS) | (j << (l - FIRSTBITS)));
+        if(tree->table_len[index] != 0) return 55; /*oversubscribed*/
+        tree->table_len[index] = (unsigned char)l;
+        tree->table_value[index] = (unsigned short)i;
+      }
+    }
+  }
+
+  /*unused codes of incomplete trees: the lookup must not consume more bits than the first level,
+  the symbol makes the decoder fail*/
+  for(i = FIRSTMASK + 1; i != size; ++i)
+  {
+    if(tree->table_len[i] == 0) tree->table_len[i] = FIRSTBITS;
+  }
+
+  return 0;
+}
+
+/*the upcoming bits of the deflate stream, lsb first*/
+typedef struct BitReader64
+{
+  const unsigned char* data;
+  size_t size; /*in bytes*/
+  size_t next; /*next byte to load into buffer, runs past size at the end of the stream (zeros are loaded then)*/
+  unsigned long long buffer;
+  unsigned count; /*number of valid bits in buffer*/
+} BitReader64;
+
+/*make sure that buffer holds at least 56 bits*/
+static void BitReader64_refill(BitReader64* reader)
+{
+  if(reader->next + 8 <= reader->size)
+  {
+    /*load 8 bytes at once, only the whole bytes that fit into the buffer are counted as read*/
+    const unsigned char* p = &reader->data[reader->next];
+    unsigned long long word = (unsigned long long)p[0] | ((unsigned long long)p[1] << 8)
+                            | ((unsigned long long)p[2] << 16) | ((unsigned long long)p[3] << 24)
+                            | ((unsigned long long)p[4] << 32) | ((unsigned long long)p[5] << 40)
+                            | ((unsigned long long)p[6] << 48) | ((unsigned long long)p[7] << 56);
+    reader->buffer |= word << reader->count;
+    reader->next += (63u - reader->count) >> 3;
+    reader->count |= 56u;
+  }
+  else
+  {
+    while(reader->count < 56)
+    {
+      unsigned long long byte = reader->next < reader->size ? reader->data[reader->next] : 0;
+      reader->buffer |= byte << reader->count;
+      ++reader->next;
+      reader->count += 8;
+    }
+  }
+}
+
+static void BitReader64_skip(BitReader64* reader, unsigned nbits)
+{
+  reader->buffer >>= nbits;
+  reader->count -= nbits;
+}
+
+/*nbits must be available in buffer*/
+static unsigned BitReader64_read(BitReader64* reader, unsigned nbits)
+{
+  unsigned result = (unsigned)(reader->buffer & ((1ull << nbits) - 1u));
+  BitReader64_skip(reader, nbits);
+  return result;
+}
+
+/*bit pointer into data, like bp of the other inflate functions*/
+static size_t BitReader64_position(const BitReader64* reader)
+{
+  return reader->next * 8 - reader->count;
+}
+
+static void BitReader64_init(BitReader64* reader, const unsigned char* data, size_t size, size_t bp)
+{
+  reader->data = data;
+  reader->size = size;
+  reader->next = bp >> 3;
+  reader->buffer = 0;
+  reader->count = 0;
+  BitReader64_refill(reader);
+  BitReader64_skip(reader, (unsigned)(bp & 0x7));
+}
+
+/*returns the symbol, INVALIDSYMBOL for an unused code. 15 bits must be available in buffer*/
+static unsigned huffmanDecodeSymbolFast(BitReader64* reader, const HuffmanTree* codetree)
+{
+  unsigned index = (unsigned)(reader->buffer & FIRSTMASK);
+  unsigned l = codetree->table_len[index];
+  unsigned value = codetree->table_value[index];
+  if(l <= FIRSTBITS)
+  {
+    BitReader64_skip(reader, l);
+    return value;
+  }
+  /*long code: the following bits index the second level table*/
+  BitReader64_skip(reader, FIRSTBITS);
+  index = value + (unsigned)(reader->buffer & ((1u << (l - FIRSTBITS)) - 1u));
+  BitReader64_skip(reader, codetree->table_len[index] - FIRSTBITS);
+  return codetree->table_value[index];
+}
 #endif /*LODEPNG_COMPILE_DECODER*/
 
 #ifdef LODEPNG_COMPILE_DECODER
@@ -1197,6 +1398,96 @@ static unsigned inflateHuffmanBlock(ucvector* out, const unsigned char* in, size
   return error;
 }
 
+/*inflate a block with dynamic of fixed Huffman tree, with the lookup tables of the fast inflater*/
+static unsigned inflateHuffmanBlockFast(ucvector* out, const unsigned char* in, size_t* bp,
+                                        size_t* pos, size_t inlength, unsigned btype)
+{
+  unsigned error = 0;
+  HuffmanTree tree_ll; /*the huffman tree for literal and length codes*/
+  HuffmanTree tree_d; /*the huffman tree for distance codes*/
+  BitReader64 reader;
+  size_t inbitlength = inlength * 8;
+
+  HuffmanTree_init(&tree_ll);
+  HuffmanTree_init(&tree_d);
+
+  /*the trees are read with the bit by bit decoder, they are small compared to the data*/
+  if(btype == 1) getTreeInflateFixed(&tree_ll, &tree_d);
+  else if(btype == 2) error = getTreeInflateDynamic(&tree_ll, &tree_d, in, bp, inlength);
+
+  if(!error) error = HuffmanTree_makeTable(&tree_ll);
+  if(!error) error = HuffmanTree_makeTable(&tree_d);
+  BitReader64_init(&reader, in, inlength, *bp);
+
+  while(!error) /*decode all symbols until end reached, breaks at end code*/
+  {
+    unsigned code_ll;
+    /*one refill covers the longest code (15 bits) plus the length extra bits (5 bits)*/
+    BitReader64_refill(&reader);
+    code_ll = huffmanDecodeSymbolFast(&reader, &tree_ll);
+    /*the buffer is padded with zeros after the end of the input*/
+    if(reader.next > reader.size && BitReader64_position(&reader) > inbitlength) ERROR_BREAK(10);
+
+    if(code_ll <= 255) /*literal symbol*/
+    {
+      if(!ucvector_resize(out, (*pos) + 1)) ERROR_BREAK(83 /*alloc fail*/);
+      out->data[*pos] = (unsigned char)code_ll;
+      ++(*pos);
+    }
+    else if(code_ll >= FIRST_LENGTH_CODE_INDEX && code_ll <= LAST_LENGTH_CODE_INDEX) /*length code*/
+    {
+      unsigned code_d;
+      size_t start, forward, backward, length, distance;
+
+      length = LENGTHBASE[code_ll - FIRST_LENGTH_CODE_INDEX];
+      length += BitReader64_read(&reader, LENGTHEXTRA[code_ll - FIRST_LENGTH_CODE_INDEX]);
+
+      /*one refill covers the distance code (15 bits) plus its extra bits (13 bits)*/
+      BitReader64_refill(&reader);
+      code_d = huffmanDecodeSymbolFast(&reader, &tree_d);
+      if(code_d > 29)
+      {
+        /*11=wrong jump outside of tree, 18=invalid distance code (30-31 are never used)*/
+        error = code_d == INVALIDSYMBOL ? 11 : 18;
+        break;
+      }
+      distance = DISTANCEBASE[code_d];
+      distance += BitReader64_read(&reader, DISTANCEEXTRA[code_d]);
+      if(reader.next > reader.size && BitReader64_position(&reader) > inbitlength) ERROR_BREAK(51);
+
+      start = (*pos);
+      if(distance > start) ERROR_BREAK(52); /*too long backward distance*/
+      backward = start - distance;
+
+      if(!ucvector_resize(out, (*pos) + length)) ERROR_BREAK(83 /*alloc fail*/);
+      if(distance < length)
+      {
+        for(forward = 0; forward < length; ++forward)
+        {
+          out->data[(*pos)++] = out->data[backward++];
+        }
+      }
+      else
+      {
+        memcpy(out->data + *pos, out->data + backward, length);
+        *pos += length;
+      }
+    }
+    else if(code_ll == 256)
+    {
+      break; /*end code, break the loop*/
+    }
+    else ERROR_BREAK(11); /*unused code of an incomplete tree*/
+  }
+
+  *bp = BitReader64_position(&reader);
+
+  HuffmanTree_cleanup(&tree_ll);
+  HuffmanTree_cleanup(&tree_d);
+
+  return error;
+}
+
 static unsigned inflateNoCompression(ucvector* out, const unsigned char* in, size_t* bp, size_t* pos, size_t inlength)
 {
   size_t p;
@@ -1235,8 +1526,6 @@ static unsigned lodepng_inflatev(ucvector* out,
   size_t pos = 0; /*byte position in the out buffer*/
   unsigned error = 0;
 
-  (void)settings;
-
   while(!BFINAL)
   {
     unsigned BTYPE;
@@ -1247,6 +1536,7 @@ static unsigned lodepng_inflatev(ucvector* out,
 
     if(BTYPE == 3) return 20; /*error: invalid BTYPE*/
     else if(BTYPE == 0) error = inflateNoCompression(out, in, &bp, &pos, insize); /*no compression*/
+    else if(settings->fast_inflate) error = inflateHuffmanBlockFast(out, in, &bp, &pos, insize, BTYPE);
     else error = inflateHuffmanBlock(out, in, &bp, &pos, insize, BTYPE); /*compression, BTYPE 01 or 10*/
 
     if(error) return error;
@@ -2278,9 +2568,11 @@ void lodepng_decompress_settings_init(LodePNGDecompressSettings* settings)
   settings->custom_zlib = 0;
   settings->custom_inflate = 0;
   settings->custom_context = 0;
+
+  settings->fast_inflate = 1;
 }
 
-const LodePNGDecompressSettings lodepng_default_decompress_settings = {0, 0, 0, 0};
+const LodePNGDecompressSettings lodepng_default_decompress_settings = {0, 0, 0, 0, 1};
 
 #endif /*LODEPNG_COMPILE_DECODER*/
 
@@ -1,128 +1,130 @@
 #include "glad/glad.h"
 #define GLFW_INCLUDE_NONE
 #include <GLFW/glfw3.h>
-#include "stb/stb_image.h"
-#include "Board.h"  
-#include "Figur.h"
-#include "ShaderUtils.h"
+#include "Scene.h"
+#include "HeadlessContext.h"
+#include "GLRender/Common.h"
+#include "GLRender/FixedTimestep.h"
+#include "GLRender/Framebuffer.h"
+#include "GLRender/GLDebug.h"
+#include "GLRender/GLExtensions.h"
+#include "GLRender/MeshLibrary.h"
+#include "GLRender/RenderThread.h"
+#include "GLRender/ShaderRegistry.h"
+#include "GLRender/TextureManager.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <string>
 #include <vector>
 
-Board* g_pcBoard = nullptr; // Neues Board-Objekt für das Spielfeld
-std::vector<Figur*> g_figuren; // Container für 16 Figuren
+Scene* g_pcScene = nullptr; // Kamera, Hintergrund, Brett und Figuren
+RenderThread* g_pcRenderThread = nullptr; // besitzt im Fenstermodus den GL-Kontext
 
-// Globale Variablen für den Hintergrund
-unsigned int quadVAO, quadVBO;
-unsigned int bgTexture;
-unsigned int bgShaderProgram;
+// Gehaltene Drehtasten (A, Z, K, L); gedreht wird im Simulationsschritt mit fester
+// Geschwindigkeit, unabhängig von Bildrate und Tastenwiederholung
+const float ROTATION_SPEED = 60.0f;  // Grad pro Sekunde
+bool g_abRotateKeys[4] = { false, false, false, false };
+int g_iSelectedPiece = -1;  // zuletzt angeklickte Figur, zieht mit den Tasten 1 bis 6
 
 void errorCallback(int iError, const char* pcDescription);
 void resizeCallback(GLFWwindow* pWindow, int width, int height);
 void keyboardCallback(GLFWwindow* pWindow, int iKey, int iScancode, int iAction, int iMods);
+void mouseButtonCallback(GLFWwindow* pWindow, int iButton, int iAction, int iMods);
 
-// Hilfsfunktion: Shader aus Dateien kompilieren
-unsigned int compileShader(const std::string &vertexPath, const std::string &fragmentPath)
+// Einstellungen für den Fenstermodus (Kommandozeile)
+struct WindowOptions
 {
-  std::string vertexCode = readShaderFile(vertexPath);
-  std::string fragmentCode = readShaderFile(fragmentPath);
-  if(vertexCode.empty() || fragmentCode.empty()){
-    return 0;
-  }
-  const char* vertexSource = vertexCode.c_str();
-  const char* fragmentSource = fragmentCode.c_str();
-
-  unsigned int vertexShader = glCreateShader(GL_VERTEX_SHADER);
-  glShaderSource(vertexShader, 1, &vertexSource, nullptr);
-  glCompileShader(vertexShader);
-  int success;
-  glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-  if (!success)
-  {
-    char infoLog[512];
-    glGetShaderInfoLog(vertexShader, 512, nullptr, infoLog);
-    std::cerr << "Fehler beim Kompilieren des Vertex Shaders:\n" << infoLog << std::endl;
-    return 0;
-  }
+  bool bRenderThread = true;    // GL-Aufrufe auf einem eigenen Render-Thread
+  bool bVSync = true;           // Präsentation mit dem Bildschirm synchronisieren
+  double dTickRate = 60.0;      // Simulationsschritte pro Sekunde
+};
 
-  unsigned int fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-  glShaderSource(fragmentShader, 1, &fragmentSource, nullptr);
-  glCompileShader(fragmentShader);
-  glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-  if (!success)
-  {
-    char infoLog[512];
-    glGetShaderInfoLog(fragmentShader, 512, nullptr, infoLog);
-    std::cerr << "Fehler beim Kompilieren des Fragment Shaders:\n" << infoLog << std::endl;
-    return 0;
-  }
+// Einstellungen für den Headless-Modus (Kommandozeile)
+struct HeadlessOptions
+{
+  unsigned int uiFrames = 100;  // Anzahl gerenderter Frames
+  std::string dumpDir;          // Frames als PNG ablegen, leer = nicht speichern
+  std::string traceFile;        // Chrome-Trace der Pass-Zeiten, leer = nicht schreiben
+  double dTickRate = 60.0;      // ein Simulationsschritt von 1 / dTickRate Sekunden pro Frame
+};
 
-  unsigned int shaderProgram = glCreateProgram();
-  glAttachShader(shaderProgram, vertexShader);
-  glAttachShader(shaderProgram, fragmentShader);
-  glLinkProgram(shaderProgram);
-  glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-  if (!success)
-  {
-    char infoLog[512];
-    glGetProgramInfoLog(shaderProgram, 512, nullptr, infoLog);
-    std::cerr << "Fehler beim Linken des Shader-Programms:\n" << infoLog << std::endl;
-    return 0;
-  }
-  glDeleteShader(vertexShader);
-  glDeleteShader(fragmentShader);
-  return shaderProgram;
+int runWindowed(unsigned int uiWidth, unsigned int uiHeight, const WindowOptions& options);
+int runHeadless(unsigned int uiWidth, unsigned int uiHeight, const HeadlessOptions& options);
+
+void printUsage(const char* pcName)
+{
+  std::cout << "usage: " << pcName << " [--headless] [--single-thread] [--no-vsync] [--tick-rate HZ] [--frames N] [--size WxH] [--dump DIR] [--trace FILE]" << std::endl;
+  std::cout << "  --headless   render offscreen (EGL or hidden window) without presenting" << std::endl;
+  std::cout << "  --single-thread  issue the GL calls on the main thread instead of a render thread" << std::endl;
+  std::cout << "  --no-vsync   present as fast as possible" << std::endl;
+  std::cout << "  --tick-rate HZ  simulation steps per second (default 60), headless runs one step per frame" << std::endl;
+  std::cout << "  --frames N   number of frames in headless mode (default 100)" << std::endl;
+  std::cout << "  --size WxH   framebuffer size (default 800x600)" << std::endl;
+  std::cout << "  --dump DIR   write every headless frame as png into DIR" << std::endl;
+  std::cout << "  --trace FILE write the pass timings as Chrome trace JSON" << std::endl;
 }
 
-// Hilfsfunktion: Textur laden (nutzt stb_image)
-unsigned int loadTexture(const char* path)
+int main(int argc, char* argv[])
 {
-  // Bild vertikal umdrehen, damit es richtig ausgerichtet ist
-  stbi_set_flip_vertically_on_load(true);
-  unsigned int textureID;
-  glGenTextures(1, &textureID);
-  
-  int width, height, nrChannels;
-  unsigned char *data = stbi_load(path, &width, &height, &nrChannels, 0);
-  if (data)
-  {
-    GLenum format;
-    if(nrChannels == 1)
-      format = GL_RED;
-    else if(nrChannels == 3)
-      format = GL_RGB;
-    else if(nrChannels == 4)
-      format = GL_RGBA;
-  
-    glBindTexture(GL_TEXTURE_2D, textureID);
-    glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-    glGenerateMipmap(GL_TEXTURE_2D);
-  
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-  
-    stbi_image_free(data);
+  unsigned int uiWidth = 800;
+  unsigned int uiHeight = 600;
+  bool bHeadless = false;
+  WindowOptions windowOptions;
+  HeadlessOptions options;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "--headless") {
+      bHeadless = true;
     }
-    else
-    {
-      std::cout << "Fehler beim Laden der Textur: " << path << std::endl;
-      stbi_image_free(data);
+    else if (arg == "--single-thread") {
+      windowOptions.bRenderThread = false;
     }
-  
-    return textureID;
-}
-
+    else if (arg == "--no-vsync") {
+      windowOptions.bVSync = false;
+    }
+    else if (arg == "--tick-rate" && i + 1 < argc) {
+      double dTickRate = std::strtod(argv[++i], nullptr);
+      if (!(dTickRate > 0.0)) {
+        std::cerr << "Fehler: ungültige Schrittrate " << argv[i] << std::endl;
+        return -1;
+      }
+      windowOptions.dTickRate = options.dTickRate = dTickRate;
+    }
+    else if (arg == "--frames" && i + 1 < argc) {
+      options.uiFrames = (unsigned int)std::strtoul(argv[++i], nullptr, 10);
+    }
+    else if (arg == "--size" && i + 1 < argc) {
+      if (std::sscanf(argv[++i], "%ux%u", &uiWidth, &uiHeight) != 2 || !uiWidth || !uiHeight) {
+        std::cerr << "Fehler: ungültige Größe " << argv[i] << std::endl;
+        return -1;
+      }
+    }
+    else if (arg == "--dump" && i + 1 < argc) {
+      options.dumpDir = argv[++i];
+    }
+    else if (arg == "--trace" && i + 1 < argc) {
+      options.traceFile = argv[++i];
+    }
+    else {
+      printUsage(argv[0]);
+      return arg == "--help" ? 0 : -1;
+    }
+  }
 
+  return bHeadless ? runHeadless(uiWidth, uiHeight, options) : runWindowed(uiWidth, uiHeight, windowOptions);
+}
 
-int main(int argc, char* argv[])
+int runWindowed(unsigned int uiWidth, unsigned int uiHeight, const WindowOptions& options)
 {
-  const unsigned int uiWidth = 800;
-  const unsigned int uiHeight = 600;
-  //GLFWwindow* pWindow;
-
+  const auto start = std::chrono::steady_clock::now();
+  bool bFirstFrame = true;
   glfwSetErrorCallback(errorCallback);                          // set a callback for GLFW errors
 
   if(!glfwInit()) {
@@ -132,6 +134,9 @@ int main(int argc, char* argv[])
   glfwWindowHint( GLFW_CONTEXT_VERSION_MAJOR, 3);               // open a OpenGL 3.2 context
   glfwWindowHint( GLFW_CONTEXT_VERSION_MINOR, 3);
   glfwWindowHint( GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+#ifdef GLRENDER_GL_DEBUG
+  glfwWindowHint( GLFW_OPENGL_DEBUG_CONTEXT, GLFW_TRUE);         // Debug-Kontext, damit der Treiber Fehler meldet
+#endif
   
   GLFWwindow* pWindow = glfwCreateWindow( uiWidth, uiHeight, "Mensch Ärgere Dich Nicht", NULL, NULL); // öffnet das Fenster
   if(!pWindow)
@@ -143,192 +148,273 @@ int main(int argc, char* argv[])
 
   glfwMakeContextCurrent(pWindow);                              // make the render context current
   gladLoadGL();                                                 // load all the GL commands
-  glfwSwapInterval(1);                                          // synchronize with display update
-
-  // OpenGL aktivieren
-  glEnable(GL_DEPTH_TEST);
-  glViewport(0, 0, uiWidth, uiHeight);
-
-  // Board-Objekt erstellen
-  g_pcBoard = new Board();
-
-  if (!g_pcBoard) {
-        std::cerr << "Fehler: Board konnte nicht erstellt werden!" << std::endl;
-        glfwTerminate();
-        return -1;
-  }
-
-  g_pcBoard->setWindowSize(uiWidth, uiHeight);
-  g_pcBoard->initGL();
-
- // Hintergrund-Quad erstellen
-  float quadVertices[] = {
-    // Position      // TexCoords
-    -1.0f,  1.0f,    0.0f, 1.0f,  // oben links
-    -1.0f, -1.0f,    0.0f, 0.0f,  // unten links
-    1.0f, -1.0f,    1.0f, 0.0f,  // unten rechts
-
-    -1.0f,  1.0f,    0.0f, 1.0f,  // oben links
-    1.0f, -1.0f,    1.0f, 0.0f,  // unten rechts
-    1.0f,  1.0f,    1.0f, 1.0f   // oben rechts
-  };
-    glGenVertexArrays(1, &quadVAO);
-    glGenBuffers(1, &quadVBO);
-    glBindVertexArray(quadVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), quadVertices, GL_STATIC_DRAW);
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-    glBindVertexArray(0);
-  
-    // Hintergrundtextur laden
-    bgTexture = loadTexture("textures/background.jpg");
-  
-    // Hintergrund-Shader kompilieren (Pfad anpassen, falls nötig)
-    std::string bgVertPath = "shader/background.vert";
-    std::string bgFragPath = "shader/background.frag";
-    bgShaderProgram = compileShader(bgVertPath, bgFragPath);
-    if (!bgShaderProgram)
-    {
-        std::cerr << "Fehler: Hintergrund-Shader konnte nicht geladen werden!" << std::endl;
-    }
-
+  loadGLExtensions((GLADloadproc)glfwGetProcAddress);           // load optional GL commands (program binaries, ...)
+  GLDebug::init();                                              // GL-Fehler über den Debug-Callback melden (falls vorhanden)
+  ShaderRegistry::get().setCacheDirectory("shadercache");       // gelinkte Programme für den nächsten Start speichern
+  glfwSwapInterval(options.bVSync ? 1 : 0);                    // synchronize with display update
 
-
-  // Erzeuge 16 Figuren und weise ihnen Position und Farbe zu
-  // Definiere Farben:
-  glm::vec3 red   = glm::vec3(0.85f, 0.0f, 0.0f);
-  glm::vec3 green = glm::vec3(0.0f, 0.70f, 0.0f);
-  glm::vec3 yellow= glm::vec3(0.95f, 0.95f, 0.0f);
-  glm::vec3 blue  = glm::vec3(0.0f, 0.5f, 0.9f);
-
-  
-  // Board ist derzeit ein Quadrat von ca. -0.5 bis 0.5 (skaliert wird im Board-Konstruktor)
-  std::vector<glm::vec3> redPositions = {
-      glm::vec3(-0.38f,  0.38f, 0.0f), glm::vec3(-0.28f,  0.38f, 0.0f),
-      glm::vec3(-0.38f,  0.28f, 0.0f), glm::vec3(-0.28f,  0.28f, 0.0f)
-  };
-  std::vector<glm::vec3> greenPositions = {
-      glm::vec3(0.38f,  -0.38f, 0.0f), glm::vec3(0.28f,  -0.38f, 0.0f),
-      glm::vec3(0.38f,  -0.28f, 0.0f), glm::vec3(0.28f,  -0.28f, 0.0f)
-  };
-  std::vector<glm::vec3> yellowPositions = {
-      glm::vec3(-0.38f, -0.38f, 0.0f), glm::vec3(-0.28f, -0.38f, 0.0f),
-      glm::vec3(-0.38f, -0.28f, 0.0f), glm::vec3(-0.28f, -0.28f, 0.0f)
-  };
-  std::vector<glm::vec3> bluePositions = {
-      glm::vec3(0.38f, 0.38f, 0.0f), glm::vec3(0.28f, 0.38f, 0.0f),
-      glm::vec3(0.38f, 0.28f, 0.0f), glm::vec3(0.28f, 0.28f, 0.0f)
-  };
-
-  auto createFiguren = [&](const std::vector<glm::vec3>& positions, const glm::vec3& color) {
-    for (const auto &pos : positions) {
-        Figur* figur = new Figur();
-        // Setze den lokalen Transform als Translation
-        glm::mat4 local = glm::translate(glm::mat4(1.0f), pos);
-        local = glm::scale(local, glm::vec3(0.1f));  // Skaliere die Figur z. B. um den Faktor 0.3
-        figur->setLocalTransform(local);
-        figur->setColor(color);
-        g_figuren.push_back(figur);
-    }
-  };
-
-  createFiguren(redPositions, red);
-  createFiguren(greenPositions, green);
-  createFiguren(yellowPositions, yellow);
-  createFiguren(bluePositions, blue);
+  // Szene aufbauen: Kamera, Brett, Hintergrund und 16 Figuren
+  g_pcScene = new Scene();
+  g_pcScene->init(uiWidth, uiHeight);
 
   // set callback functions
   glfwSetWindowSizeCallback(pWindow, resizeCallback);           // set the callback in case of window resizing
   glfwSetKeyCallback(pWindow, keyboardCallback);                // set the callback for key presses
+  glfwSetMouseButtonCallback(pWindow, mouseButtonCallback);     // Figuren und Felder anklicken
 
   std::cout << "press q to quit" << std::endl;
   std::cout << "press k to turn left" << std::endl;
   std::cout << "press l to turn right" << std::endl;
   std::cout << "press a to turn forward" << std::endl;
   std::cout << "press y to turn backward" << std::endl;
+  std::cout << "press s to print render, mesh and texture statistics" << std::endl;
+  std::cout << "press d to toggle GL debug output" << std::endl;
+  std::cout << "press p to print pass timings, t to write them to trace.json" << std::endl;
+  std::cout << "click a piece or field to select it" << std::endl;
+
+  // Der Render-Thread übernimmt den Kontext: Der Hauptthread zeichnet nur noch Befehlslisten auf
+  // und verarbeitet Eingaben, während der vorige Frame gezeichnet wird und auf VSync wartet
+  RenderThread renderThread;
+  if (options.bRenderThread) {
+    glfwMakeContextCurrent(NULL);
+    renderThread.start([pWindow]() { glfwMakeContextCurrent(pWindow); }, []() { glfwMakeContextCurrent(NULL); });
+    g_pcRenderThread = &renderThread;
+  }
+
+  // Die Simulation läuft in festen Schritten nach der echten Zeit, gezeichnet wird so oft wie
+  // möglich (oder wie VSync erlaubt) zwischen den letzten beiden Schritten; nach einem langsamen
+  // Frame werden höchstens 5 Schritte nachgeholt, der Rest verfällt
+  FixedTimestep timestep(options.dTickRate, 5);
 
   // main loop for rendering and message parsing
   while (!glfwWindowShouldClose(pWindow))                       // Loop until the user closes the window
   {
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);         // Bildschirm leeren
-  
-   // Hintergrund rendern
-    glDisable(GL_DEPTH_TEST);  // Tiefentest deaktivieren, damit das Quad komplett sichtbar ist
-    glUseProgram(bgShaderProgram);
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, bgTexture);
-    int bgTexLoc = glGetUniformLocation(bgShaderProgram, "backgroundTexture");
-    glUniform1i(bgTexLoc, 0);
-    glBindVertexArray(quadVAO);
-    glDrawArrays(GL_TRIANGLES, 0, 6);
-    glBindVertexArray(0);
-    glEnable(GL_DEPTH_TEST);   // Tiefentest wieder aktivieren
-
-
-    g_pcBoard->render();  // Das Spielfeld rendern!
-    
-    // Aktualisiere und zeichne alle Figuren
-      glm::mat4 boardMatrix = g_pcBoard->getModelMatrix();
-      for (auto figur : g_figuren) {
-          // Berechne finale Modellmatrix = boardMatrix * (lokaler Transform der Figur)
-          figur->setModelMatrix(boardMatrix * figur->getLocalTransform());
-          figur->render();
+    const unsigned int uiTicks = timestep.advance();
+    for (unsigned int i = 0; i < uiTicks; i++)
+      g_pcScene->update((float)timestep.getStep());
+    g_pcScene->interpolate((float)timestep.getAlpha());
+
+    // aufzeichnen, dann auf dem Render-Thread (ohne Thread sofort) zeichnen und anzeigen
+    g_pcScene->renderAsync(renderThread, [pWindow, start, &bFirstFrame]() {
+      glfwSwapBuffers(pWindow);                               // swap front and back buffers
+      if (bFirstFrame) {                                      // Texturen laden asynchron, der erste Frame wartet nicht auf sie
+        bFirstFrame = false;
+        std::cout << "erster Frame nach " << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count()
+                  << " ms" << std::endl;
       }
-
-    
-
-    glfwSwapBuffers(pWindow);                                 // swap front and back buffers
+    });
+    g_pcScene->getProfiler().collect();                       // abgeschlossene Messungen übernehmen
 
     glfwPollEvents();                                         // process events
   }
 
-  
-  g_pcBoard->uninitGL();
-  
-  // Aufräumen
-  for (auto figur : g_figuren)
-    delete figur;
-  delete g_pcBoard;  // Spielfeld löschen
+  // Aufräumen: ausstehende Frames zeichnen, dann gehört der Kontext wieder dem Hauptthread
+  std::cout << "Simulation: " << timestep.getNumTicks() << " Schritte, " << timestep.getNumDroppedTicks()
+            << " verworfen" << std::endl;
+  if (options.bRenderThread) {
+    renderThread.stop();
+    g_pcRenderThread = nullptr;
+    glfwMakeContextCurrent(pWindow);
+    std::cout << "Render-Thread: " << renderThread.getNumFrames() << " Frames, "
+              << renderThread.getWaitMs() << " ms auf den Render-Thread gewartet" << std::endl;
+  }
+  delete g_pcScene;
+  g_pcScene = nullptr;
 
   glfwTerminate();  // end glfw library
 
   return 0;
 }
 
+int runHeadless(unsigned int uiWidth, unsigned int uiHeight, const HeadlessOptions& options)
+{
+  glfwSetErrorCallback(errorCallback);
+
+  HeadlessContext context;
+  if (!context.create(uiWidth, uiHeight)) {
+    std::cerr << "Fehler: Kein Offscreen-Kontext verfügbar (weder EGL noch verstecktes Fenster)!" << std::endl;
+    return -1;
+  }
+  gladLoadGLLoader(context.getProcAddress());
+  loadGLExtensions(context.getProcAddress());
+  GLDebug::init();
+  ShaderRegistry::get().setCacheDirectory("shadercache");
+
+  std::cout << "headless: " << context.getBackendName() << ", " << glGetString(GL_RENDERER)
+            << ", " << uiWidth << "x" << uiHeight << ", " << options.uiFrames << " frames" << std::endl;
+
+  // Ohne Fenster wird in einen eigenen Framebuffer gerendert
+  Framebuffer framebuffer;
+  if (framebuffer.create(uiWidth, uiHeight)) {
+    return -1;
+  }
+  framebuffer.bind();
+
+  if (!options.dumpDir.empty()) {
+    std::error_code err;
+    std::filesystem::create_directories(options.dumpDir, err);
+  }
+
+  g_pcScene = new Scene();
+  g_pcScene->init(uiWidth, uiHeight);
+  g_pcScene->finishLoading();  // gespeicherte Frames zeigen immer die fertigen Texturen
+  g_pcScene->getProfiler().setHistoryFrames(std::max(options.uiFrames, Profiler::DEFAULT_HISTORY_FRAMES));  // alle Frames auswerten
+
+  std::vector<unsigned char> pixels;
+  auto start = std::chrono::steady_clock::now();
+  for (unsigned int frame = 0; frame < options.uiFrames; frame++) {
+    // ohne Präsentation ungebremst: jeder Frame rechnet genau einen Schritt, unabhängig von
+    // der Zeit, die er braucht (gespeicherte Frames sind bei jedem Lauf gleich)
+    g_pcScene->update((float)(1.0 / options.dTickRate));
+    g_pcScene->interpolate(1.0f);
+    g_pcScene->render();
+    g_pcScene->getProfiler().collect();
+
+    if (!options.dumpDir.empty()) {
+      char name[32];
+      std::snprintf(name, sizeof(name), "/frame_%05u.png", frame);
+      framebuffer.readPixels(pixels);
+      savePNG(options.dumpDir + name, pixels, uiWidth, uiHeight);
+    }
+  }
+  glFinish();  // auf die GPU warten, sonst misst man nur das Einreihen der Befehle
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  const RenderQueueStats& stats = g_pcScene->getStats();
+  std::cout << "headless: " << options.uiFrames << " frames in " << seconds << " s, "
+            << (seconds > 0.0 ? options.uiFrames / seconds : 0.0) << " fps, "
+            << (options.uiFrames ? 1000.0 * seconds / options.uiFrames : 0.0) << " ms/frame, "
+            << stats.uiDrawCalls << " draw calls/frame" << std::endl;
+
+  // ausstehende GPU-Zeiten abholen und Perzentile je Pass ausgeben
+  Profiler& profiler = g_pcScene->getProfiler();
+  profiler.flush();
+  profiler.collect();
+  profiler.printSummary(std::cout);
+  g_pcScene->getFrameGraph().printOrder(std::cout);
+  MeshLibrary::get().printStats(std::cout);
+  if (!options.traceFile.empty() && !profiler.writeChromeTrace(options.traceFile)) {
+    std::cout << "trace: " << options.traceFile << std::endl;
+  }
+
+  delete g_pcScene;
+  g_pcScene = nullptr;
+  framebuffer.destroy();
+  context.destroy();
+
+  return 0;
+}
+
 void errorCallback(int iError, const char* pcDescription) {
   std::cerr << "GLFW Fehler: " << pcDescription << std::endl;
 }
 
 void resizeCallback(GLFWwindow* pWindow, int width, int height) {
-  if (g_pcBoard) {
-    g_pcBoard->setWindowSize(width, height);
+  // Viewport und Seitenverhältnis der Projektion anpassen
+  if (g_pcScene) {
+    g_pcScene->resize(width, height);
   }
 }
 
 void keyboardCallback(GLFWwindow* pWindow, int iKey, int iScancode, int iAction, int iMods) {
+  Board* pcBoard = g_pcScene ? g_pcScene->getBoard() : nullptr;
+
+  // Drehtasten (A/Z um die X-Achse, K/L um die Y-Achse): Drücken und Loslassen setzen nur die
+  // Geschwindigkeit, die Tastenwiederholung wird ignoriert
+  const int aiRotateKeys[4] = { GLFW_KEY_A, GLFW_KEY_Z, GLFW_KEY_K, GLFW_KEY_L };
+  for (int i = 0; i < 4; i++) {
+    if (iKey != aiRotateKeys[i])
+      continue;
+    if (iAction != GLFW_REPEAT)
+      g_abRotateKeys[i] = iAction == GLFW_PRESS;
+    if (pcBoard)
+      pcBoard->setSpin(ROTATION_SPEED * (g_abRotateKeys[0] - g_abRotateKeys[1]),
+                       ROTATION_SPEED * (g_abRotateKeys[2] - g_abRotateKeys[3]));
+    return;
+  }
+
   if (iAction == GLFW_PRESS || iAction == GLFW_REPEAT) {
     switch (iKey) {
         case GLFW_KEY_Q:
                 glfwSetWindowShouldClose(pWindow, GLFW_TRUE);
         break;
-        case GLFW_KEY_A: // Rotieren um X-Achse nach oben
-          if (g_pcBoard) g_pcBoard->rotX(2.0f);
+        case GLFW_KEY_S: // Statistik der Render-Queue (letzter Frame) ausgeben
+        {
+          if (g_pcRenderThread) g_pcRenderThread->finish();  // die Statistik gehört dem Render-Thread
+          const RenderQueueStats& stats = g_pcScene->getStats();
+          std::cout << "Render-Queue: " << stats.uiItems << " Items, " << stats.uiDrawCalls << " Draw-Calls, "
+                    << stats.uiStateChanges << " Zustandswechsel, " << stats.uiSavedStateChanges
+                    << " eingespart" << std::endl;
+          std::cout << "Befehlslisten: " << g_pcScene->getNumRecordedCommands() << " Befehle, "
+                    << g_pcScene->getRecordedBytes() << " Bytes Daten" << std::endl;
+          MeshLibrary::get().printStats(std::cout);
+          TextureManager::get().printStats(std::cout);
+        }
+        break;
+        case GLFW_KEY_P: // Zeiten je Pass (Perzentile über die letzten Frames, siehe Profiler::setHistoryFrames)
+          if (g_pcScene) g_pcScene->getProfiler().printSummary(std::cout);
+        break;
+        case GLFW_KEY_T: // Zeiten als Chrome-Trace speichern (chrome://tracing oder Perfetto)
+          if (g_pcScene && !g_pcScene->getProfiler().writeChromeTrace("trace.json"))
+            std::cout << "Trace gespeichert: trace.json" << std::endl;
         break;
-        case GLFW_KEY_Z: // Rotieren um X-Achse nach unten
-          if (g_pcBoard) g_pcBoard->rotX(-2.0f);
+        case GLFW_KEY_D: // GL-Debugausgabe zur Laufzeit umschalten (GL-Aufruf, also auf dem Render-Thread)
+          if (g_pcRenderThread) {
+            g_pcRenderThread->submit([]() { GLDebug::setEnabled(!GLDebug::isEnabled()); });
+            g_pcRenderThread->finish();
+          }
+          else {
+            GLDebug::setEnabled(!GLDebug::isEnabled());
+          }
+          std::cout << "GL-Debugausgabe " << (GLDebug::isEnabled() ? "an" : "aus")
+                    << (GLDebug::hasCallback() ? "" : " (kein Debug-Callback verfügbar)") << std::endl;
         break;
-        case GLFW_KEY_K: // Rotieren um Y-Achse nach links
-          if (g_pcBoard) g_pcBoard->rotY(2.0f);
+        case GLFW_KEY_1: case GLFW_KEY_2: case GLFW_KEY_3:
+        case GLFW_KEY_4: case GLFW_KEY_5: case GLFW_KEY_6: // angeklickte Figur ziehen
+          if (iAction == GLFW_PRESS && g_pcScene && g_iSelectedPiece >= 0) {
+            if (g_pcScene->movePiece(g_iSelectedPiece, iKey - GLFW_KEY_0))
+              std::cout << "Figur " << g_iSelectedPiece << " zieht auf Feld " << g_pcScene->getPieceField(g_iSelectedPiece) << std::endl;
+            else
+              std::cout << "Zug nicht möglich" << std::endl;
+          }
         break;
-        case GLFW_KEY_L: // Rotieren um Y-Achse nach rechts
-          if (g_pcBoard) g_pcBoard->rotY(-2.0f);
+        case GLFW_KEY_M: // zufälliger Zug einer zufälligen Figur
+          if (g_pcScene && g_pcScene->getNumPieces() > 0) {
+            for (int iTry = 0; iTry < 16; iTry++) {
+              const int iPiece = std::rand() % (int)g_pcScene->getNumPieces();
+              if (g_pcScene->movePiece(iPiece, 1 + std::rand() % 6))
+                break;
+            }
+          }
         break;
         default:
-          if (g_pcBoard) g_pcBoard->keyPressed(iKey);
+          if (pcBoard) pcBoard->keyPressed(iKey);
         break;
     }
   }
-}
\ No newline at end of file
+}
+
+void mouseButtonCallback(GLFWwindow* pWindow, int iButton, int iAction, int iMods) {
+  if (!g_pcScene || iButton != GLFW_MOUSE_BUTTON_LEFT || iAction != GLFW_PRESS)
+    return;
+
+  // Strahl durch den Mauszeiger, getestet wird auf der CPU (der Render-Thread läuft weiter)
+  double dX, dY;
+  glfwGetCursorPos(pWindow, &dX, &dY);
+  const auto start = std::chrono::steady_clock::now();
+  const PickResult result = g_pcScene->pick((float)dX, (float)dY);
+  const double dMicroseconds = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+  if (result.type == PickResult::PIECE) {
+    g_iSelectedPiece = result.piece;
+    std::cout << "Figur " << result.piece << " auf Brett " << result.board;
+  }
+  else if (result.type == PickResult::FIELD) {
+    static const char* names[3] = { "Bahn", "Haus", "Ziel" };
+    std::cout << "Feld " << result.field << " (" << names[BoardLayout::getType(result.field)] << ") auf Brett " << result.board;
+  }
+  else {
+    std::cout << "kein Treffer";
+  }
+  std::cout << " (" << dMicroseconds << " us)" << std::endl;
+}
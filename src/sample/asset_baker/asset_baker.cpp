@@ -0,0 +1,189 @@
+// Asset-Baker: wandelt ein Bild (JPEG, PNG, ...) offline in einen Textur-Container (.btex)
+// mit vollständiger Mip-Kette um, blockkomprimiert (BC1 bzw. BC4 für Graustufen) und
+// zusätzlich unkomprimiert als Rückfall für Treiber ohne S3TC. Zur Laufzeit wird die Datei
+// nur noch gemappt und hochgeladen, ohne JPEG-Dekodierung und glGenerateMipmap.
+#include "stb/stb_image.h"
+
+#include "GLRender/TextureContainer.h"
+#include "GLRender/TextureEncoder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct BakeOptions
+{
+  std::string input;
+  std::string output;
+  bool flip = false;             // Zeilen umdrehen (Bildursprung unten links wie bei OpenGL)
+  bool mips = true;
+  float maxRmse = 0.0f;          // Blockkompression verwerfen, wenn der Fehler größer ist (0: immer)
+  std::vector<std::string> formats;  // leer: Standard je nach Kanalzahl
+};
+
+void printUsage(const char* pcName)
+{
+  std::cout << "usage: " << pcName << " [--flip] [--no-mips] [--formats LIST] [--max-rmse E] INPUT OUTPUT" << std::endl;
+  std::cout << "  --flip          flip the image vertically (origin bottom left)" << std::endl;
+  std::cout << "  --no-mips       only store the base level" << std::endl;
+  std::cout << "  --formats LIST  comma separated encodings in order of preference:" << std::endl;
+  std::cout << "                  bc1, rgba8 (colour), bc4, r8 (grey scale)" << std::endl;
+  std::cout << "                  default bc1,rgba8 or bc4,r8 for grey scale images" << std::endl;
+  std::cout << "  --max-rmse E    drop a block compressed encoding whose error (RMSE of level 0," << std::endl;
+  std::cout << "                  8 bit units) exceeds E, e.g. for sharp edged artwork" << std::endl;
+}
+
+bool parseFormat(const std::string& name, TextureContainer::Format& format)
+{
+  if (name == "rgba8") format = TextureContainer::FORMAT_RGBA8;
+  else if (name == "r8") format = TextureContainer::FORMAT_R8;
+  else if (name == "bc1") format = TextureContainer::FORMAT_BC1;
+  else if (name == "bc4") format = TextureContainer::FORMAT_BC4;
+  else return false;
+  return true;
+}
+
+bool isGreyFormat(TextureContainer::Format format)
+{
+  return format == TextureContainer::FORMAT_R8 || format == TextureContainer::FORMAT_BC4;
+}
+
+int main(int argc, char* argv[])
+{
+  BakeOptions options;
+  std::vector<std::string> files;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "--flip") {
+      options.flip = true;
+    }
+    else if (arg == "--no-mips") {
+      options.mips = false;
+    }
+    else if (arg == "--formats" && i + 1 < argc) {
+      std::istringstream list(argv[++i]);
+      std::string name;
+      while (std::getline(list, name, ','))
+        options.formats.push_back(name);
+    }
+    else if (arg == "--max-rmse" && i + 1 < argc) {
+      options.maxRmse = (float)std::atof(argv[++i]);
+    }
+    else if (arg.size() > 1 && arg[0] == '-') {
+      printUsage(argv[0]);
+      return arg == "--help" ? 0 : -1;
+    }
+    else {
+      files.push_back(arg);
+    }
+  }
+  if (files.size() != 2) {
+    printUsage(argv[0]);
+    return -1;
+  }
+  options.input = files[0];
+  options.output = files[1];
+
+  auto start = std::chrono::steady_clock::now();
+
+  // Quelle laden: Graustufen bleiben einkanalig, alles andere wird RGBA
+  int width, height, channels;
+  if (!stbi_info(options.input.c_str(), &width, &height, &channels)) {
+    std::cerr << "Fehler: " << options.input << " konnte nicht gelesen werden: " << stbi_failure_reason() << std::endl;
+    return -1;
+  }
+  const bool grey = channels == 1;
+  const unsigned int outChannels = grey ? 1 : 4;
+  stbi_set_flip_vertically_on_load(options.flip);
+  unsigned char* data = stbi_load(options.input.c_str(), &width, &height, &channels, outChannels);
+  if (!data) {
+    std::cerr << "Fehler: " << options.input << " konnte nicht dekodiert werden: " << stbi_failure_reason() << std::endl;
+    return -1;
+  }
+
+  if (options.formats.empty()) {
+    options.formats = grey ? std::vector<std::string>{ "bc4", "r8" } : std::vector<std::string>{ "bc1", "rgba8" };
+  }
+
+  // BC1 ohne Alpha verliert Transparenz, dann nur unkomprimiert speichern
+  bool translucent = false;
+  if (channels == 4) {
+    for (size_t i = 3; i < (size_t)width * height * 4 && !translucent; i += 4)
+      translucent = data[i] != 255;
+  }
+
+  // Mip-Kette einmal erzeugen, alle Kodierungen teilen sie
+  std::vector<std::vector<unsigned char>> levels(1);
+  std::vector<unsigned int> widths(1, width), heights(1, height);
+  levels[0].assign(data, data + (size_t)width * height * outChannels);
+  stbi_image_free(data);
+  while (options.mips && (widths.back() > 1 || heights.back() > 1)) {
+    std::vector<unsigned char> next;
+    TextureEncoder::downsample(levels.back(), widths.back(), heights.back(), outChannels, next);
+    levels.push_back(std::move(next));
+    widths.push_back(std::max(widths.back() / 2, 1u));
+    heights.push_back(std::max(heights.back() / 2, 1u));
+  }
+
+  std::vector<TextureContainerImage> images;
+  for (const std::string& name : options.formats) {
+    TextureContainer::Format format;
+    if (!parseFormat(name, format)) {
+      std::cerr << "Fehler: unbekanntes Format " << name << std::endl;
+      return -1;
+    }
+    if (isGreyFormat(format) != grey) {
+      std::cerr << "Hinweis: " << name << " passt nicht zur Kanalzahl von " << options.input << ", übersprungen" << std::endl;
+      continue;
+    }
+    if (format == TextureContainer::FORMAT_BC1 && translucent) {
+      std::cerr << "Hinweis: " << options.input << " ist transparent, BC1 übersprungen" << std::endl;
+      continue;
+    }
+
+    TextureContainerImage image;
+    image.uiFormat = format;
+    image.cLevels.resize(levels.size());
+    float rmse = 0.0f;
+    for (size_t level = 0; level < levels.size(); level++) {
+      float error = 0.0f;
+      if (format == TextureContainer::FORMAT_BC1)
+        error = TextureEncoder::encodeBC1(levels[level], widths[level], heights[level], image.cLevels[level]);
+      else if (format == TextureContainer::FORMAT_BC4)
+        error = TextureEncoder::encodeBC4(levels[level], widths[level], heights[level], image.cLevels[level]);
+      else
+        image.cLevels[level] = levels[level];
+      if (level == 0) rmse = error;
+    }
+    if (options.maxRmse > 0.0f && rmse > options.maxRmse) {
+      std::cerr << "Hinweis: " << name << " für " << options.input << " zu ungenau (RMSE " << rmse << "), übersprungen" << std::endl;
+      continue;
+    }
+    images.push_back(std::move(image));
+  }
+  if (images.empty()) {
+    std::cerr << "Fehler: keine passende Kodierung für " << options.input << std::endl;
+    return -1;
+  }
+
+  if (TextureContainer::write(options.output, width, height, images)) {
+    std::cerr << "Fehler: " << options.output << " konnte nicht geschrieben werden" << std::endl;
+    return -1;
+  }
+
+  const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  std::cout << options.output << ": " << width << "x" << height << ", " << levels.size() << " Mip-Stufen,";
+  for (const TextureContainerImage& image : images) {
+    size_t bytes = 0;
+    for (const auto& level : image.cLevels) bytes += level.size();
+    std::cout << " " << TextureContainer::getFormatName((TextureContainer::Format)image.uiFormat) << " " << bytes << " Bytes";
+  }
+  std::cout << " (" << ms << " ms)" << std::endl;
+
+  return 0;
+}
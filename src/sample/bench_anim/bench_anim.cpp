@@ -0,0 +1,199 @@
+// Animations-Benchmark: lässt N Figuren gleichzeitig über Bretter springen (jede beendete
+// Animation startet sofort einen neuen Zug, jeder achte mit Rückwurf ins Haus), misst
+// update() und interpolate() des TweenSystems je Simulationsschritt mit und ohne SSE, prüft
+// die Positionen gegen die skalare Version und gibt die Zeiten als JSON aus.
+#include "GLRender/TweenSystem.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct BenchOptions
+{
+  unsigned int uiAnimations = 50000;  // gleichzeitige Animationen
+  unsigned int uiTicks = 600;         // Simulationsschritte (10 s bei 60 Hz)
+  std::string outFile;                // JSON zusätzlich in eine Datei schreiben
+};
+
+void printUsage(const char* pcName)
+{
+  std::cout << "usage: " << pcName << " [--animations N] [--ticks N] [--out FILE]" << std::endl;
+  std::cout << "  --animations N  concurrent animations (default 50000)" << std::endl;
+  std::cout << "  --ticks N       simulation ticks at 60 Hz (default 600)" << std::endl;
+  std::cout << "  --out FILE      also write the JSON result to FILE" << std::endl;
+}
+
+// Perzentil (nearest rank) einer sortierten Liste
+double percentile(const std::vector<double>& sorted, double p)
+{
+  if (sorted.empty()) return 0.0;
+  size_t rank = (size_t)std::ceil(p * sorted.size());
+  return sorted[std::min(rank > 0 ? rank - 1 : 0, sorted.size() - 1)];
+}
+
+// Züge wie im Spiel: 1 bis 6 Sprünge von 0,18 s zwischen Feldern im Abstand 0,08, bei jedem
+// achten Zug zusätzlich ein Flug von 0,6 s zurück ins Haus (einfacher LCG, reproduzierbar)
+class MoveGenerator
+{
+public:
+  MoveGenerator() : seed(12345u) {}
+
+  void start(TweenSystem& tweens, uint32_t user, const float* from, float delay = 0.0f)
+  {
+    keys.clear();
+    float pos[3] = { from[0], from[1], 0.0f };
+    if (delay > 0.0f)
+      keys.push_back({ { pos[0], pos[1], pos[2] }, delay, 0.0f });
+    const unsigned int hops = 1 + next() % 6;
+    for (unsigned int i = 0; i < hops; i++) {
+      // ein Feld weiter, am Rand des Bretts umkehren
+      const int axis = next() % 2;
+      pos[axis] += (next() % 2 ? 0.08f : -0.08f);
+      pos[axis] = std::max(-0.4f, std::min(0.4f, pos[axis]));
+      keys.push_back({ { pos[0], pos[1], pos[2] }, 0.18f, 0.05f });
+    }
+    if (next() % 8 == 0) {
+      keys.push_back({ { pos[0], pos[1], pos[2] }, 0.1f, 0.0f });  // warten
+      keys.push_back({ { -0.38f, 0.38f, 0.0f }, 0.6f, 0.3f });
+    }
+    tweens.start(user, from, keys.data(), keys.size());
+  }
+
+private:
+  unsigned int next()
+  {
+    seed = seed * 1664525u + 1013904223u;
+    return seed >> 8;
+  }
+
+  unsigned int seed;
+  std::vector<TweenSystem::Keyframe> keys;
+};
+
+struct RunResult
+{
+  std::vector<double> updateMs, interpolateMs;
+  double activeAvg = 0.0;
+  unsigned long long retired = 0;
+  std::vector<float> finalX, finalZ;   // gezeichnete Lage nach dem letzten Schritt, nach Nutzer
+};
+
+RunResult run(const BenchOptions& options, bool simd)
+{
+  TweenSystem tweens;
+  tweens.setSimd(simd);
+  MoveGenerator moves;
+  RunResult result;
+
+  for (uint32_t user = 0; user < options.uiAnimations; user++) {
+    const float from[3] = { ((user % 11) - 5) * 0.08f, (((user / 11) % 11) - 5) * 0.08f, 0.0f };
+    // verschieden lange Wartezeit am Anfang, damit nicht alle Partien im selben Schritt landen
+    moves.start(tweens, user, from, (user % 64) / 64.0f);
+  }
+
+  unsigned long long active = 0;
+  for (unsigned int tick = 0; tick < options.uiTicks; tick++) {
+    auto start = std::chrono::steady_clock::now();
+    tweens.update(1.0f / 60.0f);
+    auto mid = std::chrono::steady_clock::now();
+    tweens.interpolate(0.5f);
+    auto end = std::chrono::steady_clock::now();
+    result.updateMs.push_back(std::chrono::duration<double, std::milli>(mid - start).count());
+    result.interpolateMs.push_back(std::chrono::duration<double, std::milli>(end - mid).count());
+    active += tweens.getNumActive();
+
+    // beendete Figuren ziehen sofort weiter (nicht gemessen, das Spiel entscheidet hier)
+    result.retired += tweens.getRetired().size();
+    for (const TweenSystem::Retired& retired : tweens.getRetired())
+      moves.start(tweens, retired.uiUser, retired.afPos);
+  }
+  result.activeAvg = (double)active / options.uiTicks;
+
+  result.finalX.assign(options.uiAnimations, 0.0f);
+  result.finalZ.assign(options.uiAnimations, 0.0f);
+  for (size_t i = 0; i < tweens.size(); i++) {
+    if (tweens.getUsers()[i] == TweenSystem::NO_USER)
+      continue;
+    result.finalX[tweens.getUsers()[i]] = tweens.getDrawX()[i];
+    result.finalZ[tweens.getUsers()[i]] = tweens.getDrawZ()[i];
+  }
+
+  std::sort(result.updateMs.begin(), result.updateMs.end());
+  std::sort(result.interpolateMs.begin(), result.interpolateMs.end());
+  return result;
+}
+
+int main(int argc, char* argv[])
+{
+  BenchOptions options;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "--animations" && i + 1 < argc) {
+      options.uiAnimations = std::max(1u, (unsigned int)std::strtoul(argv[++i], nullptr, 10));
+    }
+    else if (arg == "--ticks" && i + 1 < argc) {
+      options.uiTicks = std::max(1u, (unsigned int)std::strtoul(argv[++i], nullptr, 10));
+    }
+    else if (arg == "--out" && i + 1 < argc) {
+      options.outFile = argv[++i];
+    }
+    else {
+      printUsage(argv[0]);
+      return arg == "--help" ? 0 : -1;
+    }
+  }
+
+  std::vector<RunResult> results;
+  std::vector<std::string> names;
+  results.push_back(run(options, false));
+  names.push_back("scalar");
+  if (TweenSystem::hasSimd()) {
+    results.push_back(run(options, true));
+    names.push_back("sse");
+  }
+
+  // SSE rechnet dieselben Operationen in derselben Reihenfolge, erlaubt ist nur Rundung
+  bool mismatch = false;
+  for (size_t r = 1; r < results.size(); r++) {
+    for (size_t i = 0; i < options.uiAnimations; i++) {
+      if (std::fabs(results[r].finalX[i] - results[0].finalX[i]) > 1e-4f ||
+          std::fabs(results[r].finalZ[i] - results[0].finalZ[i]) > 1e-4f) {
+        std::cerr << "Fehler: Animation " << i << " (" << names[r] << ") weicht von der skalaren Version ab" << std::endl;
+        mismatch = true;
+        break;
+      }
+    }
+  }
+
+  std::ostringstream json;
+  json << "{" << std::endl;
+  json << "  \"animations\": " << options.uiAnimations << ", \"ticks\": " << options.uiTicks << "," << std::endl;
+  json << "  \"kernels\": {";
+  for (size_t r = 0; r < results.size(); r++) {
+    const RunResult& result = results[r];
+    json << (r ? "," : "") << std::endl << "    \"" << names[r] << "\": { \"update_ms\": { \"p50\": "
+         << percentile(result.updateMs, 0.50) << ", \"p99\": " << percentile(result.updateMs, 0.99)
+         << " }, \"interpolate_ms\": { \"p50\": " << percentile(result.interpolateMs, 0.50) << ", \"p99\": "
+         << percentile(result.interpolateMs, 0.99) << " }, \"active_avg\": " << result.activeAvg
+         << ", \"retired\": " << result.retired << " }";
+  }
+  json << std::endl << "  }" << std::endl << "}" << std::endl;
+
+  std::cout << json.str();
+  if (!options.outFile.empty()) {
+    std::ofstream out(options.outFile, std::ios::trunc);
+    out << json.str();
+    if (!out) {
+      std::cerr << "Fehler: " << options.outFile << " konnte nicht geschrieben werden" << std::endl;
+    }
+  }
+
+  return mismatch ? -1 : 0;
+}
@@ -0,0 +1,135 @@
+// Pixel-Benchmark: misst die Umwandlungen nach dem Dekodieren (RGB -> RGBA, Rot/Blau
+// tauschen, vormultipliziertes Alpha, vertikal spiegeln) für jeden Befehlssatz, den die
+// CPU unterstützt, prüft die Ergebnisse gegen die skalare Version und gibt GB/s als JSON aus.
+#include "GLRender/PixelConvert.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct BenchOptions
+{
+  unsigned int uiWidth = 4096;       // Bildgröße (z. B. eine große Brett-Textur)
+  unsigned int uiHeight = 4096;
+  unsigned int uiIterations = 20;    // Wiederholungen, gemeldet wird die schnellste
+  std::string outFile;               // JSON zusätzlich in eine Datei schreiben
+};
+
+void printUsage(const char* pcName)
+{
+  std::cout << "usage: " << pcName << " [--size WxH] [--iterations N] [--out FILE]" << std::endl;
+  std::cout << "  --size WxH      image size (default 4096x4096)" << std::endl;
+  std::cout << "  --iterations N  runs per kernel, the fastest is reported (default 20)" << std::endl;
+  std::cout << "  --out FILE      also write the JSON result to FILE" << std::endl;
+}
+
+// schnellster Lauf in Millisekunden; prepare setzt die Eingabe vor jedem Lauf zurück
+double measure(unsigned int iterations, const std::function<void()>& prepare, const std::function<void()>& run)
+{
+  double best = 1e30;
+  for (unsigned int i = 0; i < iterations; i++) {
+    prepare();
+    auto start = std::chrono::steady_clock::now();
+    run();
+    best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+  }
+  return best;
+}
+
+int main(int argc, char* argv[])
+{
+  BenchOptions options;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "--size" && i + 1 < argc) {
+      if (std::sscanf(argv[++i], "%ux%u", &options.uiWidth, &options.uiHeight) != 2 || !options.uiWidth || !options.uiHeight) {
+        std::cerr << "Fehler: ungültige Größe " << argv[i] << std::endl;
+        return -1;
+      }
+    }
+    else if (arg == "--iterations" && i + 1 < argc) {
+      options.uiIterations = std::max(1u, (unsigned int)std::strtoul(argv[++i], nullptr, 10));
+    }
+    else if (arg == "--out" && i + 1 < argc) {
+      options.outFile = argv[++i];
+    }
+    else {
+      printUsage(argv[0]);
+      return arg == "--help" ? 0 : -1;
+    }
+  }
+
+  const size_t pixels = (size_t)options.uiWidth * options.uiHeight;
+
+  // reproduzierbares Rauschen als Eingabe (einfacher LCG)
+  std::vector<unsigned char> rgb(pixels * 3), rgba(pixels * 4);
+  unsigned int seed = 12345u;
+  for (auto& value : rgb) { seed = seed * 1664525u + 1013904223u; value = (unsigned char)(seed >> 24); }
+  for (auto& value : rgba) { seed = seed * 1664525u + 1013904223u; value = (unsigned char)(seed >> 24); }
+
+  std::vector<unsigned char> work(pixels * 4);
+  std::vector<unsigned char> reference[4];   // Ergebnisse der skalaren Version je Kernel
+  const char* kernels[4] = { "expand_rgb_rgba", "swap_red_blue", "premultiply_alpha", "flip_rows" };
+  const double bytes[4] = { pixels * 7.0, pixels * 8.0, pixels * 8.0, pixels * 8.0 };  // gelesen + geschrieben
+
+  std::ostringstream json;
+  json << "{" << std::endl;
+  json << "  \"width\": " << options.uiWidth << ", \"height\": " << options.uiHeight << "," << std::endl;
+  json << "  \"iterations\": " << options.uiIterations << "," << std::endl;
+  json << "  \"supported_isa\": \"" << PixelConvert::getIsaName(PixelConvert::getSupportedIsa()) << "\"," << std::endl;
+  json << "  \"kernels\": {";
+
+  bool mismatch = false;
+  for (int isa = PixelConvert::ISA_SCALAR; isa <= PixelConvert::getSupportedIsa(); isa++) {
+    PixelConvert::setIsa((PixelConvert::Isa)isa);
+
+    double ms[4];
+    ms[0] = measure(options.uiIterations, []() {},
+                    [&]() { PixelConvert::expandRGBToRGBA(rgb.data(), work.data(), pixels); });
+    std::vector<unsigned char> results[4];
+    results[0] = work;
+    ms[1] = measure(options.uiIterations, []() {},
+                    [&]() { PixelConvert::swapRedBlue(rgba.data(), work.data(), pixels); });
+    results[1] = work;
+    ms[2] = measure(options.uiIterations, [&]() { work = rgba; },
+                    [&]() { PixelConvert::premultiplyAlpha(work.data(), pixels); });
+    results[2] = work;
+    ms[3] = measure(options.uiIterations, [&]() { work = rgba; },
+                    [&]() { PixelConvert::flipRows(work.data(), (size_t)options.uiWidth * 4, options.uiHeight); });
+    results[3] = work;
+
+    json << (isa ? "," : "") << std::endl << "    \"" << PixelConvert::getIsaName((PixelConvert::Isa)isa) << "\": {";
+    for (int k = 0; k < 4; k++) {
+      if (isa == PixelConvert::ISA_SCALAR) {
+        reference[k] = results[k];
+      }
+      else if (results[k] != reference[k]) {
+        std::cerr << "Fehler: " << kernels[k] << " (" << PixelConvert::getIsaName((PixelConvert::Isa)isa)
+                  << ") weicht von der skalaren Version ab" << std::endl;
+        mismatch = true;
+      }
+      json << (k ? "," : "") << std::endl << "      \"" << kernels[k] << "\": { \"ms\": " << ms[k]
+           << ", \"gb_per_s\": " << bytes[k] / (ms[k] * 1e6) << " }";
+    }
+    json << std::endl << "    }";
+  }
+  json << std::endl << "  }" << std::endl << "}" << std::endl;
+
+  std::cout << json.str();
+  if (!options.outFile.empty()) {
+    std::ofstream out(options.outFile, std::ios::trunc);
+    out << json.str();
+    if (!out) {
+      std::cerr << "Fehler: " << options.outFile << " konnte nicht geschrieben werden" << std::endl;
+    }
+  }
+
+  return mismatch ? -1 : 0;
+}
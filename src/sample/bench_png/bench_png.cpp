@@ -0,0 +1,234 @@
+// PNG-Benchmark: dekodiert einen Satz PNG-Dateien mit dem bitweisen Huffman-Dekoder von
+// lodepng und mit dem tabellengesteuerten (fast_inflate), prüft, dass beide dieselben Pixel
+// liefern, und gibt den Durchsatz je Datei und insgesamt als JSON aus. Ohne Dateien wird ein
+// kleiner Satz Bilder (Screenshot, Skin, Rauschen) im Speicher erzeugt.
+#include "GLRender/Common.h"
+#include "GLRender/lodepng.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct BenchOptions
+{
+  std::vector<std::string> inputs;   // PNG-Dateien oder Verzeichnisse
+  unsigned int uiWidth = 1920;       // Größe der erzeugten Bilder
+  unsigned int uiHeight = 1080;
+  unsigned int uiIterations = 5;     // Wiederholungen, gemeldet wird die schnellste
+  std::string outFile;               // JSON zusätzlich in eine Datei schreiben
+};
+
+struct CorpusEntry
+{
+  std::string name;
+  std::vector<unsigned char> png;
+};
+
+void printUsage(const char* pcName)
+{
+  std::cout << "usage: " << pcName << " [--size WxH] [--iterations N] [--out FILE] [FILE|DIR ...]" << std::endl;
+  std::cout << "  FILE|DIR        PNG files, directories are searched for *.png (default: generated images)" << std::endl;
+  std::cout << "  --size WxH      size of the generated images (default 1920x1080)" << std::endl;
+  std::cout << "  --iterations N  decodes per file and decoder, the fastest is reported (default 5)" << std::endl;
+  std::cout << "  --out FILE      also write the JSON result to FILE" << std::endl;
+}
+
+// reproduzierbare Testbilder: ein Screenshot-ähnliches Bild (Verläufe, Flächen, Kanten), eine
+// Skin-Textur (Muster mit leichtem Rauschen) und reines Rauschen als schlechtester Fall
+void generateCorpus(unsigned int w, unsigned int h, std::vector<CorpusEntry>& corpus)
+{
+  std::vector<unsigned char> image((size_t)w * h * 4);
+  unsigned int seed = 12345u;
+  auto random = [&seed]() { seed = seed * 1664525u + 1013904223u; return seed >> 24; };
+
+  for (int kind = 0; kind < 3; kind++) {
+    for (unsigned int y = 0; y < h; y++) {
+      for (unsigned int x = 0; x < w; x++) {
+        unsigned char* px = &image[((size_t)y * w + x) * 4];
+        if (kind == 0) {
+          bool field = ((x / 64) + (y / 64)) % 5 == 0 && (x % 64) > 8 && (y % 64) > 8;
+          px[0] = field ? 200 : (unsigned char)(40 + y * 60 / h);
+          px[1] = field ? 30 : (unsigned char)(52 + y * 40 / h);
+          px[2] = field ? 30 : (unsigned char)(72 + x * 50 / w);
+          px[3] = 255;
+        }
+        else if (kind == 1) {
+          unsigned int noise = random() & 15;
+          px[0] = (unsigned char)(180 + ((x / 16 + y / 16) & 1) * 40 + noise);
+          px[1] = (unsigned char)(150 + ((x / 32) & 1) * 30 + noise);
+          px[2] = (unsigned char)(100 + noise);
+          px[3] = (unsigned char)((x * y) % 7 ? 255 : 128);
+        }
+        else {
+          px[0] = (unsigned char)random();
+          px[1] = (unsigned char)random();
+          px[2] = (unsigned char)random();
+          px[3] = 255;
+        }
+      }
+    }
+    static const char* names[3] = { "generated_screenshot", "generated_skin", "generated_noise" };
+    CorpusEntry entry;
+    entry.name = names[kind];
+    unsigned int error = lodepng::encode(entry.png, image, w, h);
+    if (error) {
+      std::cerr << "Fehler: " << entry.name << " konnte nicht kodiert werden: " << lodepng_error_text(error) << std::endl;
+      continue;
+    }
+    corpus.push_back(entry);
+  }
+}
+
+bool loadCorpus(const std::vector<std::string>& inputs, std::vector<CorpusEntry>& corpus)
+{
+  std::vector<std::string> files;
+  for (const std::string& input : inputs) {
+    std::error_code error;
+    if (std::filesystem::is_directory(input, error)) {
+      for (const auto& item : std::filesystem::recursive_directory_iterator(input, error)) {
+        std::string extension = item.path().extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+        if (item.is_regular_file() && extension == ".png") files.push_back(item.path().string());
+      }
+    }
+    else {
+      files.push_back(input);
+    }
+  }
+  std::sort(files.begin(), files.end());
+
+  for (const std::string& file : files) {
+    CorpusEntry entry;
+    entry.name = file;
+    lodepng::load_file(entry.png, file);
+    if (entry.png.empty()) {
+      std::cerr << "Fehler: " << file << " konnte nicht gelesen werden" << std::endl;
+      return false;
+    }
+    corpus.push_back(entry);
+  }
+  return true;
+}
+
+// schnellste Dekodierung in Millisekunden, das Ergebnis landet in pixels
+double measure(const CorpusEntry& entry, unsigned int fastInflate, unsigned int iterations,
+               std::vector<unsigned char>& pixels, unsigned int& error)
+{
+  double best = 1e30;
+  for (unsigned int i = 0; i < iterations; i++) {
+    lodepng::State state;
+    state.decoder.zlibsettings.fast_inflate = fastInflate;
+    unsigned int w = 0, h = 0;
+    pixels.clear();
+    auto start = std::chrono::steady_clock::now();
+    error = lodepng::decode(pixels, w, h, state, entry.png);
+    best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    if (error) break;
+  }
+  return best;
+}
+
+int main(int argc, char* argv[])
+{
+  BenchOptions options;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "--size" && i + 1 < argc) {
+      if (std::sscanf(argv[++i], "%ux%u", &options.uiWidth, &options.uiHeight) != 2 || !options.uiWidth || !options.uiHeight) {
+        std::cerr << "Fehler: ungültige Größe " << argv[i] << std::endl;
+        return -1;
+      }
+    }
+    else if (arg == "--iterations" && i + 1 < argc) {
+      options.uiIterations = std::max(1u, (unsigned int)std::strtoul(argv[++i], nullptr, 10));
+    }
+    else if (arg == "--out" && i + 1 < argc) {
+      options.outFile = argv[++i];
+    }
+    else if (!arg.empty() && arg[0] != '-') {
+      options.inputs.push_back(arg);
+    }
+    else {
+      printUsage(argv[0]);
+      return arg == "--help" ? 0 : -1;
+    }
+  }
+
+  std::vector<CorpusEntry> corpus;
+  if (options.inputs.empty()) {
+    generateCorpus(options.uiWidth, options.uiHeight, corpus);
+  }
+  else if (!loadCorpus(options.inputs, corpus)) {
+    return -1;
+  }
+  if (corpus.empty()) {
+    std::cerr << "Fehler: keine PNG-Dateien gefunden" << std::endl;
+    return -1;
+  }
+
+  std::ostringstream json;
+  json << "{" << std::endl;
+  json << "  \"iterations\": " << options.uiIterations << "," << std::endl;
+  json << "  \"files\": [";
+
+  bool failed = false;
+  double totalMs[2] = { 0.0, 0.0 };
+  double totalPixelBytes = 0.0, totalPngBytes = 0.0;
+  size_t measured = 0;
+  for (size_t f = 0; f < corpus.size(); f++) {
+    const CorpusEntry& entry = corpus[f];
+    std::vector<unsigned char> pixels[2];
+    unsigned int error[2];
+    double ms[2];
+    ms[0] = measure(entry, 0, options.uiIterations, pixels[0], error[0]);
+    ms[1] = measure(entry, 1, options.uiIterations, pixels[1], error[1]);
+
+    if (error[0] || error[1]) {
+      std::cerr << "Fehler: " << entry.name << " konnte nicht dekodiert werden: "
+                << lodepng_error_text(error[0] ? error[0] : error[1]) << std::endl;
+      failed = true;
+      continue;
+    }
+    if (pixels[0] != pixels[1]) {
+      std::cerr << "Fehler: " << entry.name << ": fast_inflate weicht vom bitweisen Dekoder ab" << std::endl;
+      failed = true;
+    }
+
+    // Durchsatz bezogen auf die dekodierten RGBA-Bytes
+    const double bytes = (double)pixels[0].size();
+    totalMs[0] += ms[0];
+    totalMs[1] += ms[1];
+    totalPixelBytes += bytes;
+    totalPngBytes += (double)entry.png.size();
+    json << (measured++ ? "," : "") << std::endl << "    { \"name\": " << getJsonString(entry.name)
+         << ", \"png_bytes\": " << entry.png.size() << ", \"pixel_bytes\": " << pixels[0].size()
+         << ", \"bitwise\": { \"ms\": " << ms[0] << ", \"mb_per_s\": " << bytes / (ms[0] * 1e3) << " }"
+         << ", \"table\": { \"ms\": " << ms[1] << ", \"mb_per_s\": " << bytes / (ms[1] * 1e3) << " }"
+         << ", \"speedup\": " << ms[0] / ms[1] << " }";
+  }
+  json << std::endl << "  ]," << std::endl;
+  json << "  \"total\": { \"png_bytes\": " << totalPngBytes << ", \"pixel_bytes\": " << totalPixelBytes
+       << ", \"bitwise_ms\": " << totalMs[0] << ", \"table_ms\": " << totalMs[1]
+       << ", \"bitwise_mb_per_s\": " << totalPixelBytes / (totalMs[0] * 1e3)
+       << ", \"table_mb_per_s\": " << totalPixelBytes / (totalMs[1] * 1e3)
+       << ", \"speedup\": " << totalMs[0] / totalMs[1] << " }" << std::endl;
+  json << "}" << std::endl;
+
+  std::cout << json.str();
+  if (!options.outFile.empty()) {
+    std::ofstream out(options.outFile, std::ios::trunc);
+    out << json.str();
+    if (!out) {
+      std::cerr << "Fehler: " << options.outFile << " konnte nicht geschrieben werden" << std::endl;
+    }
+  }
+
+  return failed ? -1 : 0;
+}
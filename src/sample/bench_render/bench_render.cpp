@@ -0,0 +1,348 @@
+// Render-Benchmark: baut dieselbe Szene wie GLSample mit einstellbarer Anzahl von Figuren
+// und Brettern, rendert headless eine feste Anzahl Frames ohne VSync und gibt FPS,
+// Frame-Zeit-Perzentile, Draw-Calls und hochgeladene Bytes als JSON aus. Mit --render-thread
+// werden die Frames auf dem Hauptthread aufgezeichnet und auf einem Render-Thread gezeichnet.
+// Mit --moves ziehen die Figuren aller Bretter ständig (Sprünge und Rückwürfe animiert).
+#include "glad/glad.h"
+#include "Scene.h"
+#include "HeadlessContext.h"
+#include "GLRender/Common.h"
+#include "GLRender/Framebuffer.h"
+#include "GLRender/GLDebug.h"
+#include "GLRender/GLExtensions.h"
+#include "GLRender/RenderThread.h"
+#include "GLRender/ShaderRegistry.h"
+#include "GLRender/TextureManager.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct BenchOptions
+{
+  SceneConfig scene;
+  unsigned int uiWidth = 800;
+  unsigned int uiHeight = 600;
+  unsigned int uiFrames = 500;   // gemessene Frames
+  unsigned int uiWarmup = 50;    // Frames vor der Messung (Shader, Caches, Treiber)
+  bool bAnimate = false;         // Bretter drehen, damit jeder Frame alle Instanzdaten hochlädt
+  bool bRenderThread = false;    // aufzeichnen und zeichnen auf getrennten Threads
+  bool bMoves = false;           // Figuren ziehen zufällig, alle Züge animiert
+  unsigned int uiPicks = 0;      // Strahlen für die Messung der Auswahl, 0 = keine
+  size_t textureBudget = 0;      // GPU-Speicher für Texturen in Bytes, 0 = unbegrenzt
+  std::string outFile;           // JSON zusätzlich in eine Datei schreiben
+};
+
+void printUsage(const char* pcName)
+{
+  std::cout << "usage: " << pcName << " [--pieces N] [--boards N] [--frames N] [--warmup N] [--size WxH] [--animate] [--orphan] [--render-thread] [--moves] [--pick N] [--texture-budget KB] [--out FILE]" << std::endl;
+  std::cout << "  --pieces N   number of pieces (default 16, e.g. 1000, 10000)" << std::endl;
+  std::cout << "  --boards N   number of boards (default 1)" << std::endl;
+  std::cout << "  --frames N   measured frames (default 500)" << std::endl;
+  std::cout << "  --warmup N   frames rendered before measuring (default 50)" << std::endl;
+  std::cout << "  --size WxH   framebuffer size (default 800x600)" << std::endl;
+  std::cout << "  --animate    rotate the boards every frame (uploads all instance data)" << std::endl;
+  std::cout << "  --orphan     stream with buffer orphaning even if persistent mapping is available" << std::endl;
+  std::cout << "  --render-thread  record on the main thread and replay on a render thread" << std::endl;
+  std::cout << "  --moves      let idle pieces on every board make random animated moves" << std::endl;
+  std::cout << "  --pick N     cast N picking rays through a grid over the viewport" << std::endl;
+  std::cout << "  --texture-budget KB  drop top mip levels of least recently used textures above this size" << std::endl;
+  std::cout << "  --out FILE   also write the JSON result to FILE" << std::endl;
+}
+
+// Perzentil (nearest rank) einer sortierten Liste
+double percentile(const std::vector<double>& sorted, double p)
+{
+  if (sorted.empty()) return 0.0;
+  size_t rank = (size_t)std::ceil(p * sorted.size());
+  return sorted[std::min(rank > 0 ? rank - 1 : 0, sorted.size() - 1)];
+}
+
+// JSON-Zahl; Perzentile ohne Messung (negativ) werden zu null
+std::string jsonNumber(double value)
+{
+  if (value < 0.0 || !std::isfinite(value)) return "null";
+  std::ostringstream strm;
+  strm << value;
+  return strm.str();
+}
+
+int main(int argc, char* argv[])
+{
+  BenchOptions options;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "--pieces" && i + 1 < argc) {
+      options.scene.numPieces = std::atoi(argv[++i]);
+    }
+    else if (arg == "--boards" && i + 1 < argc) {
+      options.scene.numBoards = std::max(1, std::atoi(argv[++i]));
+    }
+    else if (arg == "--frames" && i + 1 < argc) {
+      options.uiFrames = (unsigned int)std::strtoul(argv[++i], nullptr, 10);
+    }
+    else if (arg == "--warmup" && i + 1 < argc) {
+      options.uiWarmup = (unsigned int)std::strtoul(argv[++i], nullptr, 10);
+    }
+    else if (arg == "--size" && i + 1 < argc) {
+      if (std::sscanf(argv[++i], "%ux%u", &options.uiWidth, &options.uiHeight) != 2 || !options.uiWidth || !options.uiHeight) {
+        std::cerr << "Fehler: ungültige Größe " << argv[i] << std::endl;
+        return -1;
+      }
+    }
+    else if (arg == "--animate") {
+      options.bAnimate = true;
+    }
+    else if (arg == "--orphan") {
+      options.scene.persistentStreaming = false;
+    }
+    else if (arg == "--render-thread") {
+      options.bRenderThread = true;
+    }
+    else if (arg == "--moves") {
+      options.bMoves = true;
+    }
+    else if (arg == "--pick" && i + 1 < argc) {
+      options.uiPicks = (unsigned int)std::strtoul(argv[++i], nullptr, 10);
+    }
+    else if (arg == "--texture-budget" && i + 1 < argc) {
+      options.textureBudget = (size_t)std::strtoull(argv[++i], nullptr, 10) * 1024;
+    }
+    else if (arg == "--out" && i + 1 < argc) {
+      options.outFile = argv[++i];
+    }
+    else {
+      printUsage(argv[0]);
+      return arg == "--help" ? 0 : -1;
+    }
+  }
+  if (!options.uiFrames) {
+    std::cerr << "Fehler: mindestens ein Frame nötig" << std::endl;
+    return -1;
+  }
+
+  // Offscreen-Kontext, VSync spielt ohne Präsentation keine Rolle
+  HeadlessContext context;
+  if (!context.create(options.uiWidth, options.uiHeight)) {
+    std::cerr << "Fehler: Kein Offscreen-Kontext verfügbar (weder EGL noch verstecktes Fenster)!" << std::endl;
+    return -1;
+  }
+  gladLoadGLLoader(context.getProcAddress());
+  loadGLExtensions(context.getProcAddress());
+  GLDebug::init();
+  ShaderRegistry::get().setCacheDirectory("shadercache");
+
+  Framebuffer framebuffer;
+  if (framebuffer.create(options.uiWidth, options.uiHeight)) {
+    return -1;
+  }
+  framebuffer.bind();
+
+  TextureManager::get().setBudget(options.textureBudget);
+  Scene* scene = new Scene();
+  scene->init(options.uiWidth, options.uiHeight, options.scene);
+  scene->finishLoading();  // Texturen laden nicht in die Messung hinein
+  Profiler& profiler = scene->getProfiler();
+  profiler.setHistoryFrames(std::max(options.uiFrames, Profiler::DEFAULT_HISTORY_FRAMES));  // Perzentile über alle gemessenen Frames
+
+  // ein Simulationsschritt von 1/60 s pro Frame, ungebremst wie im Headless-Modus von GLSample
+  // (mit --animate dreht sich jedes Brett um 0,5 Grad pro Frame)
+  if (options.bAnimate) {
+    for (auto board : scene->getBoards())
+      board->setSpin(0.0f, 30.0f);
+  }
+  // mit --moves beginnt jede ruhende Figur mit Wahrscheinlichkeit 1/8 je Schritt einen Zug
+  // (einfacher LCG, damit jeder Lauf dieselben Züge macht)
+  unsigned int seed = 4711u;
+  auto random = [&seed](unsigned int range) {
+    seed = seed * 1664525u + 1013904223u;
+    return (seed >> 8) % range;
+  };
+  unsigned long long movesStarted = 0, activeAnimations = 0;
+  std::vector<double> simulateMs;
+  auto animate = [&]() {
+    const auto simulateStart = std::chrono::steady_clock::now();
+    if (options.bMoves) {
+      for (int piece = 0; piece < (int)scene->getNumPieces(); piece++) {
+        if (!scene->getAnimator().isAnimating(piece) && random(8) == 0 && scene->movePiece(piece, 1 + random(6)))
+          movesStarted++;
+      }
+    }
+    scene->update(1.0f / 60.0f);
+    scene->interpolate(1.0f);
+    simulateMs.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - simulateStart).count());
+    activeAnimations += scene->getAnimator().getNumActive();
+  };
+
+  // Ab hier gehört der Kontext dem Render-Thread; ohne Thread laufen submit und renderAsync sofort
+  RenderThread renderThread;
+  if (options.bRenderThread) {
+    context.releaseCurrent();
+    renderThread.start([&context]() { context.makeCurrent(); }, [&context]() { context.releaseCurrent(); });
+  }
+
+  // Statistik der Render-Queue, nur auf dem Render-Thread geschrieben
+  unsigned long long drawCalls = 0, stateChanges = 0;
+  auto countStats = [scene, &drawCalls, &stateChanges]() {
+    const RenderQueueStats& stats = scene->getStats();
+    drawCalls += stats.uiDrawCalls;
+    stateChanges += stats.uiStateChanges;
+  };
+
+  // Aufwärmen: erster Upload, Shader-Varianten im Treiber, Caches
+  for (unsigned int frame = 0; frame < options.uiWarmup; frame++) {
+    animate();
+    scene->renderAsync(renderThread, []() {});
+  }
+  renderThread.submit([&profiler]() {
+    glFinish();
+    profiler.flush();
+  });
+  renderThread.finish();
+  profiler.collect();
+  profiler.clearHistory();
+  simulateMs.clear();
+  movesStarted = activeAnimations = 0;
+
+  // Messung: Frame-Zeit = Abstand zweier Frame-Anfänge, so dass auch das Warten auf die
+  // GPU (volle Befehlswarteschlange) mitgezählt wird
+  std::vector<double> frameMs;
+  frameMs.reserve(options.uiFrames);
+  const size_t uploadedBefore = scene->getUploadedBytes();
+  const double waitBefore = renderThread.getWaitMs();
+
+  auto start = std::chrono::steady_clock::now();
+  auto last = start;
+  for (unsigned int frame = 0; frame < options.uiFrames; frame++) {
+    animate();
+    scene->renderAsync(renderThread, countStats);
+    profiler.collect();
+
+    // beim letzten Frame auf den Render-Thread und die GPU warten, damit die Gesamtzeit stimmt
+    if (frame + 1 == options.uiFrames) {
+      renderThread.submit([]() { glFinish(); });
+      renderThread.finish();
+    }
+    auto now = std::chrono::steady_clock::now();
+    frameMs.push_back(std::chrono::duration<double, std::milli>(now - last).count());
+    last = now;
+  }
+  const double seconds = std::chrono::duration<double>(last - start).count();
+  const size_t uploaded = scene->getUploadedBytes() - uploadedBefore;
+  const double waitMs = renderThread.getWaitMs() - waitBefore;
+  std::sort(simulateMs.begin(), simulateMs.end());
+  const double simulateP50 = percentile(simulateMs, 0.50), simulateP99 = percentile(simulateMs, 0.99);
+  const double activePerFrame = (double)activeAnimations / options.uiFrames;
+  const unsigned long long measuredMoves = movesStarted;
+
+  // der Kontext geht für die Auswertung und das Aufräumen an den Hauptthread zurück
+  if (renderThread.isRunning()) {
+    renderThread.stop();
+    context.makeCurrent();
+  }
+
+  // Auswahl: Strahlen über ein Raster des Viewports; mit --animate dreht sich die Szene
+  // zwischen den Strahlen weiter, gemessen wird dann auch das Anpassen des Baums
+  double pickBuildMs = 0.0, pickUs = 0.0;
+  unsigned int pickHits = 0;
+  if (options.uiPicks) {
+    auto pickStart = std::chrono::steady_clock::now();
+    scene->pick(0.5f * options.uiWidth, 0.5f * options.uiHeight);  // baut den Baum auf
+    pickBuildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - pickStart).count();
+
+    const unsigned int columns = (unsigned int)std::ceil(std::sqrt((double)options.uiPicks));
+    double totalUs = 0.0;
+    for (unsigned int i = 0; i < options.uiPicks; i++) {
+      if (options.bAnimate) animate();
+      const float x = ((i % columns) + 0.5f) * options.uiWidth / columns;
+      const float y = ((i / columns) + 0.5f) * options.uiHeight / columns;
+      pickStart = std::chrono::steady_clock::now();
+      if (scene->pick(x, y).type != PickResult::NONE) pickHits++;
+      totalUs += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - pickStart).count();
+    }
+    pickUs = totalUs / options.uiPicks;
+  }
+
+  profiler.flush();
+  profiler.collect();
+  std::vector<ProfileSummary> passes;
+  profiler.getSummary(passes);
+
+  std::sort(frameMs.begin(), frameMs.end());
+
+  // Ergebnis als JSON
+  std::ostringstream json;
+  json << "{" << std::endl;
+  json << "  \"renderer\": " << getJsonString((const char*)glGetString(GL_RENDERER)) << "," << std::endl;
+  json << "  \"context\": \"" << context.getBackendName() << "\"," << std::endl;
+  json << "  \"width\": " << options.uiWidth << ", \"height\": " << options.uiHeight << "," << std::endl;
+  json << "  \"boards\": " << scene->getBoards().size() << ", \"pieces\": " << scene->getNumPieces() << "," << std::endl;
+  json << "  \"animate\": " << (options.bAnimate ? "true" : "false") << "," << std::endl;
+  json << "  \"render_thread\": " << (options.bRenderThread ? "true" : "false")
+       << ", \"render_thread_wait_ms\": " << waitMs << "," << std::endl;
+  json << "  \"moves\": " << (options.bMoves ? "true" : "false") << ", \"moves_started\": " << measuredMoves
+       << ", \"active_animations_per_frame\": " << activePerFrame << "," << std::endl;
+  json << "  \"simulate_ms\": { \"p50\": " << simulateP50 << ", \"p99\": " << simulateP99 << " }," << std::endl;
+  json << "  \"frames\": " << options.uiFrames << ", \"warmup\": " << options.uiWarmup << "," << std::endl;
+  json << "  \"seconds\": " << seconds << "," << std::endl;
+  json << "  \"fps\": " << (seconds > 0.0 ? options.uiFrames / seconds : 0.0) << "," << std::endl;
+  json << "  \"frame_ms\": { \"p50\": " << percentile(frameMs, 0.50) << ", \"p95\": " << percentile(frameMs, 0.95)
+       << ", \"p99\": " << percentile(frameMs, 0.99) << ", \"max\": " << frameMs.back() << " }," << std::endl;
+  json << "  \"draw_calls_per_frame\": " << (double)drawCalls / options.uiFrames << "," << std::endl;
+  json << "  \"state_changes_per_frame\": " << (double)stateChanges / options.uiFrames << "," << std::endl;
+  json << "  \"recorded_commands_per_frame\": " << scene->getNumRecordedCommands()
+       << ", \"recorded_bytes_per_frame\": " << scene->getRecordedBytes() << "," << std::endl;
+  json << "  \"uploaded_bytes\": " << uploaded << "," << std::endl;
+  json << "  \"uploaded_bytes_per_frame\": " << (double)uploaded / options.uiFrames << "," << std::endl;
+  const StreamBuffer& stream = scene->getStreamBuffer();
+  json << "  \"stream_buffer\": { \"mode\": \"" << (stream.isPersistent() ? "persistent" : "orphan")
+       << "\", \"waits\": " << stream.getNumWaits() << ", \"orphans\": " << stream.getNumOrphans()
+       << ", \"grows\": " << stream.getNumGrows() << " }," << std::endl;
+  json << "  \"pieces_per_lod\": [";
+  for (int i = 0; i < PieceRenderer::NUM_LODS; i++) {
+    json << (i ? ", " : "") << scene->getPieceRenderer()->getNumInstances(i);
+  }
+  json << "]," << std::endl;
+  const TextureManager& textures = TextureManager::get();
+  json << "  \"textures\": { \"count\": " << textures.getNumTextures() << ", \"gpu_bytes\": " << textures.getGPUBytes()
+       << ", \"budget\": " << textures.getBudget() << ", \"dropped_levels\": " << textures.getNumDroppedLevels() << " }," << std::endl;
+  json << "  \"culled_pieces\": " << scene->getPieceRenderer()->getNumCulled()
+       << ", \"culled_boards\": " << scene->getNumCulledBoards() << "," << std::endl;
+  if (options.uiPicks) {
+    const BVH& bvh = scene->getPicker().getBVH();
+    json << "  \"pick\": { \"rays\": " << options.uiPicks << ", \"hits\": " << pickHits << ", \"build_ms\": " << pickBuildMs
+         << ", \"us_per_pick\": " << pickUs << ", \"primitives\": " << bvh.getNumPrimitives()
+         << ", \"bvh_nodes\": " << bvh.getNumNodes() << ", \"bvh_depth\": " << bvh.getDepth() << " }," << std::endl;
+  }
+  json << "  \"passes\": {";
+  for (size_t i = 0; i < passes.size(); i++) {
+    const ProfileSummary& pass = passes[i];
+    json << (i ? "," : "") << std::endl << "    " << getJsonString(pass.cName) << ": { \"cpu_ms\": ["
+         << jsonNumber(pass.adCpuMs[0]) << ", " << jsonNumber(pass.adCpuMs[1]) << ", " << jsonNumber(pass.adCpuMs[2])
+         << "], \"gpu_ms\": [" << jsonNumber(pass.adGpuMs[0]) << ", " << jsonNumber(pass.adGpuMs[1]) << ", "
+         << jsonNumber(pass.adGpuMs[2]) << "] }";
+  }
+  json << std::endl << "  }" << std::endl << "}" << std::endl;
+
+  std::cout << json.str();
+  if (!options.outFile.empty()) {
+    std::ofstream out(options.outFile, std::ios::trunc);
+    out << json.str();
+    if (!out) {
+      std::cerr << "Fehler: " << options.outFile << " konnte nicht geschrieben werden" << std::endl;
+    }
+  }
+
+  delete scene;
+  framebuffer.destroy();
+  context.destroy();
+
+  return 0;
+}